@@ -0,0 +1,115 @@
+/* In-process throughput benchmark for mdvic_render_stream.
+ *
+ * Usage: mdvic-bench [--size BYTES] [--iters N] [--write DIR] [CORPUS|FILE...]
+ *
+ * Each corpus (all of them by default, see corpus.h) is generated once,
+ * rendered once to warm up, then rendered N times to /dev/null with fixed
+ * options: colour at 256 colours, OSC 8 links, highlighting, lint, and
+ * wrapping at 80 columns. The report gives the median run as MB/s and
+ * ns/byte, and the heap allocations per run as counted by allocstats.c.
+ * --write DIR also saves the corpora as DIR/NAME.md for profiling the mdvic
+ * binary. An argument with a '/' is a file, such as a fuzz seed, repeated
+ * to the size instead.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mdvic/mdvic.h"
+#include "mdvic/stats.h"
+#include "corpus.h"
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int render_once(const char *data, size_t len, FILE *sink, const struct MdvicOptions *opt) {
+    FILE *in = fmemopen((void *)data, len, "r");
+    if (!in) return -1;
+    int rc = mdvic_render_stream(in, sink, opt, "bench.md");
+    fclose(in);
+    fflush(sink);
+    return rc;
+}
+
+/* "4M", "512k" or plain bytes. */
+static size_t parse_size(const char *s) {
+    char *end = NULL;
+    unsigned long v = strtoul(s, &end, 10);
+    if (end && (*end == 'k' || *end == 'K')) v *= 1024ul;
+    else if (end && (*end == 'm' || *end == 'M')) v *= 1024ul * 1024ul;
+    return (size_t)v;
+}
+
+static int bench_one(const char *name, size_t size, int iters, const char *dir, FILE *sink, const struct MdvicOptions *opt) {
+    size_t len = 0;
+    int is_file = strchr(name, '/') != NULL;
+    char *data = is_file ? bench_corpus_file(name, size, &len) : bench_corpus(name, size, &len);
+    if (!data) { fprintf(stderr, is_file ? "mdvic-bench: cannot read '%s'\n" : "mdvic-bench: unknown corpus '%s'\n", name); return 1; }
+    if (is_file) name = strrchr(name, '/') + 1;
+    if (dir && !is_file) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s.md", dir, name);
+        FILE *f = fopen(path, "wb");
+        if (!f || fwrite(data, 1, len, f) != len) fprintf(stderr, "mdvic-bench: cannot write %s\n", path);
+        if (f) fclose(f);
+    }
+    double *t = (double *)malloc((size_t)iters * sizeof(double));
+    if (!t || render_once(data, len, sink, opt) != 0) { free(t); free(data); fprintf(stderr, "mdvic-bench: %s: render failed\n", name); return 1; }
+    unsigned long long a0, b0, a1, b1;
+    int have_allocs = mdvic_alloc_stats(&a0, &b0);
+    for (int i = 0; i < iters; i++) {
+        unsigned long long t0 = mdvic_stats_now();
+        render_once(data, len, sink, opt);
+        t[i] = (double)(mdvic_stats_now() - t0);
+    }
+    mdvic_alloc_stats(&a1, &b1);
+    qsort(t, (size_t)iters, sizeof(double), cmp_double);
+    double med = t[iters / 2];
+    printf("%-18s %10zu %9.2f %9.2f", name, len, (double)len / med * 1e3, med / (double)len);
+    if (have_allocs) printf(" %12llu %12llu\n", (a1 - a0) / (unsigned)iters, (b1 - b0) / (unsigned)iters / 1024u);
+    else printf(" %12s %12s\n", "-", "-");
+    fflush(stdout);
+    free(t); free(data);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    size_t size = 1024u * 1024u;
+    int iters = 5;
+    const char *dir = NULL;
+    int first = argc;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) size = parse_size(argv[++i]);
+        else if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) iters = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--write") == 0 && i + 1 < argc) dir = argv[++i];
+        else if (argv[i][0] == '-') { fprintf(stderr, "usage: mdvic-bench [--size BYTES] [--iters N] [--write DIR] [CORPUS|FILE...]\n"); return 2; }
+        else { first = i; break; }
+    }
+    if (iters < 1) iters = 1;
+
+    /* Fixed settings, whatever the environment says */
+    setenv("MDVIC_COLORS", "256", 1);
+    struct MdvicOptions opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.width = 80; opt.math_mode = MDVIC_MATH_UNICODE;
+    opt.enable_lint = true; opt.enable_wrap = true; opt.enable_osc8 = true; opt.enable_highlight = true;
+    opt.math_limits.max_depth = MDVIC_MATH_DEFAULT_DEPTH;
+    opt.math_limits.max_tokens = MDVIC_MATH_DEFAULT_TOKENS;
+    opt.math_limits.max_bytes = MDVIC_MATH_DEFAULT_BYTES;
+
+    FILE *sink = fopen("/dev/null", "w");
+    if (!sink) { perror("mdvic-bench: /dev/null"); return 1; }
+    printf("%-18s %10s %9s %9s %12s %12s\n", "corpus", "bytes", "MB/s", "ns/byte", "allocs/run", "KiB/run");
+    int rc = 0;
+    if (first < argc) {
+        for (int i = first; i < argc; i++) rc |= bench_one(argv[i], size, iters, dir, sink, &opt);
+    } else {
+        for (const char *const *n = bench_corpus_names; *n; n++) rc |= bench_one(*n, size, iters, dir, sink, &opt);
+    }
+    fclose(sink);
+    return rc;
+}
@@ -0,0 +1,293 @@
+/* Deterministic synthetic Markdown for benchmarks.
+ *
+ * Each corpus stresses one part of the renderer. Text comes from a fixed
+ * word list and a xorshift generator with a fixed seed, so a given size
+ * always yields the same document.
+ */
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "corpus.h"
+
+const char *const bench_corpus_names[] = {
+    "prose", "cjk", "tables", "math", "nesting", "code", NULL
+};
+
+struct Gen {
+    char *p; size_t n, cap;
+    int oom;
+    uint32_t rng;
+};
+
+static uint32_t rnd(struct Gen *g) {
+    uint32_t x = g->rng;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return g->rng = x;
+}
+
+/* Uniform-ish in [0, n). */
+static unsigned pick(struct Gen *g, unsigned n) { return rnd(g) % n; }
+
+static void put(struct Gen *g, const char *s, size_t len) {
+    if (g->oom) return;
+    if (g->n + len + 1 > g->cap) {
+        size_t ncap = g->cap ? g->cap : 4096;
+        while (g->n + len + 1 > ncap) ncap *= 2;
+        char *np = (char *)realloc(g->p, ncap);
+        if (!np) { g->oom = 1; return; }
+        g->p = np; g->cap = ncap;
+    }
+    memcpy(g->p + g->n, s, len);
+    g->n += len;
+    g->p[g->n] = '\0';
+}
+
+static void puts_(struct Gen *g, const char *s) { put(g, s, strlen(s)); }
+
+static void putf(struct Gen *g, const char *fmt, ...) {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n > 0) put(g, buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+static void put_cp(struct Gen *g, uint32_t cp) {
+    char b[4]; size_t n;
+    if (cp < 0x80) { b[0] = (char)cp; n = 1; }
+    else if (cp < 0x800) { b[0] = (char)(0xC0 | (cp >> 6)); b[1] = (char)(0x80 | (cp & 0x3F)); n = 2; }
+    else if (cp < 0x10000) { b[0] = (char)(0xE0 | (cp >> 12)); b[1] = (char)(0x80 | ((cp >> 6) & 0x3F)); b[2] = (char)(0x80 | (cp & 0x3F)); n = 3; }
+    else { b[0] = (char)(0xF0 | (cp >> 18)); b[1] = (char)(0x80 | ((cp >> 12) & 0x3F)); b[2] = (char)(0x80 | ((cp >> 6) & 0x3F)); b[3] = (char)(0x80 | (cp & 0x3F)); n = 4; }
+    put(g, b, n);
+}
+
+static const char *const words[] = {
+    "the", "of", "and", "a", "to", "in", "is", "that", "for", "it", "as", "with",
+    "renderer", "terminal", "width", "column", "paragraph", "document", "buffer",
+    "layout", "glyph", "escape", "sequence", "wrapping", "table", "formula",
+    "parser", "stream", "output", "cursor", "latency", "throughput", "memory",
+    "allocation", "benchmark", "unicode", "markdown", "heading", "emphasis",
+    "between", "through", "without", "because", "although", "whenever",
+    "quickly", "carefully", "usually", "rarely", "internationalization",
+    "characterization", "implementation", "configuration", "x", "y", "n",
+    NULL
+};
+#define NWORDS (sizeof(words) / sizeof(words[0]) - 1)
+
+static const char *word(struct Gen *g) { return words[pick(g, NWORDS)]; }
+
+/* A sentence-ish run of n words with occasional inline markup. */
+static void inline_text(struct Gen *g, int n, int line_words) {
+    for (int i = 0; i < n; i++) {
+        if (i) puts_(g, (line_words && i % line_words == 0) ? "\n" : " ");
+        unsigned r = pick(g, 40);
+        const char *w = word(g);
+        if (r == 0) putf(g, "*%s*", w);
+        else if (r == 1) putf(g, "**%s %s**", w, word(g));
+        else if (r == 2) putf(g, "`%s_%u()`", w, pick(g, 100));
+        else if (r == 3) putf(g, "[%s](https://example.com/%s/%u)", w, word(g), pick(g, 1000));
+        else if (r == 4) putf(g, "%s,", w);
+        else puts_(g, w);
+    }
+}
+
+/* ---- corpora ---- */
+
+static void gen_prose(struct Gen *g, unsigned block) {
+    if (block % 12 == 0) { putf(g, "## %s %s %u\n\n", word(g), word(g), block / 12 + 1); return; }
+    switch (pick(g, 5)) {
+    case 0: {
+        int items = 3 + (int)pick(g, 4);
+        for (int i = 0; i < items; i++) { puts_(g, "- "); inline_text(g, 5 + (int)pick(g, 12), 0); puts_(g, "\n"); }
+        break;
+    }
+    case 1: {
+        int items = 3 + (int)pick(g, 4);
+        for (int i = 0; i < items; i++) { putf(g, "%d. ", i + 1); inline_text(g, 5 + (int)pick(g, 12), 0); puts_(g, "\n"); }
+        break;
+    }
+    default:
+        inline_text(g, 40 + (int)pick(g, 80), 12);
+        puts_(g, "\n");
+        break;
+    }
+    puts_(g, "\n");
+}
+
+/* Ideographs, kana and Hangul (all wide), with some ASCII, combining marks
+ * and emoji mixed in. */
+static void cjk_run(struct Gen *g, int n) {
+    for (int i = 0; i < n; i++) {
+        unsigned r = pick(g, 100);
+        if (r < 50) put_cp(g, 0x4E00 + pick(g, 0x5000));
+        else if (r < 65) put_cp(g, 0x3041 + pick(g, 0x56));
+        else if (r < 75) put_cp(g, 0x30A1 + pick(g, 0x56));
+        else if (r < 88) put_cp(g, 0xAC00 + pick(g, 0x2BA4));
+        else if (r < 92) puts_(g, r & 1 ? "、" : "。");
+        else if (r < 96) { puts_(g, " "); puts_(g, word(g)); puts_(g, " "); }
+        else if (r < 98) puts_(g, "e\xCC\x81");
+        else put_cp(g, 0x1F600 + pick(g, 0x40));
+    }
+}
+
+static void gen_cjk(struct Gen *g, unsigned block) {
+    if (block % 10 == 0) { puts_(g, "## "); cjk_run(g, 6 + (int)pick(g, 6)); puts_(g, "\n\n"); return; }
+    int lines = 3 + (int)pick(g, 6);
+    for (int l = 0; l < lines; l++) {
+        if (pick(g, 6) == 0) puts_(g, "**");
+        cjk_run(g, 20 + (int)pick(g, 30));
+        if (pick(g, 6) == 0) puts_(g, "**");
+        puts_(g, "\n");
+    }
+    puts_(g, "\n");
+}
+
+static void table_cell(struct Gen *g) {
+    switch (pick(g, 6)) {
+    case 0: putf(g, "%u.%02u", pick(g, 100000), pick(g, 100)); break;
+    case 1: putf(g, "`%s`", word(g)); break;
+    case 2: cjk_run(g, 1 + (int)pick(g, 4)); break;
+    default: inline_text(g, 1 + (int)pick(g, 4), 0); break;
+    }
+}
+
+static void gen_tables(struct Gen *g, unsigned block) {
+    int cols = 6 + (int)pick(g, 5), rows = 500 + (int)pick(g, 1500);
+    static const char *const align[] = { "----", ":---", "---:", ":---:" };
+    putf(g, "### Table %u\n\n|", block + 1);
+    for (int c = 0; c < cols; c++) putf(g, " %s %d |", word(g), c);
+    puts_(g, "\n|");
+    for (int c = 0; c < cols; c++) putf(g, "%s|", align[pick(g, 4)]);
+    puts_(g, "\n");
+    for (int r = 0; r < rows; r++) {
+        puts_(g, "|");
+        for (int c = 0; c < cols; c++) { puts_(g, " "); table_cell(g); puts_(g, " |"); }
+        puts_(g, "\n");
+    }
+    puts_(g, "\n");
+}
+
+static const char *const greek[] = {
+    "alpha", "beta", "gamma", "delta", "theta", "lambda", "mu", "pi", "sigma", "phi", "omega", "Omega", "Delta"
+};
+#define NGREEK (sizeof(greek) / sizeof(greek[0]))
+
+static void formula(struct Gen *g) {
+    const char *a = greek[pick(g, NGREEK)], *b = greek[pick(g, NGREEK)];
+    switch (pick(g, 8)) {
+    case 0: putf(g, "\\%s_{i} + \\%s^{2}", a, b); break;
+    case 1: putf(g, "\\frac{\\%s}{%u + x}", a, pick(g, 10)); break;
+    case 2: putf(g, "\\sqrt{x^2 + \\%s^2}", a); break;
+    case 3: putf(g, "\\sum_{i=1}^{n} x_i \\cdot \\%s_i", a); break;
+    case 4: putf(g, "f : \\mathbb{R}^n \\to \\mathbb{R}"); break;
+    case 5: putf(g, "\\left( \\%s + \\%s \\right)^{%u}", a, b, pick(g, 9) + 2); break;
+    case 6: putf(g, "\\hat{x} \\leq \\vec{v} \\times \\%s", a); break;
+    default: putf(g, "\\lim_{n \\to \\infty} \\%s_n = \\%s", a, b); break;
+    }
+}
+
+static void gen_math(struct Gen *g, unsigned block) {
+    unsigned r = pick(g, 6);
+    if (r == 0) {
+        puts_(g, "$$\n\\begin{pmatrix} ");
+        for (int i = 0; i < 3; i++) { if (i) puts_(g, " \\\\ "); putf(g, "\\%s & %u & x_%d", greek[pick(g, NGREEK)], pick(g, 100), i); }
+        puts_(g, " \\end{pmatrix}\n$$\n\n");
+    } else if (r == 1) {
+        puts_(g, "$$"); formula(g); puts_(g, " = \\frac{1}{n} \\sum_{k=0}^{n} "); formula(g); puts_(g, "$$\n\n");
+    } else {
+        int n = 3 + (int)pick(g, 5);
+        for (int i = 0; i < n; i++) {
+            inline_text(g, 4 + (int)pick(g, 10), 0);
+            puts_(g, " $"); formula(g); puts_(g, "$");
+            puts_(g, i % 2 ? "\n" : " ");
+        }
+        puts_(g, "\n\n");
+    }
+}
+
+/* Lists inside quotes inside lists, a dozen levels deep. */
+static void gen_nesting(struct Gen *g, unsigned block) {
+    int depth = 6 + (int)pick(g, 10);
+    char prefix[256]; size_t pn = 0;
+    for (int d = 0; d < depth && pn + 4 < sizeof(prefix); d++) {
+        put(g, prefix, pn);
+        if (d % 3 == 2) {
+            puts_(g, "> "); inline_text(g, 6 + (int)pick(g, 10), 0); puts_(g, "\n");
+            put(g, prefix, pn); puts_(g, ">\n");
+            memcpy(prefix + pn, "> ", 2); pn += 2;
+        } else {
+            puts_(g, d % 2 ? "1. " : "- "); inline_text(g, 4 + (int)pick(g, 10), 0); puts_(g, "\n");
+            memcpy(prefix + pn, "   ", 3); pn += 3;
+        }
+    }
+    putf(g, "\nBlock %u.\n\n", block);
+}
+
+static const char *const c_lines[] = {
+    "static int %s_%u(const char *s, size_t n) {",
+    "    for (size_t i = 0; i < n; i++) if (s[i] == '\\n') return (int)i; /* %s %u */",
+    "    const char *msg = \"%s: value %u out of range\";",
+    "#define %s_MAX %u",
+    "    return %s + %u;",
+    "}",
+};
+static const char *const py_lines[] = {
+    "def %s_%u(items):",
+    "    for item in items:  # %s %u",
+    "        yield item.%s(%u)",
+    "    return \"%s\" * %u",
+    "class %s%u(object):",
+    "    pass",
+};
+
+static void gen_code(struct Gen *g, unsigned block) {
+    int lang = (int)pick(g, 3);
+    int lines = 50 + (int)pick(g, 350);
+    puts_(g, lang == 0 ? "```c\n" : lang == 1 ? "```python\n" : "```\n");
+    for (int l = 0; l < lines; l++) {
+        const char *const *tbl = lang == 1 ? py_lines : c_lines;
+        putf(g, tbl[pick(g, 6)], word(g), pick(g, 1000));
+        if (pick(g, 20) == 0) { puts_(g, " //"); inline_text(g, 30, 0); }
+        puts_(g, "\n");
+    }
+    puts_(g, "```\n\n");
+    inline_text(g, 10 + (int)pick(g, 20), 0);
+    puts_(g, "\n\n");
+}
+
+char *bench_corpus(const char *name, size_t size, size_t *len) {
+    static void (*const gens[])(struct Gen *, unsigned) = {
+        gen_prose, gen_cjk, gen_tables, gen_math, gen_nesting, gen_code
+    };
+    int k = 0;
+    while (bench_corpus_names[k] && strcmp(bench_corpus_names[k], name) != 0) k++;
+    if (!bench_corpus_names[k]) return NULL;
+    struct Gen g;
+    memset(&g, 0, sizeof(g));
+    g.rng = 0x9E3779B9u ^ (uint32_t)(k + 1);
+    for (unsigned block = 0; g.n < size && !g.oom; block++) gens[k](&g, block);
+    if (g.oom || !g.p) { free(g.p); return NULL; }
+    if (len) *len = g.n;
+    return g.p;
+}
+
+char *bench_corpus_file(const char *path, size_t size, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    struct Gen seed, g;
+    memset(&seed, 0, sizeof(seed));
+    memset(&g, 0, sizeof(g));
+    char buf[4096]; size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) put(&seed, buf, n);
+    fclose(f);
+    if (seed.oom || seed.n == 0) { free(seed.p); return NULL; }
+    while (g.n < size && !g.oom) put(&g, seed.p, seed.n);
+    free(seed.p);
+    if (g.oom || !g.p) { free(g.p); return NULL; }
+    if (len) *len = g.n;
+    return g.p;
+}
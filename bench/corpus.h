@@ -0,0 +1,24 @@
+/* Deterministic synthetic Markdown for benchmarks. */
+#ifndef MDVIC_BENCH_CORPUS_H
+#define MDVIC_BENCH_CORPUS_H
+
+#include <stddef.h>
+
+/* NULL-terminated list of corpus names: prose, cjk, tables, math, nesting,
+ * code. */
+extern const char *const bench_corpus_names[];
+
+/* Generate about size bytes of the named corpus (whole blocks, so slightly
+ * more) into a malloc'ed, NUL-terminated buffer. The same name and size give
+ * the same bytes on every machine. Returns NULL for an unknown name or when
+ * out of memory.
+ */
+char *bench_corpus(const char *name, size_t size, size_t *len);
+
+/* The file at path repeated to at least size bytes (whole copies), for
+ * turning fuzz seeds into benchmarks. NULL if it cannot be read or is
+ * empty.
+ */
+char *bench_corpus_file(const char *path, size_t size, size_t *len);
+
+#endif /* MDVIC_BENCH_CORPUS_H */
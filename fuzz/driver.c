@@ -0,0 +1,83 @@
+/* main() for builds without libFuzzer: AFL (run the binary with @@) and
+ * replaying files, e.g. a crash or a seed directory.
+ *
+ * Usage: mdvic-fuzz-TARGET [--scale] [FILE...]
+ *
+ * Without files the input is read from standard input. --scale reports the
+ * growth of time and allocations for each file repeated to two sizes (see
+ * fuzz_scale) and exits 1 if any grows faster than allowed.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fuzz.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static uint8_t *slurp(FILE *f, size_t *len) {
+    size_t cap = 4096, n = 0;
+    uint8_t *p = (uint8_t *)malloc(cap);
+    if (!p) return NULL;
+    for (;;) {
+        if (n == cap) {
+            uint8_t *np = (uint8_t *)realloc(p, cap * 2);
+            if (!np) { free(p); return NULL; }
+            p = np; cap *= 2;
+        }
+        size_t got = fread(p + n, 1, cap - n, f);
+        n += got;
+        if (got == 0) break;
+    }
+    if (ferror(f)) { free(p); return NULL; }
+    *len = n;
+    return p;
+}
+
+static void print_exp(double e) {
+    if (e < 0) printf(" %7s", "-");
+    else printf(" %7.2f", e);
+}
+
+/* One line per file: sizes compared and the exponent of each measure. */
+static int scale_file(const char *path, const uint8_t *data, size_t len) {
+    struct FuzzScale s;
+    int rc = fuzz_scale(data, len, &s);
+    printf("%-40s", path);
+    if (rc < 0) { printf(" (empty or out of memory)\n"); return 0; }
+    if (s.large == 0) { printf(" (too large to scale)\n"); return 0; }
+    printf(" %8zu %8zu", s.small, s.large);
+    print_exp(s.time_exp); print_exp(s.alloc_exp); print_exp(s.byte_exp);
+    printf("%s\n", rc ? "  SUPERLINEAR" : "");
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    int scale = 0, first = 1;
+    if (argc > 1 && strcmp(argv[1], "--scale") == 0) { scale = 1; first = 2; }
+    else if (argc > 1 && argv[1][0] == '-' && argv[1][1] != '\0') {
+        fprintf(stderr, "usage: %s [--scale] [FILE...]\n", argv[0]);
+        return 2;
+    }
+    /* --scale reports instead of aborting like the per-input check */
+    if (scale) {
+        fuzz_scale_enabled = 0;
+        printf("%-40s %8s %8s %7s %7s %7s\n", fuzz_target.name, "small", "large", "time", "allocs", "bytes");
+    }
+    int rc = 0;
+    for (int i = first; i < argc || (i == first && i == argc); i++) {
+        const char *path = i < argc ? argv[i] : "-";
+        FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+        if (!f) { perror(path); rc = 2; continue; }
+        size_t len = 0;
+        uint8_t *data = slurp(f, &len);
+        if (f != stdin) fclose(f);
+        if (!data) { fprintf(stderr, "%s: cannot read\n", path); rc = 2; continue; }
+        if (scale) { if (scale_file(path, data, len)) rc = rc ? rc : 1; }
+        else LLVMFuzzerTestOneInput(data, len);
+        free(data);
+    }
+    return rc;
+}
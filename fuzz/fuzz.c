@@ -0,0 +1,102 @@
+/* libFuzzer entry point and the scaling check shared by every target. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mdvic/stats.h"
+#include "fuzz.h"
+
+/* Sizes below this finish too fast to compare; the smaller run is at least
+ * this many bytes when scale_max allows. */
+#define SCALE_MIN_BYTES 8192u
+/* Ratio between the two sizes. */
+#define SCALE_FACTOR 16u
+/* Time is compared only when the larger run takes this long. */
+#define SCALE_MIN_NS 2000000ull
+#define SCALE_TIME_RUNS 5
+
+int fuzz_scale_enabled = -1;
+
+struct Cost { unsigned long long ns, allocs, bytes; int have_allocs; };
+
+/* CPU time rather than wall time: a throttled or busy machine stretches
+ * long runs more than short ones, which reads as superlinear growth. */
+static unsigned long long cpu_now(void) {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) return mdvic_stats_now();
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+/* Fastest of a few runs, and the allocations of one (they do not vary). */
+static void measure(const char *data, size_t len, struct Cost *c) {
+    unsigned long long a0, b0, a1, b1;
+    c->have_allocs = mdvic_alloc_stats(&a0, &b0);
+    c->ns = 0;
+    for (int r = 0; r < SCALE_TIME_RUNS; r++) {
+        unsigned long long t0 = cpu_now();
+        fuzz_target.run(data, len);
+        unsigned long long dt = cpu_now() - t0;
+        if (r == 0) mdvic_alloc_stats(&a1, &b1);
+        if (r == 0 || dt < c->ns) c->ns = dt;
+    }
+    c->allocs = a1 - a0; c->bytes = b1 - b0;
+}
+
+/* Nothing at the small size means a fixed cost, not a trend. */
+static double growth(double small, double large, double factor) {
+    if (small <= 0.0 || large <= 0.0) return 0.0;
+    return log(large / small) / log(factor);
+}
+
+static double max_exponent(void) {
+    const char *v = getenv("MDVIC_FUZZ_SCALE_MAX");
+    double e = v ? atof(v) : 0.0;
+    return e > 1.0 ? e : FUZZ_SCALE_MAX_EXP;
+}
+
+int fuzz_scale(const uint8_t *data, size_t size, struct FuzzScale *s) {
+    memset(s, 0, sizeof(*s));
+    s->time_exp = s->alloc_exp = s->byte_exp = -1.0;
+    if (size == 0) return -1;
+    size_t k1 = size < SCALE_MIN_BYTES ? (SCALE_MIN_BYTES + size - 1) / size : 1, k2 = k1 * SCALE_FACTOR;
+    if (k2 > fuzz_target.scale_max / size) {
+        k2 = fuzz_target.scale_max / size;
+        k1 = k2 / SCALE_FACTOR ? k2 / SCALE_FACTOR : 1;
+    }
+    if (k2 < 2 * k1) return 0; /* too large to grow within scale_max */
+    char *buf = (char *)malloc(k2 * size);
+    if (!buf) return -1;
+    for (size_t k = 0; k < k2; k++) memcpy(buf + k * size, data, size);
+    s->small = k1 * size; s->large = k2 * size;
+
+    struct Cost c1, c2;
+    fuzz_target.run(buf, s->small); /* warm up lazily built tables */
+    measure(buf, s->small, &c1);
+    measure(buf, s->large, &c2);
+    free(buf);
+
+    double factor = (double)k2 / (double)k1, lim = max_exponent();
+    if (c2.ns >= SCALE_MIN_NS) s->time_exp = growth((double)c1.ns, (double)c2.ns, factor);
+    if (c1.have_allocs) {
+        s->alloc_exp = growth((double)c1.allocs, (double)c2.allocs, factor);
+        s->byte_exp = growth((double)c1.bytes, (double)c2.bytes, factor);
+    }
+    return s->time_exp > lim || s->alloc_exp > lim || s->byte_exp > lim;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    fuzz_target.run((const char *)data, size);
+    if (fuzz_scale_enabled < 0) fuzz_scale_enabled = getenv("MDVIC_FUZZ_SCALE") != NULL;
+    struct FuzzScale s;
+    if (fuzz_scale_enabled && fuzz_scale(data, size, &s) == 1) {
+        /* A crash makes the engine keep the input as a reproducer */
+        fprintf(stderr, "mdvic-fuzz-%s: superlinear from %zu to %zu bytes: time ^%.2f, allocations ^%.2f, bytes ^%.2f\n",
+                fuzz_target.name, s.small, s.large, s.time_exp, s.alloc_exp, s.byte_exp);
+        abort();
+    }
+    return 0;
+}
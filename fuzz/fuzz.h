@@ -0,0 +1,45 @@
+/* Fuzz targets for libFuzzer, AFL and plain replay.
+ *
+ * Each target file defines fuzz_target; fuzz.c turns it into
+ * LLVMFuzzerTestOneInput, and driver.c supplies main() when no fuzzing
+ * engine does. Inputs are the bytes the function under test sees, with no
+ * option header, so any seed can also be rendered or benchmarked as is.
+ */
+#ifndef MDVIC_FUZZ_H
+#define MDVIC_FUZZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct FuzzTarget {
+    const char *name;
+    void (*run)(const char *data, size_t len);
+    /* Largest input the scaling check builds; keep it under any limit that
+     * would cut the work short (math stops at MDVIC_MATH_DEFAULT_BYTES). */
+    size_t scale_max;
+};
+
+extern const struct FuzzTarget fuzz_target;
+
+/* Growth of one measure between an input repeated k and 16k times, as the
+ * exponent e in cost ~ size^e: about 1 for linear work, 2 for quadratic. */
+struct FuzzScale {
+    size_t small, large;     /* bytes run at each size */
+    double time_exp;         /* < 0 when too fast to measure */
+    double alloc_exp;        /* < 0 without allocation counts */
+    double byte_exp;
+};
+
+/* Exponents above this are flagged; MDVIC_FUZZ_SCALE_MAX overrides it. */
+#define FUZZ_SCALE_MAX_EXP 1.5
+
+/* Run the target on data repeated to two sizes and fill *s. Returns 1 if
+ * time or allocations grew faster than the allowed exponent, 0 if not, -1
+ * if data is empty or memory ran out. */
+int fuzz_scale(const uint8_t *data, size_t size, struct FuzzScale *s);
+
+/* The scaling check as run for each input: on when MDVIC_FUZZ_SCALE is set
+ * in the environment or by the driver's --scale. */
+extern int fuzz_scale_enabled;
+
+#endif /* MDVIC_FUZZ_H */
@@ -0,0 +1,22 @@
+/* mdvic_lint_buffer, as while viewing, and mdvic_lint_document, as
+ * --lint-only runs it. */
+#include <stdio.h>
+
+#include "mdvic/lint.h"
+#include "fuzz.h"
+
+static FILE *sink;
+
+static void count(void *ctx, const struct MdvicDiag *d) {
+    (void)d;
+    (*(unsigned long *)ctx)++;
+}
+
+static void run(const char *data, size_t len) {
+    if (!sink && !(sink = fopen("/dev/null", "w"))) return;
+    unsigned long n = 0;
+    (void)mdvic_lint_buffer(data, len, sink, "fuzz.md");
+    (void)mdvic_lint_document(data, len, "fuzz.md", count, &n);
+}
+
+const struct FuzzTarget fuzz_target = { "lint", run, 1u << 20 };
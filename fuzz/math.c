@@ -0,0 +1,23 @@
+/* mdvic_math_render on raw TeX, as inline Unicode and display ASCII. */
+#include <stdlib.h>
+#include <string.h>
+
+#include "mdvic/math.h"
+#include "fuzz.h"
+
+static void run(const char *data, size_t len) {
+    struct MdvicOptions opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.math_limits.max_depth = MDVIC_MATH_DEFAULT_DEPTH;
+    opt.math_limits.max_tokens = MDVIC_MATH_DEFAULT_TOKENS;
+    opt.math_limits.max_bytes = MDVIC_MATH_DEFAULT_BYTES;
+    for (int pass = 0; pass < 2; pass++) {
+        opt.math_mode = pass ? MDVIC_MATH_ASCII : MDVIC_MATH_UNICODE;
+        opt.accent_group = pass;
+        char *out = NULL; size_t n = 0;
+        if (mdvic_math_render(data, len, &opt, pass, &out, &n) == 0) free(out);
+    }
+}
+
+/* Beyond the token and byte limits the renderer gives up early */
+const struct FuzzTarget fuzz_target = { "math", run, 64u * 1024u };
@@ -0,0 +1,29 @@
+/* mdvic_render_stream with the bench settings, minus lint: its findings go
+ * to stderr, and the lint target covers it. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mdvic/mdvic.h"
+#include "fuzz.h"
+
+static FILE *sink;
+
+static void run(const char *data, size_t len) {
+    if (len == 0) return; /* fmemopen may refuse an empty buffer */
+    if (!sink && !(sink = fopen("/dev/null", "w"))) return;
+    struct MdvicOptions opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.width = 80; opt.math_mode = MDVIC_MATH_UNICODE;
+    opt.enable_wrap = true; opt.enable_osc8 = true; opt.enable_highlight = true;
+    opt.math_limits.max_depth = MDVIC_MATH_DEFAULT_DEPTH;
+    opt.math_limits.max_tokens = MDVIC_MATH_DEFAULT_TOKENS;
+    opt.math_limits.max_bytes = MDVIC_MATH_DEFAULT_BYTES;
+    FILE *in = fmemopen((void *)data, len, "r");
+    if (!in) return;
+    (void)mdvic_render_stream(in, sink, &opt, "fuzz.md");
+    fclose(in);
+}
+
+const struct FuzzTarget fuzz_target = { "render", run, 1u << 20 };
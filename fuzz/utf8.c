@@ -0,0 +1,58 @@
+/* mdvic_utf8_normalize on a copy of the input, and on the input transcoded
+ * from each other encoding; aborts unless the result is valid UTF-8 without
+ * CR or NUL, or if transcoding in two chunks differs from one. */
+#include <stdlib.h>
+#include <string.h>
+
+#include "mdvic/utf8.h"
+#include "fuzz.h"
+
+/* Independent of src/utf8.c: the ranges of Unicode table 3-7. */
+static int valid(const unsigned char *s, size_t len) {
+    for (size_t i = 0; i < len;) {
+        unsigned c = s[i], lo = 0x80, hi = 0xBF;
+        size_t need;
+        if (c == '\r' || c == 0) return 0;
+        if (c < 0x80) { i++; continue; }
+        if (c >= 0xC2 && c <= 0xDF) need = 1;
+        else if (c >= 0xE0 && c <= 0xEF) { need = 2; lo = c == 0xE0 ? 0xA0 : 0x80; hi = c == 0xED ? 0x9F : 0xBF; }
+        else if (c >= 0xF0 && c <= 0xF4) { need = 3; lo = c == 0xF0 ? 0x90 : 0x80; hi = c == 0xF4 ? 0x8F : 0xBF; }
+        else return 0;
+        if (len - i <= need || s[i + 1] < lo || s[i + 1] > hi) return 0;
+        for (size_t k = 2; k <= need; k++) if ((s[i + k] & 0xC0) != 0x80) return 0;
+        i += need + 1;
+    }
+    return 1;
+}
+
+/* Normalise len bytes of buf (cap bytes large) and check the result; frees
+ * buf. */
+static void check(char *buf, size_t len, size_t cap) {
+    if (mdvic_utf8_normalize(&buf, &len, &cap) == 0 && !valid((const unsigned char *)buf, len)) abort();
+    free(buf);
+}
+
+static void run(const char *data, size_t len) {
+    static const enum mdvic_input_encoding encs[] = { MDVIC_INPUT_LATIN1, MDVIC_INPUT_UTF16LE, MDVIC_INPUT_UTF16BE };
+    size_t cap = MDVIC_TRANSCODE_BOUND(len);
+    char *buf = (char *)malloc(cap);
+    if (!buf) return;
+    memcpy(buf, data, len);
+    check(buf, len, cap);
+    for (size_t k = 0; k < sizeof(encs) / sizeof(encs[0]); k++) {
+        char *whole = (char *)malloc(cap), *split = (char *)malloc(2 * cap);
+        if (!whole || !split) { free(whole); free(split); return; }
+        size_t used, n = mdvic_transcode(encs[k], data, len, 1, whole, &used);
+        if (used != len) abort();
+        /* split at an odd byte, with what the first call leaves carried over */
+        size_t half = len / 2 | 1;
+        if (half > len) half = len;
+        size_t m = mdvic_transcode(encs[k], data, half, 0, split, &used);
+        m += mdvic_transcode(encs[k], data + used, len - used, 1, split + m, &used);
+        if (m != n || memcmp(whole, split, n) != 0) abort();
+        free(split);
+        check(whole, n, cap);
+    }
+}
+
+const struct FuzzTarget fuzz_target = { "utf8", run, 1u << 22 };
@@ -0,0 +1,18 @@
+/* mdvic_wrap_write_pref2 at a narrow, an odd and a usual width. */
+#include <stdio.h>
+
+#include "mdvic/wrap.h"
+#include "fuzz.h"
+
+static FILE *sink;
+
+static void run(const char *data, size_t len) {
+    static const int widths[] = { 1, 7, 80 };
+    if (!sink && !(sink = fopen("/dev/null", "w"))) return;
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+        int col = 0;
+        (void)mdvic_wrap_write_pref2(sink, data, len, widths[i], &col, "> - ", 4, ">   ", 4);
+    }
+}
+
+const struct FuzzTarget fuzz_target = { "wrap", run, 1u << 20 };
@@ -0,0 +1,67 @@
+#ifndef MDVIC_GRID_H
+#define MDVIC_GRID_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mdvic/theme.h"
+
+/*
+ * Cell-grid output for embedding: a document laid out into rows of exactly
+ * `width` cells, each holding one character with its style and link, so a
+ * TUI can draw it without parsing escape sequences. The grid is filled by
+ * the same layout pass as the ANSI writer (mdvic_layout_grid in mdvic.h).
+ * Lines longer than the grid (code, tables, no-wrap text) are clipped.
+ */
+
+struct MdvicCell {
+    uint32_t cp;          /* code point; ' ' when blank, 0 on the right half of a wide character */
+    uint32_t tail;        /* combining marks after cp: 1 + offset of a NUL-terminated
+                           * UTF-8 string in MdvicGrid.tails, or 0 */
+    unsigned char width;  /* columns taken: 1, 2, or 0 on the right half of a wide character */
+    unsigned char attrs;  /* MDVIC_ATTR_* */
+    struct MdvicColor fg, bg; /* MDVIC_COLOR_NONE for the terminal default */
+    uint16_t link;        /* 1 + index into MdvicGrid.links, or 0 */
+};
+
+struct MdvicGrid {
+    int width;
+    size_t rows;
+    struct MdvicCell *cells; /* rows * width, row by row */
+    char *tails; size_t tails_len;
+    char **links; size_t nlinks;
+    /* layout state */
+    size_t row_cap, tails_cap, links_cap;
+    int col;
+    struct MdvicCell pen;    /* style and link of the next character */
+};
+
+/* Used by the layout: an empty grid, and the calls that feed it. */
+struct MdvicGrid *mdvic_grid_new(int width);
+void mdvic_grid_set_style(struct MdvicGrid *g, unsigned attrs, const struct MdvicColor *fg, const struct MdvicColor *bg);
+void mdvic_grid_set_link(struct MdvicGrid *g, const char *url); /* NULL ends the link */
+void mdvic_grid_put(struct MdvicGrid *g, const char *s, size_t len);
+void mdvic_grid_finish(struct MdvicGrid *g);
+
+void mdvic_grid_free(struct MdvicGrid *g);
+
+/* Compact binary form, all integers little-endian:
+ *
+ *   "MDVG" u8 version=1, u16 width, u32 rows
+ *   u32 nlinks, then per link: u32 length, URL bytes
+ *   u32 nstyles, then per style: u8 attrs, fg and bg as u8 kind,r,g,b
+ *   per row: u16 nruns, then per run: u16 style, u16 link, u16 ncells,
+ *            then per cell: u32 cp | width << 21 | has-tail << 23,
+ *            and with a tail: u8 length, UTF-8 bytes
+ *
+ * Runs cover a row up to its last non-blank or styled cell; the rest of the
+ * row is blank. Returns 0 on success.
+ */
+int mdvic_grid_write_binary(const struct MdvicGrid *g, FILE *out);
+
+/* Readable dump for tests and debugging: each row's text, a line under it
+ * marking styled cells with a letter, and the letters' styles and links. */
+int mdvic_grid_write_text(const struct MdvicGrid *g, FILE *out);
+
+#endif /* MDVIC_GRID_H */
@@ -0,0 +1,46 @@
+#ifndef MDVIC_HIGHLIGHT_H
+#define MDVIC_HIGHLIGHT_H
+
+#include <stddef.h>
+
+/*
+ * Syntax highlighting for fenced code blocks. Each language is a descriptor
+ * (comment and string syntax) plus a perfect-hash keyword table generated by
+ * tools/gen_hl_keywords.sh. A line is lexed in one left-to-right pass with no
+ * allocation; the only state carried between lines is whether a block
+ * comment or multi-line string is still open.
+ */
+
+enum mdvic_hl_kind {
+    MDVIC_HL_PLAIN,
+    MDVIC_HL_KEYWORD,
+    MDVIC_HL_TYPE,    /* types, builtins, shell variables, JSON/YAML keys */
+    MDVIC_HL_LITERAL, /* true, false, null, None, ... */
+    MDVIC_HL_STRING,
+    MDVIC_HL_NUMBER,
+    MDVIC_HL_COMMENT,
+    MDVIC_HL_PREPROC, /* C directives, Python decorators */
+    MDVIC_HL_KIND_COUNT
+};
+
+struct MdvicHlLang;
+
+/* Carried from one line of a block to the next; zero-initialise per block. */
+struct MdvicHlState {
+    unsigned char mode;  /* inside a comment or string */
+    unsigned char quote; /* closing quote of an open string */
+};
+
+/* Receives maximal runs of one kind; the runs cover the line exactly. */
+typedef void (*mdvic_hl_emit_fn)(void *ctx, int kind, const char *s, size_t len);
+
+/* Language named by the first word of a fence info string ("c", "py",
+ * "bash", "json", "yml", ...), or NULL if it is not supported.
+ */
+const struct MdvicHlLang *mdvic_hl_find(const char *info);
+
+/* Lex one line (without its newline) and pass its runs to emit. */
+void mdvic_hl_line(const struct MdvicHlLang *lang, struct MdvicHlState *st,
+                   const char *s, size_t len, mdvic_hl_emit_fn emit, void *ctx);
+
+#endif /* MDVIC_HIGHLIGHT_H */
@@ -0,0 +1,412 @@
+/* Auto-generated by tools/gen_hl_keywords.sh. Do not edit by hand. */
+#ifndef MDVIC_HL_KEYWORDS_H
+#define MDVIC_HL_KEYWORDS_H
+
+/* slots[hash % size] is 1 + the index of the only word that can match. */
+
+static const struct MdvicHlWord mdvic_hl_c_words[81] = {
+    {"auto", 4, MDVIC_HL_KEYWORD},
+    {"break", 5, MDVIC_HL_KEYWORD},
+    {"case", 4, MDVIC_HL_KEYWORD},
+    {"const", 5, MDVIC_HL_KEYWORD},
+    {"continue", 8, MDVIC_HL_KEYWORD},
+    {"default", 7, MDVIC_HL_KEYWORD},
+    {"do", 2, MDVIC_HL_KEYWORD},
+    {"else", 4, MDVIC_HL_KEYWORD},
+    {"enum", 4, MDVIC_HL_KEYWORD},
+    {"extern", 6, MDVIC_HL_KEYWORD},
+    {"for", 3, MDVIC_HL_KEYWORD},
+    {"goto", 4, MDVIC_HL_KEYWORD},
+    {"if", 2, MDVIC_HL_KEYWORD},
+    {"inline", 6, MDVIC_HL_KEYWORD},
+    {"register", 8, MDVIC_HL_KEYWORD},
+    {"restrict", 8, MDVIC_HL_KEYWORD},
+    {"return", 6, MDVIC_HL_KEYWORD},
+    {"sizeof", 6, MDVIC_HL_KEYWORD},
+    {"static", 6, MDVIC_HL_KEYWORD},
+    {"struct", 6, MDVIC_HL_KEYWORD},
+    {"switch", 6, MDVIC_HL_KEYWORD},
+    {"typedef", 7, MDVIC_HL_KEYWORD},
+    {"union", 5, MDVIC_HL_KEYWORD},
+    {"volatile", 8, MDVIC_HL_KEYWORD},
+    {"while", 5, MDVIC_HL_KEYWORD},
+    {"_Alignas", 8, MDVIC_HL_KEYWORD},
+    {"_Alignof", 8, MDVIC_HL_KEYWORD},
+    {"_Atomic", 7, MDVIC_HL_KEYWORD},
+    {"_Generic", 8, MDVIC_HL_KEYWORD},
+    {"_Noreturn", 9, MDVIC_HL_KEYWORD},
+    {"_Static_assert", 14, MDVIC_HL_KEYWORD},
+    {"_Thread_local", 13, MDVIC_HL_KEYWORD},
+    {"alignas", 7, MDVIC_HL_KEYWORD},
+    {"alignof", 7, MDVIC_HL_KEYWORD},
+    {"class", 5, MDVIC_HL_KEYWORD},
+    {"constexpr", 9, MDVIC_HL_KEYWORD},
+    {"delete", 6, MDVIC_HL_KEYWORD},
+    {"namespace", 9, MDVIC_HL_KEYWORD},
+    {"new", 3, MDVIC_HL_KEYWORD},
+    {"noexcept", 8, MDVIC_HL_KEYWORD},
+    {"operator", 8, MDVIC_HL_KEYWORD},
+    {"private", 7, MDVIC_HL_KEYWORD},
+    {"protected", 9, MDVIC_HL_KEYWORD},
+    {"public", 6, MDVIC_HL_KEYWORD},
+    {"template", 8, MDVIC_HL_KEYWORD},
+    {"this", 4, MDVIC_HL_KEYWORD},
+    {"throw", 5, MDVIC_HL_KEYWORD},
+    {"try", 3, MDVIC_HL_KEYWORD},
+    {"catch", 5, MDVIC_HL_KEYWORD},
+    {"typename", 8, MDVIC_HL_KEYWORD},
+    {"using", 5, MDVIC_HL_KEYWORD},
+    {"virtual", 7, MDVIC_HL_KEYWORD},
+    {"bool", 4, MDVIC_HL_TYPE},
+    {"char", 4, MDVIC_HL_TYPE},
+    {"double", 6, MDVIC_HL_TYPE},
+    {"float", 5, MDVIC_HL_TYPE},
+    {"int", 3, MDVIC_HL_TYPE},
+    {"long", 4, MDVIC_HL_TYPE},
+    {"short", 5, MDVIC_HL_TYPE},
+    {"signed", 6, MDVIC_HL_TYPE},
+    {"unsigned", 8, MDVIC_HL_TYPE},
+    {"void", 4, MDVIC_HL_TYPE},
+    {"_Bool", 5, MDVIC_HL_TYPE},
+    {"size_t", 6, MDVIC_HL_TYPE},
+    {"ssize_t", 7, MDVIC_HL_TYPE},
+    {"ptrdiff_t", 9, MDVIC_HL_TYPE},
+    {"intptr_t", 8, MDVIC_HL_TYPE},
+    {"uintptr_t", 9, MDVIC_HL_TYPE},
+    {"int8_t", 6, MDVIC_HL_TYPE},
+    {"int16_t", 7, MDVIC_HL_TYPE},
+    {"int32_t", 7, MDVIC_HL_TYPE},
+    {"int64_t", 7, MDVIC_HL_TYPE},
+    {"uint8_t", 7, MDVIC_HL_TYPE},
+    {"uint16_t", 8, MDVIC_HL_TYPE},
+    {"uint32_t", 8, MDVIC_HL_TYPE},
+    {"uint64_t", 8, MDVIC_HL_TYPE},
+    {"FILE", 4, MDVIC_HL_TYPE},
+    {"true", 4, MDVIC_HL_LITERAL},
+    {"false", 5, MDVIC_HL_LITERAL},
+    {"NULL", 4, MDVIC_HL_LITERAL},
+    {"nullptr", 7, MDVIC_HL_LITERAL},
+};
+
+static const unsigned char mdvic_hl_c_slots[1024] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 72, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    25, 0, 0, 0, 0, 41, 0, 0, 0, 0, 71, 0, 0, 0, 0, 38,
+    28, 0, 0, 0, 0, 23, 0, 0, 43, 0, 0, 76, 0, 0, 0, 81,
+    0, 77, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 53, 55, 0, 29, 0, 0, 0, 0,
+    0, 0, 75, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 40, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 11, 0, 32, 0, 0, 0, 39, 0, 70, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 35, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 20, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 74, 0, 0, 0, 0, 0, 0, 4, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 64, 0, 0, 49,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 33, 0, 0, 0,
+    52, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 17, 0,
+    60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 65, 0, 0, 0, 13,
+    0, 0, 0, 0, 0, 0, 0, 42, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 34, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 24, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 0, 61, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 57, 0, 0, 0,
+    0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 47, 0, 0, 0, 0,
+    79, 0, 0, 22, 0, 0, 0, 0, 0, 0, 0, 0, 62, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 59, 78, 0, 0, 45, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0, 0, 0, 18, 0,
+    0, 0, 0, 19, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 26, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 27, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 46, 0, 3, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 69, 0, 0, 30, 0, 0, 0, 0, 67, 37,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    66, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 68, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 44, 0,
+    63, 0, 0, 0, 0, 0, 0, 0, 14, 0, 0, 50, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 16, 0, 0, 0, 0, 48, 0, 0, 0, 0, 0, 0, 0, 6,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 31, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 15, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 56, 2, 0, 0, 0, 0, 0, 0, 54, 0,
+    0, 0, 0, 0, 0, 51, 0, 0, 0, 0, 0, 0, 0, 0, 0, 58,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 36, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 80,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const struct MdvicHlKeywords mdvic_hl_c_keywords = {
+    mdvic_hl_c_words, mdvic_hl_c_slots, 1024, 79u, 2, 14
+};
+
+static const struct MdvicHlWord mdvic_hl_sh_words[45] = {
+    {"if", 2, MDVIC_HL_KEYWORD},
+    {"then", 4, MDVIC_HL_KEYWORD},
+    {"else", 4, MDVIC_HL_KEYWORD},
+    {"elif", 4, MDVIC_HL_KEYWORD},
+    {"fi", 2, MDVIC_HL_KEYWORD},
+    {"for", 3, MDVIC_HL_KEYWORD},
+    {"while", 5, MDVIC_HL_KEYWORD},
+    {"until", 5, MDVIC_HL_KEYWORD},
+    {"do", 2, MDVIC_HL_KEYWORD},
+    {"done", 4, MDVIC_HL_KEYWORD},
+    {"case", 4, MDVIC_HL_KEYWORD},
+    {"esac", 4, MDVIC_HL_KEYWORD},
+    {"in", 2, MDVIC_HL_KEYWORD},
+    {"function", 8, MDVIC_HL_KEYWORD},
+    {"select", 6, MDVIC_HL_KEYWORD},
+    {"time", 4, MDVIC_HL_KEYWORD},
+    {"return", 6, MDVIC_HL_KEYWORD},
+    {"local", 5, MDVIC_HL_KEYWORD},
+    {"export", 6, MDVIC_HL_KEYWORD},
+    {"readonly", 8, MDVIC_HL_KEYWORD},
+    {"declare", 7, MDVIC_HL_KEYWORD},
+    {"break", 5, MDVIC_HL_KEYWORD},
+    {"continue", 8, MDVIC_HL_KEYWORD},
+    {"exit", 4, MDVIC_HL_KEYWORD},
+    {"echo", 4, MDVIC_HL_TYPE},
+    {"printf", 6, MDVIC_HL_TYPE},
+    {"cd", 2, MDVIC_HL_TYPE},
+    {"pwd", 3, MDVIC_HL_TYPE},
+    {"set", 3, MDVIC_HL_TYPE},
+    {"unset", 5, MDVIC_HL_TYPE},
+    {"shift", 5, MDVIC_HL_TYPE},
+    {"source", 6, MDVIC_HL_TYPE},
+    {"eval", 4, MDVIC_HL_TYPE},
+    {"exec", 4, MDVIC_HL_TYPE},
+    {"trap", 4, MDVIC_HL_TYPE},
+    {"test", 4, MDVIC_HL_TYPE},
+    {"read", 4, MDVIC_HL_TYPE},
+    {"alias", 5, MDVIC_HL_TYPE},
+    {"command", 7, MDVIC_HL_TYPE},
+    {"type", 4, MDVIC_HL_TYPE},
+    {"wait", 4, MDVIC_HL_TYPE},
+    {"kill", 4, MDVIC_HL_TYPE},
+    {"getopts", 7, MDVIC_HL_TYPE},
+    {"ulimit", 6, MDVIC_HL_TYPE},
+    {"umask", 5, MDVIC_HL_TYPE},
+};
+
+static const unsigned char mdvic_hl_sh_slots[512] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 36, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 44, 30, 0, 0, 0, 20,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 31, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0,
+    0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    24, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 8, 0, 0, 0, 0, 19, 0, 0, 0, 0, 0, 0, 7,
+    0, 0, 21, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    23, 0, 0, 0, 27, 0, 0, 0, 0, 0, 0, 38, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 14, 0, 0, 0, 15, 0, 0, 0, 0, 0, 0,
+    0, 0, 10, 0, 0, 42, 0, 41, 0, 0, 0, 0, 0, 0, 0, 9,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 17, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 26, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0,
+    0, 0, 18, 0, 0, 0, 0, 0, 0, 0, 16, 0, 0, 0, 0, 0,
+    0, 29, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12,
+    0, 0, 0, 0, 0, 0, 0, 0, 33, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 39, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 28, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 11, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 13, 0,
+    0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 40, 0, 0, 0, 0, 0,
+    0, 0, 0, 43, 0, 0, 0, 0, 0, 0, 37, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 35, 0, 0, 0, 0, 0, 0, 0, 0, 0, 34,
+    0, 0, 45, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    22, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const struct MdvicHlKeywords mdvic_hl_sh_keywords = {
+    mdvic_hl_sh_words, mdvic_hl_sh_slots, 512, 32u, 2, 8
+};
+
+static const struct MdvicHlWord mdvic_hl_python_words[57] = {
+    {"and", 3, MDVIC_HL_KEYWORD},
+    {"as", 2, MDVIC_HL_KEYWORD},
+    {"assert", 6, MDVIC_HL_KEYWORD},
+    {"async", 5, MDVIC_HL_KEYWORD},
+    {"await", 5, MDVIC_HL_KEYWORD},
+    {"break", 5, MDVIC_HL_KEYWORD},
+    {"class", 5, MDVIC_HL_KEYWORD},
+    {"continue", 8, MDVIC_HL_KEYWORD},
+    {"def", 3, MDVIC_HL_KEYWORD},
+    {"del", 3, MDVIC_HL_KEYWORD},
+    {"elif", 4, MDVIC_HL_KEYWORD},
+    {"else", 4, MDVIC_HL_KEYWORD},
+    {"except", 6, MDVIC_HL_KEYWORD},
+    {"finally", 7, MDVIC_HL_KEYWORD},
+    {"for", 3, MDVIC_HL_KEYWORD},
+    {"from", 4, MDVIC_HL_KEYWORD},
+    {"global", 6, MDVIC_HL_KEYWORD},
+    {"if", 2, MDVIC_HL_KEYWORD},
+    {"import", 6, MDVIC_HL_KEYWORD},
+    {"in", 2, MDVIC_HL_KEYWORD},
+    {"is", 2, MDVIC_HL_KEYWORD},
+    {"lambda", 6, MDVIC_HL_KEYWORD},
+    {"nonlocal", 8, MDVIC_HL_KEYWORD},
+    {"not", 3, MDVIC_HL_KEYWORD},
+    {"or", 2, MDVIC_HL_KEYWORD},
+    {"pass", 4, MDVIC_HL_KEYWORD},
+    {"raise", 5, MDVIC_HL_KEYWORD},
+    {"return", 6, MDVIC_HL_KEYWORD},
+    {"try", 3, MDVIC_HL_KEYWORD},
+    {"while", 5, MDVIC_HL_KEYWORD},
+    {"with", 4, MDVIC_HL_KEYWORD},
+    {"yield", 5, MDVIC_HL_KEYWORD},
+    {"match", 5, MDVIC_HL_KEYWORD},
+    {"bool", 4, MDVIC_HL_TYPE},
+    {"bytes", 5, MDVIC_HL_TYPE},
+    {"dict", 4, MDVIC_HL_TYPE},
+    {"float", 5, MDVIC_HL_TYPE},
+    {"int", 3, MDVIC_HL_TYPE},
+    {"list", 4, MDVIC_HL_TYPE},
+    {"object", 6, MDVIC_HL_TYPE},
+    {"set", 3, MDVIC_HL_TYPE},
+    {"str", 3, MDVIC_HL_TYPE},
+    {"tuple", 5, MDVIC_HL_TYPE},
+    {"type", 4, MDVIC_HL_TYPE},
+    {"print", 5, MDVIC_HL_TYPE},
+    {"len", 3, MDVIC_HL_TYPE},
+    {"range", 5, MDVIC_HL_TYPE},
+    {"super", 5, MDVIC_HL_TYPE},
+    {"self", 4, MDVIC_HL_TYPE},
+    {"cls", 3, MDVIC_HL_TYPE},
+    {"isinstance", 10, MDVIC_HL_TYPE},
+    {"enumerate", 9, MDVIC_HL_TYPE},
+    {"zip", 3, MDVIC_HL_TYPE},
+    {"open", 4, MDVIC_HL_TYPE},
+    {"True", 4, MDVIC_HL_LITERAL},
+    {"False", 5, MDVIC_HL_LITERAL},
+    {"None", 4, MDVIC_HL_LITERAL},
+};
+
+static const unsigned char mdvic_hl_python_slots[512] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 44, 0, 0, 0, 0, 40, 2, 0, 0, 0, 1,
+    0, 0, 0, 0, 39, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 38,
+    0, 0, 48, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 13, 0, 0, 0, 50, 26,
+    0, 0, 0, 0, 0, 0, 34, 49, 0, 0, 0, 0, 12, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0,
+    47, 0, 0, 0, 0, 0, 0, 35, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 22, 8, 0, 0, 0, 0, 0, 0, 28, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    51, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 45, 0, 0, 0, 0, 0, 0, 0, 0, 11, 0, 0,
+    0, 0, 0, 52, 0, 31, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    19, 0, 0, 0, 0, 0, 0, 0, 0, 37, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 57, 0, 0, 0, 0, 0,
+    27, 0, 0, 0, 0, 0, 0, 56, 14, 0, 0, 0, 36, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 41, 0, 0, 0, 0, 55, 0, 18, 0,
+    0, 0, 0, 0, 0, 0, 20, 0, 0, 0, 0, 21, 0, 0, 0, 0,
+    0, 0, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 7, 0, 10,
+    0, 46, 0, 0, 0, 0, 43, 0, 0, 0, 0, 0, 0, 32, 17, 0,
+    0, 0, 0, 0, 29, 15, 0, 24, 0, 0, 0, 0, 0, 42, 0, 0,
+    0, 0, 0, 53, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 23, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 54, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 0,
+    0, 0, 5, 0, 0, 0, 33, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const struct MdvicHlKeywords mdvic_hl_python_keywords = {
+    mdvic_hl_python_words, mdvic_hl_python_slots, 512, 40u, 2, 10
+};
+
+static const struct MdvicHlWord mdvic_hl_json_words[3] = {
+    {"true", 4, MDVIC_HL_LITERAL},
+    {"false", 5, MDVIC_HL_LITERAL},
+    {"null", 4, MDVIC_HL_LITERAL},
+};
+
+static const unsigned char mdvic_hl_json_slots[64] = {
+    0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const struct MdvicHlKeywords mdvic_hl_json_keywords = {
+    mdvic_hl_json_words, mdvic_hl_json_slots, 64, 31u, 4, 5
+};
+
+static const struct MdvicHlWord mdvic_hl_yaml_words[21] = {
+    {"true", 4, MDVIC_HL_LITERAL},
+    {"false", 5, MDVIC_HL_LITERAL},
+    {"null", 4, MDVIC_HL_LITERAL},
+    {"yes", 3, MDVIC_HL_LITERAL},
+    {"no", 2, MDVIC_HL_LITERAL},
+    {"on", 2, MDVIC_HL_LITERAL},
+    {"off", 3, MDVIC_HL_LITERAL},
+    {"True", 4, MDVIC_HL_LITERAL},
+    {"False", 5, MDVIC_HL_LITERAL},
+    {"Null", 4, MDVIC_HL_LITERAL},
+    {"Yes", 3, MDVIC_HL_LITERAL},
+    {"No", 2, MDVIC_HL_LITERAL},
+    {"On", 2, MDVIC_HL_LITERAL},
+    {"Off", 3, MDVIC_HL_LITERAL},
+    {"TRUE", 4, MDVIC_HL_LITERAL},
+    {"FALSE", 5, MDVIC_HL_LITERAL},
+    {"NULL", 4, MDVIC_HL_LITERAL},
+    {"YES", 3, MDVIC_HL_LITERAL},
+    {"NO", 2, MDVIC_HL_LITERAL},
+    {"ON", 2, MDVIC_HL_LITERAL},
+    {"OFF", 3, MDVIC_HL_LITERAL},
+};
+
+static const unsigned char mdvic_hl_yaml_slots[256] = {
+    0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, 0, 0,
+    18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0, 10, 0,
+    0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 16, 0, 0, 0, 17,
+    0, 9, 0, 0, 0, 0, 0, 19, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 12, 0, 0, 0, 20, 0, 0, 14, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 13, 0, 0, 7, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 21, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    11, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+    4, 0, 0, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0,
+};
+
+static const struct MdvicHlKeywords mdvic_hl_yaml_keywords = {
+    mdvic_hl_yaml_words, mdvic_hl_yaml_slots, 256, 37u, 2, 5
+};
+
+#endif /* MDVIC_HL_KEYWORDS_H */
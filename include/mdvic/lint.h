@@ -0,0 +1,83 @@
+#ifndef MDVIC_LINT_H
+#define MDVIC_LINT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "mdvic/utf8.h"
+
+/* One finding. rule is a static, stable id (e.g. "unclosed-fence"); line
+ * and col are 1-based, col counting code points. file and message are only
+ * valid during the callback. */
+struct MdvicDiag {
+    const char *file;
+    int line, col;
+    const char *rule;
+    const char *message;
+};
+
+typedef void (*mdvic_diag_fn)(void *ctx, const struct MdvicDiag *d);
+
+/* Scan a Markdown buffer for common authoring mistakes (unclosed code fences,
+ * unmatched inline backticks) and pass each one to fn in source order.
+ * Returns the number of issues found.
+ */
+int mdvic_lint_scan(const char *data, size_t len, const char *filename, mdvic_diag_fn fn, void *ctx);
+
+/* mdvic_lint_scan reporting to err as "file:line: message". */
+int mdvic_lint_buffer(const char *data, size_t len, FILE *err, const char *filename);
+
+/* The classic stderr form of d, used when rendering. */
+void mdvic_diag_print(FILE *err, const struct MdvicDiag *d);
+
+/* Findings kept for later, e.g. when they come from another thread. */
+struct MdvicDiagItem { int line, col; const char *rule; char *message; };
+struct MdvicDiagList { struct MdvicDiagItem *v; size_t n, cap; };
+
+/* An mdvic_diag_fn appending to the struct MdvicDiagList ctx. */
+void mdvic_diag_collect(void *list, const struct MdvicDiag *d);
+/* Print l in the classic form, as findings of file. */
+void mdvic_diag_list_print(FILE *err, const struct MdvicDiagList *l, const char *file);
+void mdvic_diag_list_free(struct MdvicDiagList *l);
+
+/* Everything lint can find in a document, without rendering: what the
+ * renderer reports (mdvic_lint_scan plus the table checks "table-separator"
+ * and "table-columns"), then the checks too costly to run while viewing:
+ * mdvic_lint_math, and relative links and images whose file does not exist
+ * ("missing-link-target", resolved against filename's directory).
+ * Returns the number of issues found.
+ */
+int mdvic_lint_document(const char *data, size_t len, const char *filename, mdvic_diag_fn fn, void *ctx);
+
+struct MdvicMathSpans;
+
+/* Math findings: $$ runs left unpaired, and a lone $ right before a command
+ * ("math-delimiter"); then mdvic_math_check on each span of spans (from
+ * mdvic_math_extract on data; may be NULL). Returns the number found.
+ */
+int mdvic_lint_math(const char *data, size_t len, const struct MdvicMathSpans *spans, const char *filename, mdvic_diag_fn fn, void *ctx);
+
+/* Whether url is a relative link whose file is missing. Absolute paths,
+ * fragments and URLs with a scheme are never missing; the query and fragment
+ * are dropped and %XX decoded before resolving against filename ("-" and
+ * NULL resolve against the working directory).
+ */
+int mdvic_link_target_missing(const char *url, const char *filename);
+
+/* stat() through a process-wide cache: each distinct path is looked up once,
+ * however many files and threads ask. Thread-safe. */
+int mdvic_path_exists(const char *path);
+void mdvic_path_cache_stats(unsigned long *hits, unsigned long *misses);
+
+enum mdvic_lint_format { MDVIC_LINT_TEXT, MDVIC_LINT_JSONL, MDVIC_LINT_SARIF };
+
+/* Lint paths ("-" is stdin), read as enc, on up to jobs threads (0 = one
+ * per CPU) and write the findings to out in path order:
+ * "file:line:col: message [rule]", one JSON object per line, or a SARIF
+ * 2.1.0 log. Unreadable files are
+ * reported to err. Returns the number of findings, or -1 if a file could
+ * not be read.
+ */
+int mdvic_lint_files(const char *const *paths, int n, enum mdvic_input_encoding enc, enum mdvic_lint_format fmt, int jobs, FILE *out, FILE *err);
+
+#endif /* MDVIC_LINT_H */
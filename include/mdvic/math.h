@@ -4,11 +4,52 @@
 #include <stddef.h>
 #include "mdvic.h"
 
+/* Which of opt->math_limits stopped a render. */
+enum mdvic_math_limit {
+    MDVIC_MATH_LIMIT_DEPTH = 1,
+    MDVIC_MATH_LIMIT_TOKENS = 2,
+    MDVIC_MATH_LIMIT_BYTES = 3
+};
+
 /* Render a math segment (content inside $...$ or $$...$$) to a UTF-8 string.
- * Caller must free(*out_str). Returns 0 on success.
+ * Caller must free(*out_str). Returns 0 on success, an mdvic_math_limit value
+ * (nothing is stored) if the span exceeds opt->math_limits, -1 on error.
  * Honors opt->math_mode (unicode|ascii).
  */
 int mdvic_math_render(const char *s, size_t len, const struct MdvicOptions *opt,
                       int display, char **out_str, size_t *out_len);
 
+/* Per-document memo of rendered math spans, keyed by the span bytes plus the
+ * display flag, math mode and accent mode. Bounded by max_entries slots and
+ * max_bytes of stored source + output; older entries are evicted as needed.
+ */
+struct MdvicMathCache;
+
+struct MdvicMathCache *mdvic_math_cache_new(size_t max_entries, size_t max_bytes);
+void mdvic_math_cache_free(struct MdvicMathCache *cache);
+
+/* Like mdvic_math_render, but the result is owned by the cache and stays valid
+ * only until the next call on the same cache. Returns as mdvic_math_render;
+ * spans that hit a limit are remembered too, so repeats fail fast.
+ */
+int mdvic_math_render_cached(struct MdvicMathCache *cache, const char *s, size_t len,
+                             const struct MdvicOptions *opt, int display,
+                             const char **out_str, size_t *out_len);
+
+/* Check a math segment for what would render wrongly: commands with no
+ * rendering ("math-command"), and \left/\right or \begin/\end that do not
+ * pair up ("math-group"). Each finding goes to fn with its byte offset in s.
+ * It keeps no state between calls and is safe on any thread.
+ * Returns the number of findings.
+ */
+typedef void (*mdvic_math_issue_fn)(void *ctx, size_t off, const char *rule, const char *message);
+int mdvic_math_check(const char *s, size_t len, mdvic_math_issue_fn fn, void *ctx);
+
+/* Short description of an mdvic_math_limit value, for diagnostics. */
+const char *mdvic_math_limit_name(int limit);
+
+/* Lookup counters since the cache was created. */
+void mdvic_math_cache_stats(const struct MdvicMathCache *cache,
+                            unsigned long *hits, unsigned long *misses);
+
 #endif /* MDVIC_MATH_H */
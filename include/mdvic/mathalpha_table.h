@@ -0,0 +1,529 @@
+/* Auto-generated by tools/gen_mathalpha.sh. Do not edit by hand. */
+#ifndef MDVIC_MATHALPHA_TABLE_H
+#define MDVIC_MATHALPHA_TABLE_H
+
+/* Indexed by ASCII code; NULL where Unicode has no counterpart. */
+
+static const char *const mdvic_math_bf[128] = {
+    ['0'] = "\xF0\x9D\x9F\x8E", /* U+1D7CE */
+    ['1'] = "\xF0\x9D\x9F\x8F", /* U+1D7CF */
+    ['2'] = "\xF0\x9D\x9F\x90", /* U+1D7D0 */
+    ['3'] = "\xF0\x9D\x9F\x91", /* U+1D7D1 */
+    ['4'] = "\xF0\x9D\x9F\x92", /* U+1D7D2 */
+    ['5'] = "\xF0\x9D\x9F\x93", /* U+1D7D3 */
+    ['6'] = "\xF0\x9D\x9F\x94", /* U+1D7D4 */
+    ['7'] = "\xF0\x9D\x9F\x95", /* U+1D7D5 */
+    ['8'] = "\xF0\x9D\x9F\x96", /* U+1D7D6 */
+    ['9'] = "\xF0\x9D\x9F\x97", /* U+1D7D7 */
+    ['A'] = "\xF0\x9D\x90\x80", /* U+1D400 */
+    ['B'] = "\xF0\x9D\x90\x81", /* U+1D401 */
+    ['C'] = "\xF0\x9D\x90\x82", /* U+1D402 */
+    ['D'] = "\xF0\x9D\x90\x83", /* U+1D403 */
+    ['E'] = "\xF0\x9D\x90\x84", /* U+1D404 */
+    ['F'] = "\xF0\x9D\x90\x85", /* U+1D405 */
+    ['G'] = "\xF0\x9D\x90\x86", /* U+1D406 */
+    ['H'] = "\xF0\x9D\x90\x87", /* U+1D407 */
+    ['I'] = "\xF0\x9D\x90\x88", /* U+1D408 */
+    ['J'] = "\xF0\x9D\x90\x89", /* U+1D409 */
+    ['K'] = "\xF0\x9D\x90\x8A", /* U+1D40A */
+    ['L'] = "\xF0\x9D\x90\x8B", /* U+1D40B */
+    ['M'] = "\xF0\x9D\x90\x8C", /* U+1D40C */
+    ['N'] = "\xF0\x9D\x90\x8D", /* U+1D40D */
+    ['O'] = "\xF0\x9D\x90\x8E", /* U+1D40E */
+    ['P'] = "\xF0\x9D\x90\x8F", /* U+1D40F */
+    ['Q'] = "\xF0\x9D\x90\x90", /* U+1D410 */
+    ['R'] = "\xF0\x9D\x90\x91", /* U+1D411 */
+    ['S'] = "\xF0\x9D\x90\x92", /* U+1D412 */
+    ['T'] = "\xF0\x9D\x90\x93", /* U+1D413 */
+    ['U'] = "\xF0\x9D\x90\x94", /* U+1D414 */
+    ['V'] = "\xF0\x9D\x90\x95", /* U+1D415 */
+    ['W'] = "\xF0\x9D\x90\x96", /* U+1D416 */
+    ['X'] = "\xF0\x9D\x90\x97", /* U+1D417 */
+    ['Y'] = "\xF0\x9D\x90\x98", /* U+1D418 */
+    ['Z'] = "\xF0\x9D\x90\x99", /* U+1D419 */
+    ['a'] = "\xF0\x9D\x90\x9A", /* U+1D41A */
+    ['b'] = "\xF0\x9D\x90\x9B", /* U+1D41B */
+    ['c'] = "\xF0\x9D\x90\x9C", /* U+1D41C */
+    ['d'] = "\xF0\x9D\x90\x9D", /* U+1D41D */
+    ['e'] = "\xF0\x9D\x90\x9E", /* U+1D41E */
+    ['f'] = "\xF0\x9D\x90\x9F", /* U+1D41F */
+    ['g'] = "\xF0\x9D\x90\xA0", /* U+1D420 */
+    ['h'] = "\xF0\x9D\x90\xA1", /* U+1D421 */
+    ['i'] = "\xF0\x9D\x90\xA2", /* U+1D422 */
+    ['j'] = "\xF0\x9D\x90\xA3", /* U+1D423 */
+    ['k'] = "\xF0\x9D\x90\xA4", /* U+1D424 */
+    ['l'] = "\xF0\x9D\x90\xA5", /* U+1D425 */
+    ['m'] = "\xF0\x9D\x90\xA6", /* U+1D426 */
+    ['n'] = "\xF0\x9D\x90\xA7", /* U+1D427 */
+    ['o'] = "\xF0\x9D\x90\xA8", /* U+1D428 */
+    ['p'] = "\xF0\x9D\x90\xA9", /* U+1D429 */
+    ['q'] = "\xF0\x9D\x90\xAA", /* U+1D42A */
+    ['r'] = "\xF0\x9D\x90\xAB", /* U+1D42B */
+    ['s'] = "\xF0\x9D\x90\xAC", /* U+1D42C */
+    ['t'] = "\xF0\x9D\x90\xAD", /* U+1D42D */
+    ['u'] = "\xF0\x9D\x90\xAE", /* U+1D42E */
+    ['v'] = "\xF0\x9D\x90\xAF", /* U+1D42F */
+    ['w'] = "\xF0\x9D\x90\xB0", /* U+1D430 */
+    ['x'] = "\xF0\x9D\x90\xB1", /* U+1D431 */
+    ['y'] = "\xF0\x9D\x90\xB2", /* U+1D432 */
+    ['z'] = "\xF0\x9D\x90\xB3", /* U+1D433 */
+};
+
+static const char *const mdvic_math_it[128] = {
+    ['A'] = "\xF0\x9D\x90\xB4", /* U+1D434 */
+    ['B'] = "\xF0\x9D\x90\xB5", /* U+1D435 */
+    ['C'] = "\xF0\x9D\x90\xB6", /* U+1D436 */
+    ['D'] = "\xF0\x9D\x90\xB7", /* U+1D437 */
+    ['E'] = "\xF0\x9D\x90\xB8", /* U+1D438 */
+    ['F'] = "\xF0\x9D\x90\xB9", /* U+1D439 */
+    ['G'] = "\xF0\x9D\x90\xBA", /* U+1D43A */
+    ['H'] = "\xF0\x9D\x90\xBB", /* U+1D43B */
+    ['I'] = "\xF0\x9D\x90\xBC", /* U+1D43C */
+    ['J'] = "\xF0\x9D\x90\xBD", /* U+1D43D */
+    ['K'] = "\xF0\x9D\x90\xBE", /* U+1D43E */
+    ['L'] = "\xF0\x9D\x90\xBF", /* U+1D43F */
+    ['M'] = "\xF0\x9D\x91\x80", /* U+1D440 */
+    ['N'] = "\xF0\x9D\x91\x81", /* U+1D441 */
+    ['O'] = "\xF0\x9D\x91\x82", /* U+1D442 */
+    ['P'] = "\xF0\x9D\x91\x83", /* U+1D443 */
+    ['Q'] = "\xF0\x9D\x91\x84", /* U+1D444 */
+    ['R'] = "\xF0\x9D\x91\x85", /* U+1D445 */
+    ['S'] = "\xF0\x9D\x91\x86", /* U+1D446 */
+    ['T'] = "\xF0\x9D\x91\x87", /* U+1D447 */
+    ['U'] = "\xF0\x9D\x91\x88", /* U+1D448 */
+    ['V'] = "\xF0\x9D\x91\x89", /* U+1D449 */
+    ['W'] = "\xF0\x9D\x91\x8A", /* U+1D44A */
+    ['X'] = "\xF0\x9D\x91\x8B", /* U+1D44B */
+    ['Y'] = "\xF0\x9D\x91\x8C", /* U+1D44C */
+    ['Z'] = "\xF0\x9D\x91\x8D", /* U+1D44D */
+    ['a'] = "\xF0\x9D\x91\x8E", /* U+1D44E */
+    ['b'] = "\xF0\x9D\x91\x8F", /* U+1D44F */
+    ['c'] = "\xF0\x9D\x91\x90", /* U+1D450 */
+    ['d'] = "\xF0\x9D\x91\x91", /* U+1D451 */
+    ['e'] = "\xF0\x9D\x91\x92", /* U+1D452 */
+    ['f'] = "\xF0\x9D\x91\x93", /* U+1D453 */
+    ['g'] = "\xF0\x9D\x91\x94", /* U+1D454 */
+    ['h'] = "\xE2\x84\x8E", /* U+210E */
+    ['i'] = "\xF0\x9D\x91\x96", /* U+1D456 */
+    ['j'] = "\xF0\x9D\x91\x97", /* U+1D457 */
+    ['k'] = "\xF0\x9D\x91\x98", /* U+1D458 */
+    ['l'] = "\xF0\x9D\x91\x99", /* U+1D459 */
+    ['m'] = "\xF0\x9D\x91\x9A", /* U+1D45A */
+    ['n'] = "\xF0\x9D\x91\x9B", /* U+1D45B */
+    ['o'] = "\xF0\x9D\x91\x9C", /* U+1D45C */
+    ['p'] = "\xF0\x9D\x91\x9D", /* U+1D45D */
+    ['q'] = "\xF0\x9D\x91\x9E", /* U+1D45E */
+    ['r'] = "\xF0\x9D\x91\x9F", /* U+1D45F */
+    ['s'] = "\xF0\x9D\x91\xA0", /* U+1D460 */
+    ['t'] = "\xF0\x9D\x91\xA1", /* U+1D461 */
+    ['u'] = "\xF0\x9D\x91\xA2", /* U+1D462 */
+    ['v'] = "\xF0\x9D\x91\xA3", /* U+1D463 */
+    ['w'] = "\xF0\x9D\x91\xA4", /* U+1D464 */
+    ['x'] = "\xF0\x9D\x91\xA5", /* U+1D465 */
+    ['y'] = "\xF0\x9D\x91\xA6", /* U+1D466 */
+    ['z'] = "\xF0\x9D\x91\xA7", /* U+1D467 */
+};
+
+static const char *const mdvic_math_cal[128] = {
+    ['A'] = "\xF0\x9D\x92\x9C", /* U+1D49C */
+    ['B'] = "\xE2\x84\xAC", /* U+212C */
+    ['C'] = "\xF0\x9D\x92\x9E", /* U+1D49E */
+    ['D'] = "\xF0\x9D\x92\x9F", /* U+1D49F */
+    ['E'] = "\xE2\x84\xB0", /* U+2130 */
+    ['F'] = "\xE2\x84\xB1", /* U+2131 */
+    ['G'] = "\xF0\x9D\x92\xA2", /* U+1D4A2 */
+    ['H'] = "\xE2\x84\x8B", /* U+210B */
+    ['I'] = "\xE2\x84\x90", /* U+2110 */
+    ['J'] = "\xF0\x9D\x92\xA5", /* U+1D4A5 */
+    ['K'] = "\xF0\x9D\x92\xA6", /* U+1D4A6 */
+    ['L'] = "\xE2\x84\x92", /* U+2112 */
+    ['M'] = "\xE2\x84\xB3", /* U+2133 */
+    ['N'] = "\xF0\x9D\x92\xA9", /* U+1D4A9 */
+    ['O'] = "\xF0\x9D\x92\xAA", /* U+1D4AA */
+    ['P'] = "\xF0\x9D\x92\xAB", /* U+1D4AB */
+    ['Q'] = "\xF0\x9D\x92\xAC", /* U+1D4AC */
+    ['R'] = "\xE2\x84\x9B", /* U+211B */
+    ['S'] = "\xF0\x9D\x92\xAE", /* U+1D4AE */
+    ['T'] = "\xF0\x9D\x92\xAF", /* U+1D4AF */
+    ['U'] = "\xF0\x9D\x92\xB0", /* U+1D4B0 */
+    ['V'] = "\xF0\x9D\x92\xB1", /* U+1D4B1 */
+    ['W'] = "\xF0\x9D\x92\xB2", /* U+1D4B2 */
+    ['X'] = "\xF0\x9D\x92\xB3", /* U+1D4B3 */
+    ['Y'] = "\xF0\x9D\x92\xB4", /* U+1D4B4 */
+    ['Z'] = "\xF0\x9D\x92\xB5", /* U+1D4B5 */
+    ['a'] = "\xF0\x9D\x92\xB6", /* U+1D4B6 */
+    ['b'] = "\xF0\x9D\x92\xB7", /* U+1D4B7 */
+    ['c'] = "\xF0\x9D\x92\xB8", /* U+1D4B8 */
+    ['d'] = "\xF0\x9D\x92\xB9", /* U+1D4B9 */
+    ['e'] = "\xE2\x84\xAF", /* U+212F */
+    ['f'] = "\xF0\x9D\x92\xBB", /* U+1D4BB */
+    ['g'] = "\xE2\x84\x8A", /* U+210A */
+    ['h'] = "\xF0\x9D\x92\xBD", /* U+1D4BD */
+    ['i'] = "\xF0\x9D\x92\xBE", /* U+1D4BE */
+    ['j'] = "\xF0\x9D\x92\xBF", /* U+1D4BF */
+    ['k'] = "\xF0\x9D\x93\x80", /* U+1D4C0 */
+    ['l'] = "\xF0\x9D\x93\x81", /* U+1D4C1 */
+    ['m'] = "\xF0\x9D\x93\x82", /* U+1D4C2 */
+    ['n'] = "\xF0\x9D\x93\x83", /* U+1D4C3 */
+    ['o'] = "\xE2\x84\xB4", /* U+2134 */
+    ['p'] = "\xF0\x9D\x93\x85", /* U+1D4C5 */
+    ['q'] = "\xF0\x9D\x93\x86", /* U+1D4C6 */
+    ['r'] = "\xF0\x9D\x93\x87", /* U+1D4C7 */
+    ['s'] = "\xF0\x9D\x93\x88", /* U+1D4C8 */
+    ['t'] = "\xF0\x9D\x93\x89", /* U+1D4C9 */
+    ['u'] = "\xF0\x9D\x93\x8A", /* U+1D4CA */
+    ['v'] = "\xF0\x9D\x93\x8B", /* U+1D4CB */
+    ['w'] = "\xF0\x9D\x93\x8C", /* U+1D4CC */
+    ['x'] = "\xF0\x9D\x93\x8D", /* U+1D4CD */
+    ['y'] = "\xF0\x9D\x93\x8E", /* U+1D4CE */
+    ['z'] = "\xF0\x9D\x93\x8F", /* U+1D4CF */
+};
+
+static const char *const mdvic_math_frak[128] = {
+    ['A'] = "\xF0\x9D\x94\x84", /* U+1D504 */
+    ['B'] = "\xF0\x9D\x94\x85", /* U+1D505 */
+    ['C'] = "\xE2\x84\xAD", /* U+212D */
+    ['D'] = "\xF0\x9D\x94\x87", /* U+1D507 */
+    ['E'] = "\xF0\x9D\x94\x88", /* U+1D508 */
+    ['F'] = "\xF0\x9D\x94\x89", /* U+1D509 */
+    ['G'] = "\xF0\x9D\x94\x8A", /* U+1D50A */
+    ['H'] = "\xE2\x84\x8C", /* U+210C */
+    ['I'] = "\xE2\x84\x91", /* U+2111 */
+    ['J'] = "\xF0\x9D\x94\x8D", /* U+1D50D */
+    ['K'] = "\xF0\x9D\x94\x8E", /* U+1D50E */
+    ['L'] = "\xF0\x9D\x94\x8F", /* U+1D50F */
+    ['M'] = "\xF0\x9D\x94\x90", /* U+1D510 */
+    ['N'] = "\xF0\x9D\x94\x91", /* U+1D511 */
+    ['O'] = "\xF0\x9D\x94\x92", /* U+1D512 */
+    ['P'] = "\xF0\x9D\x94\x93", /* U+1D513 */
+    ['Q'] = "\xF0\x9D\x94\x94", /* U+1D514 */
+    ['R'] = "\xE2\x84\x9C", /* U+211C */
+    ['S'] = "\xF0\x9D\x94\x96", /* U+1D516 */
+    ['T'] = "\xF0\x9D\x94\x97", /* U+1D517 */
+    ['U'] = "\xF0\x9D\x94\x98", /* U+1D518 */
+    ['V'] = "\xF0\x9D\x94\x99", /* U+1D519 */
+    ['W'] = "\xF0\x9D\x94\x9A", /* U+1D51A */
+    ['X'] = "\xF0\x9D\x94\x9B", /* U+1D51B */
+    ['Y'] = "\xF0\x9D\x94\x9C", /* U+1D51C */
+    ['Z'] = "\xE2\x84\xA8", /* U+2128 */
+    ['a'] = "\xF0\x9D\x94\x9E", /* U+1D51E */
+    ['b'] = "\xF0\x9D\x94\x9F", /* U+1D51F */
+    ['c'] = "\xF0\x9D\x94\xA0", /* U+1D520 */
+    ['d'] = "\xF0\x9D\x94\xA1", /* U+1D521 */
+    ['e'] = "\xF0\x9D\x94\xA2", /* U+1D522 */
+    ['f'] = "\xF0\x9D\x94\xA3", /* U+1D523 */
+    ['g'] = "\xF0\x9D\x94\xA4", /* U+1D524 */
+    ['h'] = "\xF0\x9D\x94\xA5", /* U+1D525 */
+    ['i'] = "\xF0\x9D\x94\xA6", /* U+1D526 */
+    ['j'] = "\xF0\x9D\x94\xA7", /* U+1D527 */
+    ['k'] = "\xF0\x9D\x94\xA8", /* U+1D528 */
+    ['l'] = "\xF0\x9D\x94\xA9", /* U+1D529 */
+    ['m'] = "\xF0\x9D\x94\xAA", /* U+1D52A */
+    ['n'] = "\xF0\x9D\x94\xAB", /* U+1D52B */
+    ['o'] = "\xF0\x9D\x94\xAC", /* U+1D52C */
+    ['p'] = "\xF0\x9D\x94\xAD", /* U+1D52D */
+    ['q'] = "\xF0\x9D\x94\xAE", /* U+1D52E */
+    ['r'] = "\xF0\x9D\x94\xAF", /* U+1D52F */
+    ['s'] = "\xF0\x9D\x94\xB0", /* U+1D530 */
+    ['t'] = "\xF0\x9D\x94\xB1", /* U+1D531 */
+    ['u'] = "\xF0\x9D\x94\xB2", /* U+1D532 */
+    ['v'] = "\xF0\x9D\x94\xB3", /* U+1D533 */
+    ['w'] = "\xF0\x9D\x94\xB4", /* U+1D534 */
+    ['x'] = "\xF0\x9D\x94\xB5", /* U+1D535 */
+    ['y'] = "\xF0\x9D\x94\xB6", /* U+1D536 */
+    ['z'] = "\xF0\x9D\x94\xB7", /* U+1D537 */
+};
+
+static const char *const mdvic_math_bb[128] = {
+    ['0'] = "\xF0\x9D\x9F\x98", /* U+1D7D8 */
+    ['1'] = "\xF0\x9D\x9F\x99", /* U+1D7D9 */
+    ['2'] = "\xF0\x9D\x9F\x9A", /* U+1D7DA */
+    ['3'] = "\xF0\x9D\x9F\x9B", /* U+1D7DB */
+    ['4'] = "\xF0\x9D\x9F\x9C", /* U+1D7DC */
+    ['5'] = "\xF0\x9D\x9F\x9D", /* U+1D7DD */
+    ['6'] = "\xF0\x9D\x9F\x9E", /* U+1D7DE */
+    ['7'] = "\xF0\x9D\x9F\x9F", /* U+1D7DF */
+    ['8'] = "\xF0\x9D\x9F\xA0", /* U+1D7E0 */
+    ['9'] = "\xF0\x9D\x9F\xA1", /* U+1D7E1 */
+    ['A'] = "\xF0\x9D\x94\xB8", /* U+1D538 */
+    ['B'] = "\xF0\x9D\x94\xB9", /* U+1D539 */
+    ['C'] = "\xE2\x84\x82", /* U+2102 */
+    ['D'] = "\xF0\x9D\x94\xBB", /* U+1D53B */
+    ['E'] = "\xF0\x9D\x94\xBC", /* U+1D53C */
+    ['F'] = "\xF0\x9D\x94\xBD", /* U+1D53D */
+    ['G'] = "\xF0\x9D\x94\xBE", /* U+1D53E */
+    ['H'] = "\xE2\x84\x8D", /* U+210D */
+    ['I'] = "\xF0\x9D\x95\x80", /* U+1D540 */
+    ['J'] = "\xF0\x9D\x95\x81", /* U+1D541 */
+    ['K'] = "\xF0\x9D\x95\x82", /* U+1D542 */
+    ['L'] = "\xF0\x9D\x95\x83", /* U+1D543 */
+    ['M'] = "\xF0\x9D\x95\x84", /* U+1D544 */
+    ['N'] = "\xE2\x84\x95", /* U+2115 */
+    ['O'] = "\xF0\x9D\x95\x86", /* U+1D546 */
+    ['P'] = "\xE2\x84\x99", /* U+2119 */
+    ['Q'] = "\xE2\x84\x9A", /* U+211A */
+    ['R'] = "\xE2\x84\x9D", /* U+211D */
+    ['S'] = "\xF0\x9D\x95\x8A", /* U+1D54A */
+    ['T'] = "\xF0\x9D\x95\x8B", /* U+1D54B */
+    ['U'] = "\xF0\x9D\x95\x8C", /* U+1D54C */
+    ['V'] = "\xF0\x9D\x95\x8D", /* U+1D54D */
+    ['W'] = "\xF0\x9D\x95\x8E", /* U+1D54E */
+    ['X'] = "\xF0\x9D\x95\x8F", /* U+1D54F */
+    ['Y'] = "\xF0\x9D\x95\x90", /* U+1D550 */
+    ['Z'] = "\xE2\x84\xA4", /* U+2124 */
+    ['a'] = "\xF0\x9D\x95\x92", /* U+1D552 */
+    ['b'] = "\xF0\x9D\x95\x93", /* U+1D553 */
+    ['c'] = "\xF0\x9D\x95\x94", /* U+1D554 */
+    ['d'] = "\xF0\x9D\x95\x95", /* U+1D555 */
+    ['e'] = "\xF0\x9D\x95\x96", /* U+1D556 */
+    ['f'] = "\xF0\x9D\x95\x97", /* U+1D557 */
+    ['g'] = "\xF0\x9D\x95\x98", /* U+1D558 */
+    ['h'] = "\xF0\x9D\x95\x99", /* U+1D559 */
+    ['i'] = "\xF0\x9D\x95\x9A", /* U+1D55A */
+    ['j'] = "\xF0\x9D\x95\x9B", /* U+1D55B */
+    ['k'] = "\xF0\x9D\x95\x9C", /* U+1D55C */
+    ['l'] = "\xF0\x9D\x95\x9D", /* U+1D55D */
+    ['m'] = "\xF0\x9D\x95\x9E", /* U+1D55E */
+    ['n'] = "\xF0\x9D\x95\x9F", /* U+1D55F */
+    ['o'] = "\xF0\x9D\x95\xA0", /* U+1D560 */
+    ['p'] = "\xF0\x9D\x95\xA1", /* U+1D561 */
+    ['q'] = "\xF0\x9D\x95\xA2", /* U+1D562 */
+    ['r'] = "\xF0\x9D\x95\xA3", /* U+1D563 */
+    ['s'] = "\xF0\x9D\x95\xA4", /* U+1D564 */
+    ['t'] = "\xF0\x9D\x95\xA5", /* U+1D565 */
+    ['u'] = "\xF0\x9D\x95\xA6", /* U+1D566 */
+    ['v'] = "\xF0\x9D\x95\xA7", /* U+1D567 */
+    ['w'] = "\xF0\x9D\x95\xA8", /* U+1D568 */
+    ['x'] = "\xF0\x9D\x95\xA9", /* U+1D569 */
+    ['y'] = "\xF0\x9D\x95\xAA", /* U+1D56A */
+    ['z'] = "\xF0\x9D\x95\xAB", /* U+1D56B */
+};
+
+static const char *const mdvic_math_sf[128] = {
+    ['0'] = "\xF0\x9D\x9F\xA2", /* U+1D7E2 */
+    ['1'] = "\xF0\x9D\x9F\xA3", /* U+1D7E3 */
+    ['2'] = "\xF0\x9D\x9F\xA4", /* U+1D7E4 */
+    ['3'] = "\xF0\x9D\x9F\xA5", /* U+1D7E5 */
+    ['4'] = "\xF0\x9D\x9F\xA6", /* U+1D7E6 */
+    ['5'] = "\xF0\x9D\x9F\xA7", /* U+1D7E7 */
+    ['6'] = "\xF0\x9D\x9F\xA8", /* U+1D7E8 */
+    ['7'] = "\xF0\x9D\x9F\xA9", /* U+1D7E9 */
+    ['8'] = "\xF0\x9D\x9F\xAA", /* U+1D7EA */
+    ['9'] = "\xF0\x9D\x9F\xAB", /* U+1D7EB */
+    ['A'] = "\xF0\x9D\x96\xA0", /* U+1D5A0 */
+    ['B'] = "\xF0\x9D\x96\xA1", /* U+1D5A1 */
+    ['C'] = "\xF0\x9D\x96\xA2", /* U+1D5A2 */
+    ['D'] = "\xF0\x9D\x96\xA3", /* U+1D5A3 */
+    ['E'] = "\xF0\x9D\x96\xA4", /* U+1D5A4 */
+    ['F'] = "\xF0\x9D\x96\xA5", /* U+1D5A5 */
+    ['G'] = "\xF0\x9D\x96\xA6", /* U+1D5A6 */
+    ['H'] = "\xF0\x9D\x96\xA7", /* U+1D5A7 */
+    ['I'] = "\xF0\x9D\x96\xA8", /* U+1D5A8 */
+    ['J'] = "\xF0\x9D\x96\xA9", /* U+1D5A9 */
+    ['K'] = "\xF0\x9D\x96\xAA", /* U+1D5AA */
+    ['L'] = "\xF0\x9D\x96\xAB", /* U+1D5AB */
+    ['M'] = "\xF0\x9D\x96\xAC", /* U+1D5AC */
+    ['N'] = "\xF0\x9D\x96\xAD", /* U+1D5AD */
+    ['O'] = "\xF0\x9D\x96\xAE", /* U+1D5AE */
+    ['P'] = "\xF0\x9D\x96\xAF", /* U+1D5AF */
+    ['Q'] = "\xF0\x9D\x96\xB0", /* U+1D5B0 */
+    ['R'] = "\xF0\x9D\x96\xB1", /* U+1D5B1 */
+    ['S'] = "\xF0\x9D\x96\xB2", /* U+1D5B2 */
+    ['T'] = "\xF0\x9D\x96\xB3", /* U+1D5B3 */
+    ['U'] = "\xF0\x9D\x96\xB4", /* U+1D5B4 */
+    ['V'] = "\xF0\x9D\x96\xB5", /* U+1D5B5 */
+    ['W'] = "\xF0\x9D\x96\xB6", /* U+1D5B6 */
+    ['X'] = "\xF0\x9D\x96\xB7", /* U+1D5B7 */
+    ['Y'] = "\xF0\x9D\x96\xB8", /* U+1D5B8 */
+    ['Z'] = "\xF0\x9D\x96\xB9", /* U+1D5B9 */
+    ['a'] = "\xF0\x9D\x96\xBA", /* U+1D5BA */
+    ['b'] = "\xF0\x9D\x96\xBB", /* U+1D5BB */
+    ['c'] = "\xF0\x9D\x96\xBC", /* U+1D5BC */
+    ['d'] = "\xF0\x9D\x96\xBD", /* U+1D5BD */
+    ['e'] = "\xF0\x9D\x96\xBE", /* U+1D5BE */
+    ['f'] = "\xF0\x9D\x96\xBF", /* U+1D5BF */
+    ['g'] = "\xF0\x9D\x97\x80", /* U+1D5C0 */
+    ['h'] = "\xF0\x9D\x97\x81", /* U+1D5C1 */
+    ['i'] = "\xF0\x9D\x97\x82", /* U+1D5C2 */
+    ['j'] = "\xF0\x9D\x97\x83", /* U+1D5C3 */
+    ['k'] = "\xF0\x9D\x97\x84", /* U+1D5C4 */
+    ['l'] = "\xF0\x9D\x97\x85", /* U+1D5C5 */
+    ['m'] = "\xF0\x9D\x97\x86", /* U+1D5C6 */
+    ['n'] = "\xF0\x9D\x97\x87", /* U+1D5C7 */
+    ['o'] = "\xF0\x9D\x97\x88", /* U+1D5C8 */
+    ['p'] = "\xF0\x9D\x97\x89", /* U+1D5C9 */
+    ['q'] = "\xF0\x9D\x97\x8A", /* U+1D5CA */
+    ['r'] = "\xF0\x9D\x97\x8B", /* U+1D5CB */
+    ['s'] = "\xF0\x9D\x97\x8C", /* U+1D5CC */
+    ['t'] = "\xF0\x9D\x97\x8D", /* U+1D5CD */
+    ['u'] = "\xF0\x9D\x97\x8E", /* U+1D5CE */
+    ['v'] = "\xF0\x9D\x97\x8F", /* U+1D5CF */
+    ['w'] = "\xF0\x9D\x97\x90", /* U+1D5D0 */
+    ['x'] = "\xF0\x9D\x97\x91", /* U+1D5D1 */
+    ['y'] = "\xF0\x9D\x97\x92", /* U+1D5D2 */
+    ['z'] = "\xF0\x9D\x97\x93", /* U+1D5D3 */
+};
+
+static const char *const mdvic_math_tt[128] = {
+    ['0'] = "\xF0\x9D\x9F\xB6", /* U+1D7F6 */
+    ['1'] = "\xF0\x9D\x9F\xB7", /* U+1D7F7 */
+    ['2'] = "\xF0\x9D\x9F\xB8", /* U+1D7F8 */
+    ['3'] = "\xF0\x9D\x9F\xB9", /* U+1D7F9 */
+    ['4'] = "\xF0\x9D\x9F\xBA", /* U+1D7FA */
+    ['5'] = "\xF0\x9D\x9F\xBB", /* U+1D7FB */
+    ['6'] = "\xF0\x9D\x9F\xBC", /* U+1D7FC */
+    ['7'] = "\xF0\x9D\x9F\xBD", /* U+1D7FD */
+    ['8'] = "\xF0\x9D\x9F\xBE", /* U+1D7FE */
+    ['9'] = "\xF0\x9D\x9F\xBF", /* U+1D7FF */
+    ['A'] = "\xF0\x9D\x99\xB0", /* U+1D670 */
+    ['B'] = "\xF0\x9D\x99\xB1", /* U+1D671 */
+    ['C'] = "\xF0\x9D\x99\xB2", /* U+1D672 */
+    ['D'] = "\xF0\x9D\x99\xB3", /* U+1D673 */
+    ['E'] = "\xF0\x9D\x99\xB4", /* U+1D674 */
+    ['F'] = "\xF0\x9D\x99\xB5", /* U+1D675 */
+    ['G'] = "\xF0\x9D\x99\xB6", /* U+1D676 */
+    ['H'] = "\xF0\x9D\x99\xB7", /* U+1D677 */
+    ['I'] = "\xF0\x9D\x99\xB8", /* U+1D678 */
+    ['J'] = "\xF0\x9D\x99\xB9", /* U+1D679 */
+    ['K'] = "\xF0\x9D\x99\xBA", /* U+1D67A */
+    ['L'] = "\xF0\x9D\x99\xBB", /* U+1D67B */
+    ['M'] = "\xF0\x9D\x99\xBC", /* U+1D67C */
+    ['N'] = "\xF0\x9D\x99\xBD", /* U+1D67D */
+    ['O'] = "\xF0\x9D\x99\xBE", /* U+1D67E */
+    ['P'] = "\xF0\x9D\x99\xBF", /* U+1D67F */
+    ['Q'] = "\xF0\x9D\x9A\x80", /* U+1D680 */
+    ['R'] = "\xF0\x9D\x9A\x81", /* U+1D681 */
+    ['S'] = "\xF0\x9D\x9A\x82", /* U+1D682 */
+    ['T'] = "\xF0\x9D\x9A\x83", /* U+1D683 */
+    ['U'] = "\xF0\x9D\x9A\x84", /* U+1D684 */
+    ['V'] = "\xF0\x9D\x9A\x85", /* U+1D685 */
+    ['W'] = "\xF0\x9D\x9A\x86", /* U+1D686 */
+    ['X'] = "\xF0\x9D\x9A\x87", /* U+1D687 */
+    ['Y'] = "\xF0\x9D\x9A\x88", /* U+1D688 */
+    ['Z'] = "\xF0\x9D\x9A\x89", /* U+1D689 */
+    ['a'] = "\xF0\x9D\x9A\x8A", /* U+1D68A */
+    ['b'] = "\xF0\x9D\x9A\x8B", /* U+1D68B */
+    ['c'] = "\xF0\x9D\x9A\x8C", /* U+1D68C */
+    ['d'] = "\xF0\x9D\x9A\x8D", /* U+1D68D */
+    ['e'] = "\xF0\x9D\x9A\x8E", /* U+1D68E */
+    ['f'] = "\xF0\x9D\x9A\x8F", /* U+1D68F */
+    ['g'] = "\xF0\x9D\x9A\x90", /* U+1D690 */
+    ['h'] = "\xF0\x9D\x9A\x91", /* U+1D691 */
+    ['i'] = "\xF0\x9D\x9A\x92", /* U+1D692 */
+    ['j'] = "\xF0\x9D\x9A\x93", /* U+1D693 */
+    ['k'] = "\xF0\x9D\x9A\x94", /* U+1D694 */
+    ['l'] = "\xF0\x9D\x9A\x95", /* U+1D695 */
+    ['m'] = "\xF0\x9D\x9A\x96", /* U+1D696 */
+    ['n'] = "\xF0\x9D\x9A\x97", /* U+1D697 */
+    ['o'] = "\xF0\x9D\x9A\x98", /* U+1D698 */
+    ['p'] = "\xF0\x9D\x9A\x99", /* U+1D699 */
+    ['q'] = "\xF0\x9D\x9A\x9A", /* U+1D69A */
+    ['r'] = "\xF0\x9D\x9A\x9B", /* U+1D69B */
+    ['s'] = "\xF0\x9D\x9A\x9C", /* U+1D69C */
+    ['t'] = "\xF0\x9D\x9A\x9D", /* U+1D69D */
+    ['u'] = "\xF0\x9D\x9A\x9E", /* U+1D69E */
+    ['v'] = "\xF0\x9D\x9A\x9F", /* U+1D69F */
+    ['w'] = "\xF0\x9D\x9A\xA0", /* U+1D6A0 */
+    ['x'] = "\xF0\x9D\x9A\xA1", /* U+1D6A1 */
+    ['y'] = "\xF0\x9D\x9A\xA2", /* U+1D6A2 */
+    ['z'] = "\xF0\x9D\x9A\xA3", /* U+1D6A3 */
+};
+
+static const char *const mdvic_math_sup[128] = {
+    ['0'] = "\xE2\x81\xB0", /* U+2070 */
+    ['1'] = "\xC2\xB9", /* U+00B9 */
+    ['2'] = "\xC2\xB2", /* U+00B2 */
+    ['3'] = "\xC2\xB3", /* U+00B3 */
+    ['4'] = "\xE2\x81\xB4", /* U+2074 */
+    ['5'] = "\xE2\x81\xB5", /* U+2075 */
+    ['6'] = "\xE2\x81\xB6", /* U+2076 */
+    ['7'] = "\xE2\x81\xB7", /* U+2077 */
+    ['8'] = "\xE2\x81\xB8", /* U+2078 */
+    ['9'] = "\xE2\x81\xB9", /* U+2079 */
+    ['+'] = "\xE2\x81\xBA", /* U+207A */
+    ['-'] = "\xE2\x81\xBB", /* U+207B */
+    ['='] = "\xE2\x81\xBC", /* U+207C */
+    ['('] = "\xE2\x81\xBD", /* U+207D */
+    [')'] = "\xE2\x81\xBE", /* U+207E */
+    ['A'] = "\xE1\xB4\xAC", /* U+1D2C */
+    ['B'] = "\xE1\xB4\xAE", /* U+1D2E */
+    ['D'] = "\xE1\xB4\xB0", /* U+1D30 */
+    ['E'] = "\xE1\xB4\xB1", /* U+1D31 */
+    ['G'] = "\xE1\xB4\xB3", /* U+1D33 */
+    ['H'] = "\xE1\xB4\xB4", /* U+1D34 */
+    ['I'] = "\xE1\xB4\xB5", /* U+1D35 */
+    ['J'] = "\xE1\xB4\xB6", /* U+1D36 */
+    ['K'] = "\xE1\xB4\xB7", /* U+1D37 */
+    ['L'] = "\xE1\xB4\xB8", /* U+1D38 */
+    ['M'] = "\xE1\xB4\xB9", /* U+1D39 */
+    ['N'] = "\xE1\xB4\xBA", /* U+1D3A */
+    ['O'] = "\xE1\xB4\xBC", /* U+1D3C */
+    ['P'] = "\xE1\xB4\xBE", /* U+1D3E */
+    ['R'] = "\xE1\xB4\xBF", /* U+1D3F */
+    ['T'] = "\xE1\xB5\x80", /* U+1D40 */
+    ['U'] = "\xE1\xB5\x81", /* U+1D41 */
+    ['V'] = "\xE2\xB1\xBD", /* U+2C7D */
+    ['W'] = "\xE1\xB5\x82", /* U+1D42 */
+    ['a'] = "\xE1\xB5\x83", /* U+1D43 */
+    ['b'] = "\xE1\xB5\x87", /* U+1D47 */
+    ['c'] = "\xE1\xB6\x9C", /* U+1D9C */
+    ['d'] = "\xE1\xB5\x88", /* U+1D48 */
+    ['e'] = "\xE1\xB5\x89", /* U+1D49 */
+    ['f'] = "\xE1\xB6\xA0", /* U+1DA0 */
+    ['g'] = "\xE1\xB5\x8D", /* U+1D4D */
+    ['h'] = "\xCA\xB0", /* U+02B0 */
+    ['i'] = "\xE2\x81\xB1", /* U+2071 */
+    ['j'] = "\xCA\xB2", /* U+02B2 */
+    ['k'] = "\xE1\xB5\x8F", /* U+1D4F */
+    ['l'] = "\xCB\xA1", /* U+02E1 */
+    ['m'] = "\xE1\xB5\x90", /* U+1D50 */
+    ['n'] = "\xE2\x81\xBF", /* U+207F */
+    ['o'] = "\xE1\xB5\x92", /* U+1D52 */
+    ['p'] = "\xE1\xB5\x96", /* U+1D56 */
+    ['r'] = "\xCA\xB3", /* U+02B3 */
+    ['s'] = "\xCB\xA2", /* U+02E2 */
+    ['t'] = "\xE1\xB5\x97", /* U+1D57 */
+    ['u'] = "\xE1\xB5\x98", /* U+1D58 */
+    ['v'] = "\xE1\xB5\x9B", /* U+1D5B */
+    ['w'] = "\xCA\xB7", /* U+02B7 */
+    ['x'] = "\xCB\xA3", /* U+02E3 */
+    ['y'] = "\xCA\xB8", /* U+02B8 */
+    ['z'] = "\xE1\xB6\xBB", /* U+1DBB */
+};
+
+static const char *const mdvic_math_sub[128] = {
+    ['0'] = "\xE2\x82\x80", /* U+2080 */
+    ['1'] = "\xE2\x82\x81", /* U+2081 */
+    ['2'] = "\xE2\x82\x82", /* U+2082 */
+    ['3'] = "\xE2\x82\x83", /* U+2083 */
+    ['4'] = "\xE2\x82\x84", /* U+2084 */
+    ['5'] = "\xE2\x82\x85", /* U+2085 */
+    ['6'] = "\xE2\x82\x86", /* U+2086 */
+    ['7'] = "\xE2\x82\x87", /* U+2087 */
+    ['8'] = "\xE2\x82\x88", /* U+2088 */
+    ['9'] = "\xE2\x82\x89", /* U+2089 */
+    ['+'] = "\xE2\x82\x8A", /* U+208A */
+    ['-'] = "\xE2\x82\x8B", /* U+208B */
+    ['='] = "\xE2\x82\x8C", /* U+208C */
+    ['('] = "\xE2\x82\x8D", /* U+208D */
+    [')'] = "\xE2\x82\x8E", /* U+208E */
+    ['a'] = "\xE2\x82\x90", /* U+2090 */
+    ['e'] = "\xE2\x82\x91", /* U+2091 */
+    ['h'] = "\xE2\x82\x95", /* U+2095 */
+    ['i'] = "\xE1\xB5\xA2", /* U+1D62 */
+    ['j'] = "\xE2\xB1\xBC", /* U+2C7C */
+    ['k'] = "\xE2\x82\x96", /* U+2096 */
+    ['l'] = "\xE2\x82\x97", /* U+2097 */
+    ['m'] = "\xE2\x82\x98", /* U+2098 */
+    ['n'] = "\xE2\x82\x99", /* U+2099 */
+    ['o'] = "\xE2\x82\x92", /* U+2092 */
+    ['p'] = "\xE2\x82\x9A", /* U+209A */
+    ['r'] = "\xE1\xB5\xA3", /* U+1D63 */
+    ['s'] = "\xE2\x82\x9B", /* U+209B */
+    ['t'] = "\xE2\x82\x9C", /* U+209C */
+    ['u'] = "\xE1\xB5\xA4", /* U+1D64 */
+    ['v'] = "\xE1\xB5\xA5", /* U+1D65 */
+    ['x'] = "\xE2\x82\x93", /* U+2093 */
+};
+
+#endif /* MDVIC_MATHALPHA_TABLE_H */
@@ -0,0 +1,69 @@
+#ifndef MDVIC_MATHSPAN_H
+#define MDVIC_MATHSPAN_H
+
+#include <stddef.h>
+
+/*
+ * Pre-parse math extraction. A single linear pass over the raw Markdown finds
+ * $...$ and $$...$$ spans outside fenced and indented code, inline code spans,
+ * autolinks, raw HTML tags and link destinations, and produces a copy of the
+ * source in which every span is replaced by an opaque placeholder (U+E000
+ * <index> U+E001). cmark never sees the TeX, so emphasis and other inline
+ * syntax cannot split it; the renderer resolves placeholders back to spans
+ * when it meets them in text.
+ *
+ * Pairing follows the renderer's historical rule: a run of N dollars closes at
+ * the next run of exactly N dollars. Single-dollar spans stay on one line;
+ * $$ spans may cross lines within a paragraph.
+ */
+
+#define MDVIC_MATH_PH_OPEN  "\xEE\x80\x80" /* U+E000 */
+#define MDVIC_MATH_PH_CLOSE "\xEE\x80\x81" /* U+E001 */
+
+struct MdvicMathSpan {
+    const char *raw; size_t raw_len; /* original bytes, delimiters included */
+    const char *tex; size_t tex_len; /* content between the delimiters */
+    int display;                     /* 1 for $$...$$ */
+    int line;                        /* 1-based source line of the opening delimiter */
+};
+
+struct MdvicMathSpans {
+    struct MdvicMathSpan *spans;
+    size_t count;
+    char *masked;      /* NUL-terminated source with placeholders; NULL if count == 0 */
+    size_t masked_len;
+    /* private */
+    char *arena;       /* normalized TeX of multi-line spans */
+    int *line_map;     /* pairs (masked line, lines removed up to and including it) */
+    size_t line_map_n;
+};
+
+/* Scan src. Returns 0 on success, 1 if the source already contains placeholder
+ * code points (extraction is skipped and *ms is left empty), -1 on allocation
+ * failure. Spans point into src, which must outlive *ms.
+ */
+int mdvic_math_extract(const char *src, size_t len, struct MdvicMathSpans *ms);
+void mdvic_math_spans_free(struct MdvicMathSpans *ms);
+
+/* A run of dollars that opens no span. */
+struct MdvicMathDelim {
+    size_t pos; /* offset in src */
+    int len;    /* number of dollars */
+    int line;   /* 1-based source line */
+};
+
+/* The dollar runs mdvic_math_extract would leave unpaired, in source order,
+ * for lint. *out is malloc'ed (NULL when there are none). Returns 0, or -1 on
+ * allocation failure.
+ */
+int mdvic_math_lone_delims(const char *src, size_t len, struct MdvicMathDelim **out, size_t *n);
+
+/* If s starts with a placeholder, store its span index and return the number
+ * of bytes it occupies; otherwise return 0.
+ */
+size_t mdvic_math_placeholder_at(const char *s, size_t len, size_t *index);
+
+/* Map a line number in ms->masked back to the original source. */
+int mdvic_math_source_line(const struct MdvicMathSpans *ms, int masked_line);
+
+#endif /* MDVIC_MATHSPAN_H */
@@ -3,8 +3,11 @@
 #define MDVIC_MDVIC_H
 
 #include <stdio.h>
+#include <stddef.h>
 #include <stdbool.h>
 
+#include "mdvic/utf8.h"
+
 #define MDVIC_VERSION "0.0.1-dev"
 
 enum mdvic_math_mode {
@@ -12,6 +15,23 @@ enum mdvic_math_mode {
     MDVIC_MATH_ASCII = 1
 };
 
+/* Per-span budget for the math renderer; 0 disables a limit. A span that
+ * exceeds any of them is printed as raw TeX. */
+struct MdvicMathLimits {
+    int max_depth;     /* nested groups and command arguments */
+    size_t max_tokens; /* commands and characters processed */
+    size_t max_bytes;  /* output written, intermediate results included */
+};
+
+/* Large enough for a 100x100 matrix (about 50k tokens, 350 KB written). */
+#define MDVIC_MATH_DEFAULT_DEPTH  64
+#define MDVIC_MATH_DEFAULT_TOKENS 250000
+#define MDVIC_MATH_DEFAULT_BYTES  (2u * 1024u * 1024u)
+
+struct MdvicTheme;
+struct MdvicStats;
+struct MdvicTrace;
+
 struct MdvicOptions {
     bool no_color;
     int width; /* 0 = auto-detect */
@@ -19,16 +39,74 @@ struct MdvicOptions {
     bool enable_lint; /* default true; can be disabled by --no-lint or MDVIC_NO_LINT=1 */
     bool enable_wrap; /* default false (no-wrap). Enable with --wrap or MDVIC_WRAP=1 */
     bool enable_osc8; /* default true; can be disabled by --no-osc8 or MDVIC_NO_OSC8=1 */
+    bool enable_highlight; /* default true; fenced code in known languages is coloured. Disable with --no-highlight or MDVIC_NO_HIGHLIGHT=1 */
     bool accent_group; /* default false (apply accent to last char), set true to apply to group (function-style) */
+    struct MdvicMathLimits math_limits; /* set by --math-limit or MDVIC_MATH_LIMIT */
+    const struct MdvicTheme *theme; /* compiled theme; NULL = built-in */
+    struct MdvicStats *stats; /* --stats: counters to add to (see stats.h); NULL = off */
+    struct MdvicTrace *trace; /* --trace: per-block events (see trace.h); NULL = off */
+    enum mdvic_input_encoding input_encoding; /* --input-encoding or MDVIC_INPUT_ENCODING; default AUTO (BOM, else UTF-8) */
 };
 
 /* Apply environment overrides (MDVIC_NO_COLOR, MDVIC_WIDTH, MDVIC_MATH). */
 void mdvic_apply_env_overrides(struct MdvicOptions *opt);
 
+/* Parse a --math-limit spec such as "depth=32,tokens=5000,bytes=65536" or
+ * "none" into lim. Keys not named keep their value. Returns 0 on success.
+ */
+int mdvic_parse_math_limit(const char *spec, struct MdvicMathLimits *lim);
+
 /* Best-effort detection of terminal width; returns 0 if unknown. */
 int mdvic_detect_width(void);
 
 /* Render a single input stream to out, honoring options. */
 int mdvic_render_stream(FILE *in, FILE *out, const struct MdvicOptions *opt, const char *filename);
 
+/* Incremental rendering: mdvic_doc_open reads, lints and parses the whole
+ * input; each mdvic_doc_render_next call then writes one top-level block to
+ * out and returns 1, or returns 0 once the document is done.
+ * mdvic_doc_close finishes the output and frees the document. opt must stay
+ * valid until then.
+ */
+struct MdvicDoc;
+struct MdvicDoc *mdvic_doc_open(FILE *in, FILE *out, const struct MdvicOptions *opt, const char *filename);
+int mdvic_doc_render_next(struct MdvicDoc *doc);
+void mdvic_doc_close(struct MdvicDoc *doc);
+
+/* Width-independent rendering. A document opened with mdvic_doc_open_ir
+ * renders into ir: styled text runs with their display widths, line
+ * prefixes, code lines and table cells. mdvic_layout then turns ir into
+ * terminal output for any width in one pass, without parsing or math, so a
+ * resize costs only layout. The options are copied into ir; their width
+ * and wrap settings are ignored. The IR must outlive its documents and
+ * layouts.
+ */
+struct MdvicIr;
+struct MdvicIr *mdvic_ir_new(const struct MdvicOptions *opt);
+void mdvic_ir_free(struct MdvicIr *ir);
+struct MdvicDoc *mdvic_doc_open_ir(FILE *in, struct MdvicIr *ir, const char *filename);
+
+/* Lay out all of ir at width (0 = no wrapping) to out. */
+int mdvic_layout(const struct MdvicIr *ir, int width, FILE *out);
+
+/* Incremental layout: each mdvic_layout_run lays out what was recorded
+ * since the previous call; mdvic_layout_free finishes the output.
+ */
+struct MdvicLayout;
+struct MdvicLayout *mdvic_layout_new(const struct MdvicIr *ir, int width, FILE *out);
+void mdvic_layout_run(struct MdvicLayout *lay);
+void mdvic_layout_free(struct MdvicLayout *lay);
+
+/* Lay out all of ir into a cell grid of width columns (see grid.h), for
+ * embedding in TUIs. Returns NULL when out of memory.
+ */
+struct MdvicGrid;
+struct MdvicGrid *mdvic_layout_grid(const struct MdvicIr *ir, int width);
+
+/* Page one input on the terminal, rendering blocks as they come into view.
+ * Returns 0 when the user leaves the document, 1 when they ask to quit
+ * entirely, and -1 if the terminal cannot be used (nothing was shown).
+ */
+int mdvic_pager(FILE *in, const struct MdvicOptions *opt, const char *filename);
+
 #endif /* MDVIC_MDVIC_H */
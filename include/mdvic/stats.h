@@ -0,0 +1,48 @@
+#ifndef MDVIC_STATS_H
+#define MDVIC_STATS_H
+
+#include <stdio.h>
+
+/*
+ * Counters for --stats. The renderer adds to a struct MdvicStats when
+ * MdvicOptions.stats points at one; otherwise each counting site costs one
+ * NULL test. Write time is what the renderer spends handing output to
+ * stdio, so it is taken out of render time rather than overlapping it.
+ */
+
+enum mdvic_phase {
+    MDVIC_PHASE_READ,
+    MDVIC_PHASE_LINT,   /* on its own thread for large documents, overlapping parse */
+    MDVIC_PHASE_PARSE,  /* math extraction and cmark */
+    MDVIC_PHASE_RENDER,
+    MDVIC_PHASE_WRITE,
+    MDVIC_PHASE_COUNT
+};
+
+struct MdvicStats {
+    unsigned long long phase_ns[MDVIC_PHASE_COUNT];
+    unsigned long files;
+    unsigned long long input_bytes;
+    unsigned long long output_bytes; /* everything written, escapes included */
+    unsigned long long escape_bytes; /* SGR and OSC 8 sequences */
+    unsigned long math_spans;        /* spans rendered, cache hits included */
+    unsigned long table_cells;       /* header and body cells laid out */
+    /* filled in by the program before printing */
+    unsigned long long wall_ns;
+    int have_allocs; unsigned long long allocs, alloc_bytes;
+    long peak_rss_kib;               /* < 0 when unknown */
+};
+
+/* Monotonic clock in nanoseconds. */
+unsigned long long mdvic_stats_now(void);
+
+/* Heap allocations made by the process so far: malloc, calloc and realloc
+ * calls and the bytes they asked for. Counted by allocator hooks in
+ * src/allocstats.c, which programs link (mdvic and the benchmark); returns
+ * 0 where the hooks are unavailable (not glibc, or under a sanitizer). */
+int mdvic_alloc_stats(unsigned long long *count, unsigned long long *bytes);
+
+/* The breakdown printed by --stats. */
+void mdvic_stats_print(FILE *err, const struct MdvicStats *s);
+
+#endif /* MDVIC_STATS_H */
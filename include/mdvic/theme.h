@@ -0,0 +1,83 @@
+#ifndef MDVIC_THEME_H
+#define MDVIC_THEME_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+ * Themes map document elements to terminal attributes. A theme file has one
+ * setting per line:
+ *
+ *   # comment
+ *   h1           = bold fg=#ff5f5f
+ *   code         = fg=180 bg=236
+ *   link         = underline fg=bright-blue
+ *   table-border = dim
+ *
+ * Attributes: bold dim italic underline inverse, fg=COLOR, bg=COLOR, or
+ * "plain". COLOR is a name (black red green yellow blue magenta cyan white,
+ * bright-<name>, default), a 256-colour index, or #rrggbb. A setting replaces
+ * the element's built-in style; "heading" sets h1..h6 at once.
+ *
+ * mdvic_theme_compile resolves colours for the terminal's depth once, so the
+ * renderer only concatenates prepared SGR parameters.
+ */
+
+enum mdvic_theme_el {
+    MDVIC_EL_H1, MDVIC_EL_H2, MDVIC_EL_H3, MDVIC_EL_H4, MDVIC_EL_H5, MDVIC_EL_H6,
+    MDVIC_EL_STRONG, MDVIC_EL_EMPH, MDVIC_EL_CODE, MDVIC_EL_CODE_BLOCK,
+    MDVIC_EL_LINK, MDVIC_EL_QUOTE, MDVIC_EL_TABLE_BORDER, MDVIC_EL_TABLE_HEADER,
+    MDVIC_EL_MATH,
+    /* code block syntax highlighting */
+    MDVIC_EL_CODE_KEYWORD, MDVIC_EL_CODE_TYPE, MDVIC_EL_CODE_LITERAL, MDVIC_EL_CODE_STRING,
+    MDVIC_EL_CODE_NUMBER, MDVIC_EL_CODE_COMMENT, MDVIC_EL_CODE_PREPROC,
+    MDVIC_EL_COUNT
+};
+
+#define MDVIC_ATTR_BOLD      1u
+#define MDVIC_ATTR_DIM       2u
+#define MDVIC_ATTR_ITALIC    4u
+#define MDVIC_ATTR_UNDERLINE 8u
+#define MDVIC_ATTR_INVERSE   16u
+
+enum mdvic_color_kind { MDVIC_COLOR_NONE, MDVIC_COLOR_16, MDVIC_COLOR_256, MDVIC_COLOR_RGB };
+
+struct MdvicColor {
+    unsigned char kind;    /* enum mdvic_color_kind */
+    unsigned char r, g, b; /* r holds the index for 16/256 colours */
+};
+
+struct MdvicThemeStyle {
+    unsigned attrs; /* MDVIC_ATTR_* */
+    struct MdvicColor fg, bg;
+};
+
+/* Colour depth of the output terminal. */
+enum mdvic_color_depth { MDVIC_DEPTH_16 = 16, MDVIC_DEPTH_256 = 256, MDVIC_DEPTH_TRUE = 24 };
+
+struct MdvicTheme {
+    struct MdvicThemeStyle el[MDVIC_EL_COUNT];
+    /* compiled by mdvic_theme_compile */
+    int depth;
+    char fg_sgr[MDVIC_EL_COUNT][20]; /* e.g. "38;5;203"; empty when unset */
+    char bg_sgr[MDVIC_EL_COUNT][20];
+};
+
+/* Built-in theme (the classic 8-colour headings), compiled for depth. */
+void mdvic_theme_default(struct MdvicTheme *t);
+
+/* Apply settings from text on top of t. Problems are reported to err as
+ * name:line: message. Returns 0 on success, -1 if any line was rejected.
+ */
+int mdvic_theme_parse(struct MdvicTheme *t, const char *text, size_t len, const char *name, FILE *err);
+
+/* Read and apply a theme file. Returns 0 on success. */
+int mdvic_theme_load(struct MdvicTheme *t, const char *path, FILE *err);
+
+/* Resolve every element's colours for depth into SGR parameter strings. */
+void mdvic_theme_compile(struct MdvicTheme *t, int depth);
+
+/* MDVIC_COLORS (16|256|truecolor), then COLORTERM and TERM. */
+int mdvic_detect_color_depth(void);
+
+#endif /* MDVIC_THEME_H */
@@ -0,0 +1,41 @@
+#ifndef MDVIC_TRACE_H
+#define MDVIC_TRACE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+ * --trace: per-block timings as Chrome trace-event JSON, which Perfetto and
+ * chrome://tracing load directly. The renderer records one complete event per
+ * top-level block, per table and per math span when MdvicOptions.trace points
+ * at a trace; spans on one thread nest by time, so a slow equation shows
+ * inside its paragraph. Each event carries the file, source lines and byte
+ * range in its args. Events are written as they end, all from the thread
+ * that renders.
+ */
+
+struct MdvicTrace;
+
+#define MDVIC_TRACE_TID_MAIN 1
+#define MDVIC_TRACE_TID_LINT 2 /* buffer lint on its own thread */
+
+struct MdvicTraceSpan {
+    const char *name;
+    const char *file;        /* NULL for none */
+    int tid;
+    unsigned long long start_ns, end_ns; /* mdvic_stats_now() clock */
+    int line, end_line;      /* 1-based source lines; 0 when not tied to a line */
+    int has_range;
+    size_t off, len;         /* bytes of the normalised input */
+};
+
+/* Start a trace on f, which stays owned by the caller. Timestamps are
+ * relative to this call. Returns NULL when out of memory. */
+struct MdvicTrace *mdvic_trace_new(FILE *f);
+
+void mdvic_trace_span(struct MdvicTrace *t, const struct MdvicTraceSpan *sp);
+
+/* Close the JSON and free t. Returns 0, or -1 if any write failed. */
+int mdvic_trace_finish(struct MdvicTrace *t);
+
+#endif /* MDVIC_TRACE_H */
@@ -0,0 +1,66 @@
+#ifndef MDVIC_UTF8_H
+#define MDVIC_UTF8_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* What input bytes are read as. AUTO and UTF16 follow a byte order mark;
+ * without one, AUTO means UTF-8 and UTF16 means little-endian. */
+enum mdvic_input_encoding {
+    MDVIC_INPUT_AUTO = 0,
+    MDVIC_INPUT_UTF8,
+    MDVIC_INPUT_UTF16,
+    MDVIC_INPUT_UTF16LE,
+    MDVIC_INPUT_UTF16BE,
+    MDVIC_INPUT_LATIN1
+};
+
+/* Parse "auto", "utf-8", "utf-16", "utf-16le", "utf-16be" or "latin-1"
+ * (also "utf8", "utf16", "utf16le", "utf16be", "latin1", "iso-8859-1"),
+ * ignoring case. Returns 0 on success. */
+int mdvic_parse_input_encoding(const char *name, enum mdvic_input_encoding *enc);
+
+/* Read all of in as enc and return it malloc'ed in *data, as UTF-8 and
+ * normalised as below; *raw_len (if not NULL) gets the bytes read. Other
+ * encodings are transcoded in fixed-size chunks as they are read, so only
+ * the UTF-8 text is ever held whole. Returns 0, or -1 with errno set. */
+int mdvic_read_input(FILE *in, enum mdvic_input_encoding enc, char **data, size_t *len, size_t *raw_len);
+
+/* Upper bound on what mdvic_transcode writes for n input bytes. */
+#define MDVIC_TRANSCODE_BOUND(n) (2 * (n) + 3)
+
+/* Transcode n bytes of UTF-16LE, UTF-16BE or Latin-1 (any other enc is
+ * copied) to UTF-8 in out, which has room for MDVIC_TRANSCODE_BOUND(n)
+ * bytes. Unpaired surrogates become U+FFFD. Unless last is set, a trailing
+ * odd byte or high surrogate is left for the next call: *used is the bytes
+ * consumed. Returns the bytes written. No BOM handling. */
+size_t mdvic_transcode(enum mdvic_input_encoding enc, const char *in, size_t n, int last, char *out, size_t *used);
+
+/*
+ * Input normalisation, run once on every document before lint and parse.
+ * mdvic_utf8_normalize makes the text valid UTF-8 with LF line ends:
+ * - a leading byte order mark is dropped;
+ * - CRLF and lone CR become LF;
+ * - each invalid sequence (its maximal subpart, as Unicode recommends) and
+ *   each NUL becomes U+FFFD.
+ * After it, lint, cmark and the renderer see the same characters and the
+ * same line numbers, and code that decodes the text can skip validation.
+ * Clean input is only read, 16 bytes at a time where SSE2 is available.
+ */
+
+/* *buf is malloc'ed and *cap bytes large. It is rewritten in place, and
+ * grown by realloc when replacements make the text longer. Returns 0, or -1
+ * when out of memory, leaving the buffer as it was. */
+int mdvic_utf8_normalize(char **buf, size_t *len, size_t *cap);
+
+/* Decode the code point at s, which must be valid UTF-8, and return its
+ * length in bytes. No checks: use it on normalised text only. */
+size_t mdvic_utf8_decode(const char *s, uint32_t *cp);
+
+/* Write s to out as a JSON string literal: quotes, backslashes and control
+ * characters escaped, invalid sequences replaced by U+FFFD as above. For
+ * paths and messages, which are not normalised. */
+void mdvic_json_string(FILE *out, const char *s);
+
+#endif /* MDVIC_UTF8_H */
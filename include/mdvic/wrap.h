@@ -11,6 +11,23 @@
  * - Treats newline as hard break and resets column.
  * - Simple greedy wrapping may break in the middle of words.
  */
+/* Prefixes for mdvic_wrap_write_prefix: "first" starts a write that begins at
+ * column 0, "next" follows every newline and wrap. Widths are in columns.
+ */
+struct MdvicWrapPrefix {
+    const char *first; size_t first_len; int first_width;
+    const char *next;  size_t next_len;  int next_width;
+};
+
+int mdvic_wrap_write_prefix(FILE *out, const char *s, size_t len, int width, int *col,
+                            const struct MdvicWrapPrefix *pfx);
+
+/* Same, with output going to sink (which returns 0 on success). */
+typedef int (*mdvic_wrap_sink_fn)(void *ctx, const char *s, size_t len);
+int mdvic_wrap_emit(mdvic_wrap_sink_fn sink, void *ctx, const char *s, size_t len, int width, int *col,
+                    const struct MdvicWrapPrefix *pfx);
+
+/* Byte-counted prefixes (each byte is taken as one column). */
 int mdvic_wrap_write_pref2(FILE *out, const char *s, size_t len, int width, int *col,
                            const char *prefix_first, int prefix_first_len,
                            const char *prefix_next, int prefix_next_len);
@@ -0,0 +1,54 @@
+/* Counting allocator hooks for --stats and make bench. Programs link them;
+ * they are not part of the library.
+ *
+ * glibc lets a program replace malloc, calloc, realloc and free for every
+ * caller in the process, libcmark included. The replacements bump two
+ * relaxed atomic counters and forward to glibc's own allocator, which costs
+ * a few nanoseconds per call, so they are always on. Sanitizers bring their
+ * own allocator, and other C libraries offer no forwarding entry points;
+ * there the counters are absent. Define MDVIC_NO_ALLOC_STATS to leave them
+ * out.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "mdvic/stats.h"
+
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define MDVIC_NO_ALLOC_STATS 1
+#endif
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define MDVIC_NO_ALLOC_STATS 1
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(MDVIC_NO_ALLOC_STATS)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *p, size_t size);
+extern void __libc_free(void *p);
+
+static unsigned long long n_allocs, n_bytes;
+
+static void count(size_t size) {
+    __atomic_fetch_add(&n_allocs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&n_bytes, (unsigned long long)size, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size) { count(size); return __libc_malloc(size); }
+void *calloc(size_t n, size_t size) { count(n * size); return __libc_calloc(n, size); }
+void *realloc(void *p, size_t size) { count(size); return __libc_realloc(p, size); }
+void free(void *p) { __libc_free(p); }
+
+int mdvic_alloc_stats(unsigned long long *count_out, unsigned long long *bytes_out) {
+    *count_out = __atomic_load_n(&n_allocs, __ATOMIC_RELAXED);
+    *bytes_out = __atomic_load_n(&n_bytes, __ATOMIC_RELAXED);
+    return 1;
+}
+#else
+int mdvic_alloc_stats(unsigned long long *count_out, unsigned long long *bytes_out) {
+    *count_out = 0; *bytes_out = 0;
+    return 0;
+}
+#endif
@@ -0,0 +1,284 @@
+/* Cell-grid output: fed by the layout pass, written as binary or text. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mdvic/grid.h"
+#include "mdvic/wcwidth.h"
+
+static const struct MdvicCell blank_cell = { ' ', 0, 1, 0, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 };
+
+struct MdvicGrid *mdvic_grid_new(int width) {
+    struct MdvicGrid *g = (struct MdvicGrid *)calloc(1, sizeof(*g));
+    if (!g) return NULL;
+    g->width = width > 0 ? width : 1;
+    g->pen = blank_cell;
+    return g;
+}
+
+void mdvic_grid_free(struct MdvicGrid *g) {
+    if (!g) return;
+    for (size_t i = 0; i < g->nlinks; i++) free(g->links[i]);
+    free(g->links); free(g->cells); free(g->tails); free(g);
+}
+
+/* Make row r exist, blank. */
+static int ensure_row(struct MdvicGrid *g, size_t r) {
+    if (r < g->rows) return 0;
+    if (r >= g->row_cap) {
+        size_t ncap = g->row_cap ? g->row_cap * 2 : 64;
+        while (ncap <= r) ncap *= 2;
+        struct MdvicCell *nc = (struct MdvicCell *)realloc(g->cells, ncap * (size_t)g->width * sizeof(*nc));
+        if (!nc) return -1;
+        g->cells = nc; g->row_cap = ncap;
+    }
+    for (size_t i = g->rows * (size_t)g->width; i < (r + 1) * (size_t)g->width; i++) g->cells[i] = blank_cell;
+    g->rows = r + 1;
+    return 0;
+}
+
+void mdvic_grid_set_style(struct MdvicGrid *g, unsigned attrs, const struct MdvicColor *fg, const struct MdvicColor *bg) {
+    g->pen.attrs = (unsigned char)attrs;
+    g->pen.fg = fg ? *fg : blank_cell.fg;
+    g->pen.bg = bg ? *bg : blank_cell.bg;
+}
+
+void mdvic_grid_set_link(struct MdvicGrid *g, const char *url) {
+    if (!url || !url[0]) { g->pen.link = 0; return; }
+    for (size_t i = g->nlinks; i-- > 0; ) {
+        if (strcmp(g->links[i], url) == 0) { g->pen.link = (uint16_t)(i + 1); return; }
+    }
+    if (g->nlinks >= 0xFFFF) return;
+    if (g->nlinks == g->links_cap) {
+        size_t ncap = g->links_cap ? g->links_cap * 2 : 8;
+        char **nl = (char **)realloc(g->links, ncap * sizeof(*nl));
+        if (!nl) return;
+        g->links = nl; g->links_cap = ncap;
+    }
+    char *dup = strdup(url);
+    if (!dup) return;
+    g->links[g->nlinks++] = dup;
+    g->pen.link = (uint16_t)g->nlinks;
+}
+
+/* Append a combining mark to cell c's tail. A tail that is not the last
+ * one in g->tails is moved to the end first. */
+static void add_tail(struct MdvicGrid *g, struct MdvicCell *c, const char *s, size_t n) {
+    size_t old = c->tail ? c->tail - 1 : 0;
+    size_t keep = c->tail ? strlen(g->tails + old) : 0;
+    int last = c->tail && old + keep + 1 == g->tails_len;
+    size_t start = last ? old : g->tails_len;
+    size_t need = start + keep + n + 1;
+    if (need > g->tails_cap) {
+        size_t ncap = g->tails_cap ? g->tails_cap * 2 : 256;
+        while (ncap < need) ncap *= 2;
+        char *nt = (char *)realloc(g->tails, ncap);
+        if (!nt) return;
+        g->tails = nt; g->tails_cap = ncap;
+    }
+    if (!last && keep) memmove(g->tails + start, g->tails + old, keep);
+    memcpy(g->tails + start + keep, s, n);
+    g->tails[need - 1] = '\0';
+    g->tails_len = need;
+    c->tail = (uint32_t)start + 1;
+}
+
+static size_t decode(const char *s, size_t len, uint32_t *cp) {
+    unsigned char c = (unsigned char)s[0];
+    size_t n = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 0;
+    if (n == 0 || n > len) { *cp = 0xFFFD; return 1; }
+    uint32_t v = n == 1 ? c : (uint32_t)(c & (0x7F >> n));
+    for (size_t k = 1; k < n; k++) {
+        if (((unsigned char)s[k] & 0xC0) != 0x80) { *cp = 0xFFFD; return 1; }
+        v = (v << 6) | ((unsigned char)s[k] & 0x3Fu);
+    }
+    *cp = v;
+    return n;
+}
+
+/* Place text at the cursor; '\n' starts the next row. Escape sequences are
+ * skipped and characters past the right edge are dropped. */
+void mdvic_grid_put(struct MdvicGrid *g, const char *s, size_t len) {
+    size_t row = g->rows ? g->rows - 1 : 0;
+    if (ensure_row(g, row) != 0) return;
+    /* the cursor row is always the last one */
+    for (size_t i = 0; i < len; ) {
+        unsigned char ch = (unsigned char)s[i];
+        if (ch == '\n') {
+            row++; g->col = 0;
+            if (ensure_row(g, row) != 0) return;
+            i++; continue;
+        }
+        if (ch == 0x1B) {
+            size_t j = i + 1;
+            if (j < len && s[j] == '[') { j++; while (j < len && !((unsigned char)s[j] >= 0x40 && (unsigned char)s[j] <= 0x7E)) j++; j++; }
+            else if (j < len && s[j] == ']') { while (j < len && s[j] != 0x07 && !(s[j] == 0x1B && j + 1 < len && s[j + 1] == '\\')) j++; j += (j < len && s[j] == 0x1B) ? 2 : 1; }
+            else j++;
+            i = j < len ? j : len;
+            continue;
+        }
+        uint32_t cp; size_t n = decode(s + i, len - i, &cp);
+        i += n;
+        if (cp < 0x20 || (cp >= 0x7F && cp < 0xA0)) continue;
+        int w = mdvic_wcwidth(cp);
+        struct MdvicCell *line = g->cells + row * (size_t)g->width;
+        if (w == 0) {
+            int at = g->col - 1;
+            if (at >= 0 && at < g->width && line[at].width == 0 && at > 0) at--;
+            if (at >= 0 && at < g->width) add_tail(g, &line[at], s + i - n, n);
+            continue;
+        }
+        if (g->col + w <= g->width) {
+            struct MdvicCell c = g->pen;
+            c.cp = cp; c.width = (unsigned char)w; c.tail = 0;
+            line[g->col] = c;
+            if (w == 2) { c.cp = 0; c.width = 0; line[g->col + 1] = c; }
+        }
+        g->col += w;
+    }
+}
+
+void mdvic_grid_finish(struct MdvicGrid *g) {
+    /* the row after the final newline is empty */
+    if (g->rows && g->col == 0) g->rows--;
+}
+
+/* ---- output ---- */
+
+static int cell_is_blank(const struct MdvicCell *c) {
+    return c->cp == ' ' && c->tail == 0 && c->attrs == 0 && c->link == 0 &&
+           c->fg.kind == MDVIC_COLOR_NONE && c->bg.kind == MDVIC_COLOR_NONE;
+}
+
+static int same_style(const struct MdvicCell *a, const struct MdvicCell *b) {
+    return a->attrs == b->attrs && memcmp(&a->fg, &b->fg, sizeof(a->fg)) == 0 && memcmp(&a->bg, &b->bg, sizeof(a->bg)) == 0;
+}
+
+/* Cells in use in row r: up to the last non-blank one. */
+static int row_used(const struct MdvicGrid *g, size_t r) {
+    const struct MdvicCell *line = g->cells + r * (size_t)g->width;
+    int n = g->width;
+    while (n > 0 && cell_is_blank(&line[n - 1])) n--;
+    return n;
+}
+
+/* Distinct styles in use, in order of first appearance. */
+struct StyleTable { struct MdvicCell *s; size_t n, cap; };
+
+static int style_index(struct StyleTable *t, const struct MdvicCell *c) {
+    for (size_t i = 0; i < t->n; i++) if (same_style(&t->s[i], c)) return (int)i;
+    if (t->n == t->cap) {
+        size_t ncap = t->cap ? t->cap * 2 : 16;
+        struct MdvicCell *ns = (struct MdvicCell *)realloc(t->s, ncap * sizeof(*ns));
+        if (!ns) return 0;
+        t->s = ns; t->cap = ncap;
+    }
+    t->s[t->n] = *c;
+    return (int)t->n++;
+}
+
+static void put_u8(FILE *out, unsigned v) { fputc((int)(v & 0xFF), out); }
+static void put_u16(FILE *out, unsigned v) { put_u8(out, v); put_u8(out, v >> 8); }
+static void put_u32(FILE *out, uint32_t v) { put_u16(out, v & 0xFFFF); put_u16(out, v >> 16); }
+static void put_color(FILE *out, const struct MdvicColor *c) { put_u8(out, c->kind); put_u8(out, c->r); put_u8(out, c->g); put_u8(out, c->b); }
+
+int mdvic_grid_write_binary(const struct MdvicGrid *g, FILE *out) {
+    struct StyleTable st = { NULL, 0, 0 };
+    struct MdvicCell plain = blank_cell;
+    (void)style_index(&st, &plain);
+    for (size_t i = 0; i < g->rows * (size_t)g->width; i++) (void)style_index(&st, &g->cells[i]);
+
+    fwrite("MDVG", 1, 4, out);
+    put_u8(out, 1); put_u16(out, (unsigned)g->width); put_u32(out, (uint32_t)g->rows);
+    put_u32(out, (uint32_t)g->nlinks);
+    for (size_t i = 0; i < g->nlinks; i++) {
+        size_t n = strlen(g->links[i]);
+        put_u32(out, (uint32_t)n); fwrite(g->links[i], 1, n, out);
+    }
+    put_u32(out, (uint32_t)st.n);
+    for (size_t i = 0; i < st.n; i++) { put_u8(out, st.s[i].attrs); put_color(out, &st.s[i].fg); put_color(out, &st.s[i].bg); }
+    for (size_t r = 0; r < g->rows; r++) {
+        const struct MdvicCell *line = g->cells + r * (size_t)g->width;
+        int used = row_used(g, r);
+        unsigned nruns = 0;
+        for (int c = 0; c < used; c++) if (c == 0 || !same_style(&line[c], &line[c - 1]) || line[c].link != line[c - 1].link) nruns++;
+        put_u16(out, nruns);
+        for (int c = 0; c < used; ) {
+            int e = c + 1;
+            while (e < used && same_style(&line[e], &line[c]) && line[e].link == line[c].link) e++;
+            put_u16(out, (unsigned)style_index(&st, &line[c])); put_u16(out, line[c].link); put_u16(out, (unsigned)(e - c));
+            for (; c < e; c++) {
+                const struct MdvicCell *cell = &line[c];
+                const char *tail = cell->tail ? g->tails + cell->tail - 1 : NULL;
+                size_t tn = tail ? strlen(tail) : 0;
+                if (tn > 255) tn = 255;
+                put_u32(out, cell->cp | (uint32_t)cell->width << 21 | (uint32_t)(tail != NULL) << 23);
+                if (tail) { put_u8(out, (unsigned)tn); fwrite(tail, 1, tn, out); }
+            }
+        }
+    }
+    free(st.s);
+    return ferror(out) ? -1 : 0;
+}
+
+static void put_utf8(FILE *out, uint32_t cp) {
+    char b[4]; size_t n;
+    if (cp < 0x80) { b[0] = (char)cp; n = 1; }
+    else if (cp < 0x800) { b[0] = (char)(0xC0 | cp >> 6); b[1] = (char)(0x80 | (cp & 0x3F)); n = 2; }
+    else if (cp < 0x10000) { b[0] = (char)(0xE0 | cp >> 12); b[1] = (char)(0x80 | (cp >> 6 & 0x3F)); b[2] = (char)(0x80 | (cp & 0x3F)); n = 3; }
+    else { b[0] = (char)(0xF0 | cp >> 18); b[1] = (char)(0x80 | (cp >> 12 & 0x3F)); b[2] = (char)(0x80 | (cp >> 6 & 0x3F)); b[3] = (char)(0x80 | (cp & 0x3F)); n = 4; }
+    fwrite(b, 1, n, out);
+}
+
+static void write_color(FILE *out, const char *name, const struct MdvicColor *c) {
+    if (c->kind == MDVIC_COLOR_16) fprintf(out, " %s=c%d", name, c->r);
+    else if (c->kind == MDVIC_COLOR_256) fprintf(out, " %s=%d", name, c->r);
+    else if (c->kind == MDVIC_COLOR_RGB) fprintf(out, " %s=#%02x%02x%02x", name, c->r, c->g, c->b);
+}
+
+int mdvic_grid_write_text(const struct MdvicGrid *g, FILE *out) {
+    static const char letters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    /* letters name (style, link) pairs in order of first appearance */
+    struct MdvicCell keys[sizeof(letters) - 1];
+    size_t nkeys = 0;
+    fprintf(out, "grid %dx%zu\n", g->width, g->rows);
+    for (size_t r = 0; r < g->rows; r++) {
+        const struct MdvicCell *line = g->cells + r * (size_t)g->width;
+        int used = row_used(g, r), styled = 0;
+        fprintf(out, "%4zu|", r + 1);
+        for (int c = 0; c < used; c++) {
+            if (line[c].width == 0) continue;
+            put_utf8(out, line[c].cp);
+            if (line[c].tail) fputs(g->tails + line[c].tail - 1, out);
+            if (line[c].attrs || line[c].link || line[c].fg.kind || line[c].bg.kind) styled = 1;
+        }
+        fputc('\n', out);
+        if (!styled) continue;
+        fputs("    |", out);
+        int last = used;
+        while (last > 0 && !(line[last - 1].attrs || line[last - 1].link || line[last - 1].fg.kind || line[last - 1].bg.kind)) last--;
+        for (int c = 0; c < last; c++) {
+            const struct MdvicCell *cell = &line[c];
+            if (!(cell->attrs || cell->link || cell->fg.kind || cell->bg.kind)) { fputc(' ', out); continue; }
+            size_t k = 0;
+            while (k < nkeys && !(same_style(&keys[k], cell) && keys[k].link == cell->link)) k++;
+            if (k == nkeys && nkeys < sizeof(keys) / sizeof(keys[0])) keys[nkeys++] = *cell;
+            fputc(k < nkeys ? letters[k] : '?', out);
+        }
+        fputc('\n', out);
+    }
+    if (nkeys) fputs("styles:\n", out);
+    for (size_t k = 0; k < nkeys; k++) {
+        static const char *names[5] = {"bold", "dim", "italic", "underline", "inverse"};
+        fprintf(out, "  %c", letters[k]);
+        for (int a = 0; a < 5; a++) if (keys[k].attrs & (1u << a)) fprintf(out, " %s", names[a]);
+        write_color(out, "fg", &keys[k].fg);
+        write_color(out, "bg", &keys[k].bg);
+        if (keys[k].link) fprintf(out, " link=%s", g->links[keys[k].link - 1]);
+        fputc('\n', out);
+    }
+    return ferror(out) ? -1 : 0;
+}
@@ -0,0 +1,239 @@
+/* Table-driven code block highlighter: see include/mdvic/highlight.h. */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "mdvic/highlight.h"
+
+struct MdvicHlWord { const char *word; unsigned char len; unsigned char kind; };
+
+struct MdvicHlKeywords {
+    const struct MdvicHlWord *words;
+    const unsigned char *slots;
+    unsigned size;
+    uint32_t mul;
+    unsigned char min_len, max_len;
+};
+
+#include "mdvic/hl_keywords.h"
+
+/* Language syntax flags */
+#define HL_SLASH_COMMENTS 0x001u /* // and block comments */
+#define HL_HASH_COMMENTS  0x002u /* # anywhere outside a string */
+#define HL_HASH_WORD      0x004u /* # only at the start of a word */
+#define HL_PREPROC_LINES  0x008u /* # as first non-blank starts a directive */
+#define HL_DECORATORS     0x010u /* @name at the start of a line */
+#define HL_TRIPLE_QUOTES  0x020u /* """ and ''' strings span lines */
+#define HL_STRING_PREFIX  0x040u /* r"", b'', f"" */
+#define HL_MULTILINE_STR  0x080u /* every string may span lines */
+#define HL_RAW_SINGLE     0x100u /* no escapes inside '...' */
+#define HL_VARIABLES      0x200u /* $name, ${name}, $? */
+#define HL_KEYS           0x400u /* "key": and bare key: are names */
+#define HL_SIGNED_NUMBERS 0x800u /* -1 is one number */
+
+struct MdvicHlLang {
+    const char *aliases;   /* space-separated, lower case */
+    const struct MdvicHlKeywords *kw;
+    const char *quotes;
+    const char *word_extra; /* bytes that continue a word besides [A-Za-z0-9_] */
+    unsigned flags;
+};
+
+static const struct MdvicHlLang langs[] = {
+    { "c h cpp c++ cc cxx hpp hxx objc", &mdvic_hl_c_keywords, "\"'", "",
+      HL_SLASH_COMMENTS | HL_PREPROC_LINES },
+    { "sh bash shell zsh ksh dash", &mdvic_hl_sh_keywords, "\"'`", "-./",
+      HL_HASH_WORD | HL_MULTILINE_STR | HL_RAW_SINGLE | HL_VARIABLES },
+    { "python py python3 py3", &mdvic_hl_python_keywords, "\"'", "",
+      HL_HASH_COMMENTS | HL_DECORATORS | HL_TRIPLE_QUOTES | HL_STRING_PREFIX },
+    { "json jsonc json5", &mdvic_hl_json_keywords, "\"'", "",
+      HL_SLASH_COMMENTS | HL_KEYS | HL_SIGNED_NUMBERS },
+    { "yaml yml", &mdvic_hl_yaml_keywords, "\"'", "-./",
+      HL_HASH_WORD | HL_RAW_SINGLE | HL_KEYS | HL_SIGNED_NUMBERS },
+};
+
+enum { MODE_CODE, MODE_COMMENT, MODE_STRING, MODE_TRIPLE };
+
+const struct MdvicHlLang *mdvic_hl_find(const char *info) {
+    if (!info) return NULL;
+    while (*info == ' ' || *info == '\t' || *info == '{' || *info == '.') info++;
+    size_t n = 0;
+    while (info[n] && info[n] != ' ' && info[n] != '\t' && info[n] != ',' && info[n] != '}' && info[n] != '{') n++;
+    if (n == 0 || n > 15) return NULL;
+    char name[16];
+    for (size_t i = 0; i < n; i++) { char c = info[i]; name[i] = (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c; }
+    for (size_t l = 0; l < sizeof(langs) / sizeof(langs[0]); l++) {
+        for (const char *a = langs[l].aliases; *a; ) {
+            size_t an = strcspn(a, " ");
+            if (an == n && memcmp(a, name, n) == 0) return &langs[l];
+            a += an; while (*a == ' ') a++;
+        }
+    }
+    return NULL;
+}
+
+static int kw_lookup(const struct MdvicHlKeywords *kw, const char *s, size_t n) {
+    if (n < kw->min_len || n > kw->max_len) return MDVIC_HL_PLAIN;
+    uint32_t h = (uint32_t)n;
+    for (size_t i = 0; i < n; i++) h = (h * kw->mul + (unsigned char)s[i]) % 65521u;
+    unsigned idx = kw->slots[h % kw->size];
+    if (idx == 0) return MDVIC_HL_PLAIN;
+    const struct MdvicHlWord *w = &kw->words[idx - 1];
+    return (w->len == n && memcmp(w->word, s, n) == 0) ? w->kind : MDVIC_HL_PLAIN;
+}
+
+static int is_word_start(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+}
+
+static int is_digit(unsigned char c) { return c >= '0' && c <= '9'; }
+
+static int is_word(const struct MdvicHlLang *lang, unsigned char c) {
+    return is_word_start(c) || is_digit(c) || (c && strchr(lang->word_extra, c) != NULL);
+}
+
+/* Runs are extended until the kind changes, then handed to emit. */
+struct Lexer {
+    const char *s; size_t len;
+    int kind; size_t start;
+    mdvic_hl_emit_fn emit; void *ctx;
+};
+
+static void lx_mark(struct Lexer *lx, size_t at, int kind) {
+    if (kind == lx->kind) return;
+    if (at > lx->start) lx->emit(lx->ctx, lx->kind, lx->s + lx->start, at - lx->start);
+    lx->start = at; lx->kind = kind;
+}
+
+/* End of the block comment opened before i, or len if it stays open. */
+static size_t scan_comment(const char *s, size_t len, size_t i, int *closed) {
+    for (; i + 1 < len; i++) if (s[i] == '*' && s[i + 1] == '/') { *closed = 1; return i + 2; }
+    *closed = 0; return len;
+}
+
+/* End of the string opened before i by quote q (three of them if triple). */
+static size_t scan_string(const struct MdvicHlLang *lang, const char *s, size_t len, size_t i,
+                          char q, int triple, int *closed) {
+    int escapes = !(q == '\'' && (lang->flags & HL_RAW_SINGLE));
+    while (i < len) {
+        char c = s[i];
+        if (c == '\\' && escapes) { i += 2; continue; }
+        if (c == q) {
+            if (!triple) { *closed = 1; return i + 1; }
+            if (i + 2 < len && s[i + 1] == q && s[i + 2] == q) { *closed = 1; return i + 3; }
+        }
+        i++;
+    }
+    *closed = 0; return len;
+}
+
+static size_t skip_blanks(const char *s, size_t len, size_t i) {
+    while (i < len && (s[i] == ' ' || s[i] == '\t')) i++;
+    return i;
+}
+
+void mdvic_hl_line(const struct MdvicHlLang *lang, struct MdvicHlState *st,
+                   const char *s, size_t len, mdvic_hl_emit_fn emit, void *ctx) {
+    struct Lexer lx = { s, len, MDVIC_HL_PLAIN, 0, emit, ctx };
+    unsigned fl = lang->flags;
+    size_t i = 0;
+    int closed;
+
+    /* finish what the previous line left open */
+    if (st->mode == MODE_COMMENT) {
+        lx.kind = MDVIC_HL_COMMENT;
+        i = scan_comment(s, len, 0, &closed);
+        if (closed) st->mode = MODE_CODE;
+    } else if (st->mode == MODE_STRING || st->mode == MODE_TRIPLE) {
+        lx.kind = MDVIC_HL_STRING;
+        i = scan_string(lang, s, len, 0, (char)st->quote, st->mode == MODE_TRIPLE, &closed);
+        if (closed) st->mode = MODE_CODE;
+    }
+    if (st->mode != MODE_CODE) { lx_mark(&lx, len, -1); return; }
+
+    size_t first = skip_blanks(s, len, 0);
+    while (i < len) {
+        unsigned char c = (unsigned char)s[i];
+        size_t j;
+        if (i == first && ((c == '#' && (fl & HL_PREPROC_LINES)) || (c == '@' && (fl & HL_DECORATORS)))) {
+            int kind = MDVIC_HL_PREPROC;
+            lx_mark(&lx, i, kind);
+            if (c == '@') {
+                for (j = i + 1; j < len && (is_word(lang, (unsigned char)s[j]) || s[j] == '.'); j++) {}
+                i = j; continue;
+            }
+            /* a directive runs to the end of the line or a trailing comment */
+            for (j = i + 1; j < len; j++) {
+                if (s[j] == '/' && j + 1 < len && (s[j + 1] == '/' || s[j + 1] == '*')) break;
+                if (s[j] == '"' || s[j] == '\'') break;
+            }
+            i = j; continue;
+        }
+        if ((c == '#' && ((fl & HL_HASH_COMMENTS) || ((fl & HL_HASH_WORD) && (i == 0 || s[i - 1] == ' ' || s[i - 1] == '\t'))))
+            || (c == '/' && (fl & HL_SLASH_COMMENTS) && i + 1 < len && s[i + 1] == '/')) {
+            lx_mark(&lx, i, MDVIC_HL_COMMENT);
+            i = len; break;
+        }
+        if (c == '/' && (fl & HL_SLASH_COMMENTS) && i + 1 < len && s[i + 1] == '*') {
+            lx_mark(&lx, i, MDVIC_HL_COMMENT);
+            i = scan_comment(s, len, i + 2, &closed);
+            if (!closed) st->mode = MODE_COMMENT;
+            continue;
+        }
+        if (c && strchr(lang->quotes, c)) {
+            int triple = (fl & HL_TRIPLE_QUOTES) && i + 2 < len && s[i + 1] == (char)c && s[i + 2] == (char)c;
+            j = scan_string(lang, s, len, i + (triple ? 3 : 1), (char)c, triple, &closed);
+            int kind = MDVIC_HL_STRING;
+            if ((fl & HL_KEYS) && closed && j < len) {
+                size_t k = skip_blanks(s, len, j);
+                if (k < len && s[k] == ':') kind = MDVIC_HL_TYPE;
+            }
+            lx_mark(&lx, i, kind);
+            if (!closed && (triple || (fl & HL_MULTILINE_STR))) {
+                st->mode = triple ? MODE_TRIPLE : MODE_STRING;
+                st->quote = c;
+            }
+            i = j; continue;
+        }
+        if (c == '$' && (fl & HL_VARIABLES) && i + 1 < len) {
+            unsigned char d = (unsigned char)s[i + 1];
+            j = i + 1;
+            if (d == '{') { while (j < len && s[j] != '}') j++; if (j < len) j++; }
+            else if (is_word_start(d)) { while (j < len && (is_word_start((unsigned char)s[j]) || is_digit((unsigned char)s[j]))) j++; }
+            else if (is_digit(d) || (d && strchr("?#@*$!-", d))) j = i + 2;
+            if (j > i + 1) { lx_mark(&lx, i, MDVIC_HL_TYPE); i = j; continue; }
+        }
+        int prev_word = i > 0 && is_word(lang, (unsigned char)s[i - 1]);
+        if (!prev_word && (is_digit(c) || (c == '.' && i + 1 < len && is_digit((unsigned char)s[i + 1]))
+                           || (c == '-' && (fl & HL_SIGNED_NUMBERS) && i + 1 < len && is_digit((unsigned char)s[i + 1])))) {
+            size_t d0 = (c == '-') ? i + 1 : i;
+            int hex = s[d0] == '0' && d0 + 1 < len && (s[d0 + 1] == 'x' || s[d0 + 1] == 'X');
+            for (j = i + 1; j < len; j++) {
+                unsigned char d = (unsigned char)s[j];
+                char e = s[j - 1];
+                if ((d == '+' || d == '-') && (hex ? (e == 'p' || e == 'P') : (e == 'e' || e == 'E'))) continue;
+                if (!(is_digit(d) || (d < 0x80 && is_word_start(d)) || d == '.')) break;
+            }
+            lx_mark(&lx, i, MDVIC_HL_NUMBER);
+            i = j; continue;
+        }
+        if (is_word_start(c) || (!prev_word && c && strchr(lang->word_extra, c))) {
+            for (j = i + 1; j < len && is_word(lang, (unsigned char)s[j]); j++) {}
+            if ((fl & HL_STRING_PREFIX) && j - i <= 2 && j < len && (s[j] == '"' || s[j] == '\'')
+                && strspn(s + i, "rRbBfFuU") >= j - i) {
+                lx_mark(&lx, i, MDVIC_HL_STRING);
+                i = j; continue; /* the quote follows as a string */
+            }
+            int kind = kw_lookup(lang->kw, s + i, j - i);
+            if ((fl & HL_KEYS) && kind == MDVIC_HL_PLAIN && !prev_word) {
+                size_t k = skip_blanks(s, len, j);
+                if (k < len && s[k] == ':' && (k + 1 == len || s[k + 1] == ' ' || s[k + 1] == '\t')) kind = MDVIC_HL_TYPE;
+            }
+            lx_mark(&lx, i, kind);
+            i = j; continue;
+        }
+        lx_mark(&lx, i, MDVIC_HL_PLAIN);
+        i++;
+    }
+    lx_mark(&lx, len, -1);
+}
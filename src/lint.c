@@ -1,85 +1,326 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <sys/stat.h>
 
 #include "mdvic/lint.h"
+#include "mdvic/math.h"
+#include "mdvic/mathspan.h"
 
-static const char *skip_spaces(const char *s) {
-    while (*s == ' ' || *s == '\t') s++;
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define LINT_SSE2 1
+#endif
+
+static const char *skip_spaces(const char *s, const char *end) {
+    while (s < end && (*s == ' ' || *s == '\t')) s++;
     return s;
 }
 
-static int fence_len_at(const char *s, char mark) {
-    int n = 0; while (*s == mark) { n++; s++; }
+static int fence_len_at(const char *s, const char *end, char mark) {
+    int n = 0; while (s < end && *s == mark) { n++; s++; }
     return n;
 }
 
-int mdvic_lint_buffer(const char *data, size_t len, FILE *err, const char *filename) {
-    size_t i = 0; int line = 1; int issues = 0;
-    int in_fence = 0; char fence_mark = 0; int fence_len = 0; int fence_line = 0;
-    int inline_tick_line = 0;
-
-    while (i < len) {
-        size_t line_start = i; size_t line_end = i;
-        while (line_end < len && data[line_end] != '\n') line_end++;
-        const char *s = data + line_start; size_t slen = line_end - line_start;
-
-        /* Detect fenced code blocks */
-        const char *t = skip_spaces(s);
-        int prev_in_fence = in_fence;
-        int fence_event = 0; /* 1=open, 2=close */
-        if (!in_fence && slen >= 3) {
-            if (*t == '`' || *t == '~') {
-                int n = fence_len_at(t, *t);
-                if (n >= 3) { in_fence = 1; fence_mark = *t; fence_len = n; fence_line = line; fence_event = 1; }
-            }
-        } else if (in_fence) {
-            /* Closing fence: same mark and at least fence_len */
-            if (*t == fence_mark) {
-                int n = fence_len_at(t, *t);
-                if (n >= fence_len) { in_fence = 0; fence_mark = 0; fence_len = 0; fence_line = 0; fence_event = 2; }
-            }
+/* First ` or ~ in [p, end), or end; the newlines passed over are added to
+ * *line. Only lines holding one of these bytes can matter to lint. */
+static const char *next_mark(const char *p, const char *end, int *line) {
+#ifdef LINT_SSE2
+    const __m128i nl = _mm_set1_epi8('\n'), tick = _mm_set1_epi8('`'), tilde = _mm_set1_epi8('~');
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)p);
+        unsigned marks = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, tick), _mm_cmpeq_epi8(v, tilde)));
+        unsigned lines = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+        if (marks) {
+            unsigned k = (unsigned)__builtin_ctz(marks);
+            *line += __builtin_popcount(lines & ((1u << k) - 1));
+            return p + k;
         }
+        *line += __builtin_popcount(lines);
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == '\n') (*line)++;
+        else if (*p == '`' || *p == '~') return p;
+    }
+    return end;
+}
 
-        /* Unmatched inline code span per line (ignore inside fences and fence marker lines) */
-        if (!prev_in_fence && fence_event == 0) {
-            int open = 0; int run = 0; const char *p = s; int col = 1;
-            while ((size_t)(p - s) < slen) {
-                char c = *p++;
-                if (c == '`') {
-                    run++;
-                    continue;
-                }
-                if (run > 0) {
-                    if (run == 1) {
-                        if (!open) { open = 1; inline_tick_line = line; }
-                        else { open = 0; }
-                    }
-                    run = 0;
-                }
-                (void)col; col++;
-            }
-            if (run > 0) {
-                if (run == 1) {
-                    if (!open) { open = 1; inline_tick_line = line; }
-                    else { open = 0; }
-                }
-            }
-            if (open) {
-                fprintf(err, "%s:%d: unmatched inline code backticks\n", filename ? filename : "-", inline_tick_line);
-                issues++;
+/* Column of p in its line, counting code points. */
+static int column_of(const char *line, const char *p) {
+    int col = 1;
+    for (; line < p; line++) if (((unsigned char)*line & 0xC0) != 0x80) col++;
+    return col;
+}
+
+static void report(mdvic_diag_fn fn, void *ctx, const char *filename, int line, int col, const char *rule, const char *message) {
+    struct MdvicDiag d;
+    d.file = filename ? filename : "-";
+    d.line = line; d.col = col; d.rule = rule; d.message = message;
+    fn(ctx, &d);
+}
+
+/* Lines without ` or ~ cannot open or close a fence or hold inline code,
+ * so the scan jumps from one such byte to the next (16 bytes at a time with
+ * SSE2) and only looks at the lines they are on: a line is classified by its
+ * first non-blank byte, and outside fences its backticks are paired up. */
+int mdvic_lint_scan(const char *data, size_t len, const char *filename, mdvic_diag_fn fn, void *ctx) {
+    const char *p = data, *end = data + len;
+    int line = 1; int issues = 0;
+    int in_fence = 0; char fence_mark = 0; int fence_len = 0; int fence_line = 0, fence_col = 0;
+
+    while (p < end) {
+        const char *m = next_mark(p, end, &line);
+        if (m == end) break;
+        const char *s = m;
+        while (s > p && s[-1] != '\n') s--;
+        const char *nl = (const char *)memchr(m, '\n', (size_t)(end - m));
+        const char *e = nl ? nl : end;
+        p = nl ? nl + 1 : end;
+
+        /* Fences: classify the line by its first non-blank byte */
+        const char *t = skip_spaces(s, e);
+        char first = t < e ? *t : '\0';
+        if (first == '`' || first == '~') {
+            if (!in_fence) {
+                int n = e - s >= 3 ? fence_len_at(t, e, first) : 0;
+                if (n >= 3) { in_fence = 1; fence_mark = first; fence_len = n; fence_line = line; fence_col = (int)(t - s) + 1; line++; continue; }
+            } else if (first == fence_mark && fence_len_at(t, e, first) >= fence_len) {
+                in_fence = 0; fence_mark = 0; fence_len = 0; fence_line = 0;
+                line++; continue;
             }
         }
+        if (in_fence) { line++; continue; }
 
-        i = (line_end < len) ? (line_end + 1) : line_end;
+        /* Inline code: single backticks must pair up within the line */
+        const char *open_at = NULL;
+        for (const char *q = (const char *)memchr(m, '`', (size_t)(e - m)); q; ) {
+            const char *r = q; while (r < e && *r == '`') r++;
+            if (r - q == 1) open_at = open_at ? NULL : q;
+            q = r < e ? (const char *)memchr(r, '`', (size_t)(e - r)) : NULL;
+        }
+        if (open_at) {
+            report(fn, ctx, filename, line, column_of(s, open_at), "unmatched-backtick", "unmatched inline code backticks");
+            issues++;
+        }
         line++;
     }
 
     if (in_fence) {
-        fprintf(err, "%s:%d: unclosed code fence\n", filename ? filename : "-", fence_line);
+        report(fn, ctx, filename, fence_line, fence_col, "unclosed-fence", "unclosed code fence");
         issues++;
     }
 
     return issues;
 }
+
+/* ---- math ---- */
+
+struct MathCtx {
+    const char *data; const struct MdvicMathSpan *sp;
+    const char *filename; mdvic_diag_fn fn; void *ctx;
+};
+
+static const char *line_start(const char *data, const char *p) {
+    while (p > data && p[-1] != '\n') p--;
+    return p;
+}
+
+/* Findings in a span's TeX. Single-line spans point into the source, so the
+ * offset gives the exact column; folded multi-line spans are reported at
+ * their opening delimiter. */
+static void math_issue(void *arg, size_t off, const char *rule, const char *message) {
+    struct MathCtx *m = (struct MathCtx *)arg;
+    const char *at = m->sp->raw;
+    if (m->sp->tex >= m->sp->raw && m->sp->tex < m->sp->raw + m->sp->raw_len) at = m->sp->tex + off;
+    report(m->fn, m->ctx, m->filename, m->sp->line, column_of(line_start(m->data, m->sp->raw), at), rule, message);
+}
+
+int mdvic_lint_math(const char *data, size_t len, const struct MdvicMathSpans *spans, const char *filename, mdvic_diag_fn fn, void *ctx) {
+    int issues = 0;
+    struct MdvicMathDelim *lone = NULL; size_t nlone = 0;
+    if (mdvic_math_lone_delims(data, len, &lone, &nlone) == 0) {
+        for (size_t k = 0; k < nlone; k++) {
+            const char *p = data + lone[k].pos;
+            /* a lone $ is usually a price; only $\cmd looks like math */
+            if (lone[k].len == 1 && !(lone[k].pos + 1 < len && p[1] == '\\')) continue;
+            char msg[48];
+            if (lone[k].len == 1) snprintf(msg, sizeof(msg), "unmatched $");
+            else if (lone[k].len == 2) snprintf(msg, sizeof(msg), "unmatched $$");
+            else snprintf(msg, sizeof(msg), "unmatched run of %d dollars", lone[k].len);
+            report(fn, ctx, filename, lone[k].line, column_of(line_start(data, p), p), "math-delimiter", msg);
+            issues++;
+        }
+        free(lone);
+    }
+    if (!spans) return issues;
+    struct MathCtx m;
+    m.data = data; m.filename = filename; m.fn = fn; m.ctx = ctx;
+    for (size_t k = 0; k < spans->count; k++) {
+        m.sp = &spans->spans[k];
+        issues += mdvic_math_check(m.sp->tex, m.sp->tex_len, math_issue, &m);
+    }
+    return issues;
+}
+
+/* ---- links ---- */
+
+/* Path lookups shared by every file and thread of the process: a string set
+ * with open addressing, each entry remembering whether the path exists. The
+ * lock is held across stat() so a path is looked up once, whoever asks. */
+struct PathEntry { char *path; uint32_t hash; int exists; };
+static struct {
+    struct PathEntry *v; size_t n, cap;
+    unsigned long hits, misses;
+} g_paths;
+#ifndef _WIN32
+static pthread_mutex_t g_paths_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static uint32_t path_hash(const char *s) {
+    uint32_t h = 2166136261u;
+    for (; *s; s++) { h ^= (unsigned char)*s; h *= 16777619u; }
+    return h;
+}
+
+static int paths_grow(void) {
+    size_t ncap = g_paths.cap ? g_paths.cap * 2 : 64;
+    struct PathEntry *nv = (struct PathEntry *)calloc(ncap, sizeof(*nv));
+    if (!nv) return -1;
+    for (size_t i = 0; i < g_paths.cap; i++) {
+        if (!g_paths.v[i].path) continue;
+        size_t j = g_paths.v[i].hash & (ncap - 1);
+        while (nv[j].path) j = (j + 1) & (ncap - 1);
+        nv[j] = g_paths.v[i];
+    }
+    free(g_paths.v);
+    g_paths.v = nv; g_paths.cap = ncap;
+    return 0;
+}
+
+static int path_lookup(const char *path) {
+    uint32_t h = path_hash(path);
+    if (g_paths.cap) {
+        for (size_t j = h & (g_paths.cap - 1); g_paths.v[j].path; j = (j + 1) & (g_paths.cap - 1)) {
+            if (g_paths.v[j].hash == h && strcmp(g_paths.v[j].path, path) == 0) { g_paths.hits++; return g_paths.v[j].exists; }
+        }
+    }
+    g_paths.misses++;
+    struct stat st;
+    int exists = stat(path, &st) == 0;
+    if (g_paths.n * 2 >= g_paths.cap && paths_grow() != 0) return exists;
+    char *copy = strdup(path);
+    if (!copy) return exists;
+    size_t j = h & (g_paths.cap - 1);
+    while (g_paths.v[j].path) j = (j + 1) & (g_paths.cap - 1);
+    g_paths.v[j].path = copy; g_paths.v[j].hash = h; g_paths.v[j].exists = exists;
+    g_paths.n++;
+    return exists;
+}
+
+int mdvic_path_exists(const char *path) {
+#ifndef _WIN32
+    pthread_mutex_lock(&g_paths_lock);
+#endif
+    int exists = path_lookup(path);
+#ifndef _WIN32
+    pthread_mutex_unlock(&g_paths_lock);
+#endif
+    return exists;
+}
+
+void mdvic_path_cache_stats(unsigned long *hits, unsigned long *misses) {
+#ifndef _WIN32
+    pthread_mutex_lock(&g_paths_lock);
+#endif
+    if (hits) *hits = g_paths.hits;
+    if (misses) *misses = g_paths.misses;
+#ifndef _WIN32
+    pthread_mutex_unlock(&g_paths_lock);
+#endif
+}
+
+static int hex_val(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+int mdvic_link_target_missing(const char *url, const char *filename) {
+    if (!url || !*url || *url == '#' || *url == '/') return 0;
+    /* scheme: (mailto:, https:, ...) */
+    const char *p = url;
+    if ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z')) {
+        while ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9') || *p == '+' || *p == '-' || *p == '.') p++;
+        if (*p == ':') return 0;
+    }
+    size_t ulen = strcspn(url, "?#");
+    const char *slash = filename && strcmp(filename, "-") != 0 ? strrchr(filename, '/') : NULL;
+    size_t dlen = slash ? (size_t)(slash - filename) + 1 : 0;
+    char *path = (char *)malloc(dlen + ulen + 1);
+    if (!path) return 0;
+    if (dlen) memcpy(path, filename, dlen);
+    size_t n = dlen;
+    for (size_t i = 0; i < ulen; i++) {
+        int hi, lo;
+        if (url[i] == '%' && i + 2 < ulen && (hi = hex_val(url[i + 1])) >= 0 && (lo = hex_val(url[i + 2])) >= 0) {
+            path[n++] = (char)(hi * 16 + lo); i += 2;
+        } else {
+            path[n++] = url[i];
+        }
+    }
+    path[n] = '\0';
+    int missing = n > dlen && strlen(path) == n && !mdvic_path_exists(path);
+    free(path);
+    return missing;
+}
+
+void mdvic_diag_print(FILE *err, const struct MdvicDiag *d) {
+    fprintf(err, "%s:%d: %s\n", d->file, d->line, d->message);
+}
+
+static void print_diag(void *ctx, const struct MdvicDiag *d) {
+    mdvic_diag_print((FILE *)ctx, d);
+}
+
+int mdvic_lint_buffer(const char *data, size_t len, FILE *err, const char *filename) {
+    return mdvic_lint_scan(data, len, filename, print_diag, err);
+}
+
+void mdvic_diag_collect(void *list, const struct MdvicDiag *d) {
+    struct MdvicDiagList *l = (struct MdvicDiagList *)list;
+    if (l->n == l->cap) {
+        size_t ncap = l->cap ? l->cap * 2 : 8;
+        struct MdvicDiagItem *nv = (struct MdvicDiagItem *)realloc(l->v, ncap * sizeof(*nv));
+        if (!nv) return;
+        l->v = nv; l->cap = ncap;
+    }
+    char *msg = strdup(d->message);
+    if (!msg) return;
+    struct MdvicDiagItem *x = &l->v[l->n++];
+    x->line = d->line; x->col = d->col; x->rule = d->rule; x->message = msg;
+}
+
+void mdvic_diag_list_print(FILE *err, const struct MdvicDiagList *l, const char *file) {
+    for (size_t i = 0; i < l->n; i++) {
+        struct MdvicDiag d;
+        d.file = file ? file : "-";
+        d.line = l->v[i].line; d.col = l->v[i].col; d.rule = l->v[i].rule; d.message = l->v[i].message;
+        mdvic_diag_print(err, &d);
+    }
+}
+
+void mdvic_diag_list_free(struct MdvicDiagList *l) {
+    for (size_t i = 0; i < l->n; i++) free(l->v[i].message);
+    free(l->v);
+    l->v = NULL; l->n = l->cap = 0;
+}
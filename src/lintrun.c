@@ -0,0 +1,185 @@
+/* --lint-only: lint many files on worker threads, report in path order. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "mdvic/mdvic.h"
+#include "mdvic/lint.h"
+#include "mdvic/utf8.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* Upper bound on worker threads, whatever the CPU count. */
+#define LINT_MAX_JOBS 64
+
+static const struct { const char *id, *text; } lint_rules[] = {
+    { "unclosed-fence", "Code fence is never closed" },
+    { "unmatched-backtick", "Inline code backtick has no partner on its line" },
+    { "table-separator", "Table separator row is malformed" },
+    { "table-columns", "Table row has a different number of cells than the header" },
+    { "math-delimiter", "Math delimiter has no partner" },
+    { "math-command", "Math command or environment has no rendering" },
+    { "math-group", "\\left/\\right or \\begin/\\end do not pair up" },
+    { "missing-link-target", "Relative link or image points to a file that does not exist" },
+};
+
+struct LintFile {
+    const char *path;
+    struct MdvicDiagList found;
+    int error; /* errno when the file could not be read */
+    enum mdvic_input_encoding enc;
+};
+
+/* Findings come per check; report them in source order. */
+static int diag_cmp(const void *a, const void *b) {
+    const struct MdvicDiagItem *x = (const struct MdvicDiagItem *)a, *y = (const struct MdvicDiagItem *)b;
+    if (x->line != y->line) return x->line < y->line ? -1 : 1;
+    if (x->col != y->col) return x->col < y->col ? -1 : 1;
+    int c = strcmp(x->rule, y->rule);
+    return c ? c : strcmp(x->message, y->message);
+}
+
+static void lint_one(struct LintFile *f) {
+    int is_stdin = strcmp(f->path, "-") == 0;
+    FILE *in = is_stdin ? stdin : fopen(f->path, "rb");
+    if (!in) { f->error = errno ? errno : EIO; return; }
+    char *data = NULL; size_t len = 0;
+    int rc = mdvic_read_input(in, f->enc, &data, &len, NULL);
+    if (rc != 0) f->error = errno ? errno : EIO;
+    if (!is_stdin) fclose(in);
+    if (rc != 0) return;
+    (void)mdvic_lint_document(data, len, f->path, mdvic_diag_collect, &f->found);
+    free(data);
+    if (f->found.n > 1) qsort(f->found.v, f->found.n, sizeof(*f->found.v), diag_cmp);
+}
+
+#ifndef _WIN32
+struct LintQueue {
+    struct LintFile *files;
+    int n, next;
+    pthread_mutex_t lock;
+};
+
+static void *lint_worker(void *arg) {
+    struct LintQueue *q = (struct LintQueue *)arg;
+    for (;;) {
+        pthread_mutex_lock(&q->lock);
+        int k = q->next++;
+        pthread_mutex_unlock(&q->lock);
+        if (k >= q->n) return NULL;
+        lint_one(&q->files[k]);
+    }
+}
+#endif
+
+static void lint_all(struct LintFile *files, int n, int jobs) {
+#ifndef _WIN32
+    if (jobs <= 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = cpus > 0 ? (int)cpus : 1;
+#else
+        jobs = 1;
+#endif
+    }
+    if (jobs > n) jobs = n;
+    if (jobs > LINT_MAX_JOBS) jobs = LINT_MAX_JOBS;
+    if (jobs > 1) {
+        struct LintQueue q;
+        pthread_t tid[LINT_MAX_JOBS];
+        int started = 0;
+        q.files = files; q.n = n; q.next = 0;
+        pthread_mutex_init(&q.lock, NULL);
+        /* the calling thread works too */
+        for (int t = 1; t < jobs; t++) {
+            if (pthread_create(&tid[started], NULL, lint_worker, &q) != 0) break;
+            started++;
+        }
+        (void)lint_worker(&q);
+        for (int t = 0; t < started; t++) pthread_join(tid[t], NULL);
+        pthread_mutex_destroy(&q.lock);
+        return;
+    }
+#else
+    (void)jobs;
+#endif
+    for (int k = 0; k < n; k++) lint_one(&files[k]);
+}
+
+/* ---- output ---- */
+
+/* A URI for a path: unreserved bytes and '/' as they are, everything else
+ * percent-encoded; a relative reference, or file:// for an absolute path. */
+static void uri_string(FILE *out, const char *path) {
+    fputc('"', out);
+    if (path[0] == '/') fputs("file://", out);
+    for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+        if ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9') || strchr("-._~/", *p)) fputc(*p, out);
+        else fprintf(out, "%%%02X", *p);
+    }
+    fputc('"', out);
+}
+
+static void write_sarif(FILE *out, const struct LintFile *files, int n) {
+    fputs("{\n  \"version\": \"2.1.0\",\n", out);
+    fputs("  \"$schema\": \"https://json.schemastore.org/sarif-2.1.0.json\",\n", out);
+    fputs("  \"runs\": [{\n    \"tool\": {\"driver\": {\"name\": \"mdvic\", \"version\": \"" MDVIC_VERSION "\", \"rules\": [\n", out);
+    size_t nrules = sizeof(lint_rules) / sizeof(lint_rules[0]);
+    for (size_t i = 0; i < nrules; i++) {
+        fputs("      {\"id\": ", out); mdvic_json_string(out, lint_rules[i].id);
+        fputs(", \"shortDescription\": {\"text\": ", out); mdvic_json_string(out, lint_rules[i].text);
+        fputs("}}", out); fputs(i + 1 < nrules ? ",\n" : "\n", out);
+    }
+    fputs("    ]}},\n    \"columnKind\": \"unicodeCodePoints\",\n    \"results\": [", out);
+    int first = 1;
+    for (int k = 0; k < n; k++) {
+        for (size_t i = 0; i < files[k].found.n; i++) {
+            const struct MdvicDiagItem *x = &files[k].found.v[i];
+            fputs(first ? "\n" : ",\n", out); first = 0;
+            fputs("      {\"ruleId\": ", out); mdvic_json_string(out, x->rule);
+            fputs(", \"level\": \"warning\", \"message\": {\"text\": ", out); mdvic_json_string(out, x->message);
+            fputs("}, \"locations\": [{\"physicalLocation\": {\"artifactLocation\": {\"uri\": ", out);
+            uri_string(out, files[k].path);
+            fprintf(out, "}, \"region\": {\"startLine\": %d, \"startColumn\": %d}}}]}", x->line, x->col);
+        }
+    }
+    fputs(first ? "]\n  }]\n}\n" : "\n    ]\n  }]\n}\n", out);
+}
+
+int mdvic_lint_files(const char *const *paths, int n, enum mdvic_input_encoding enc, enum mdvic_lint_format fmt, int jobs, FILE *out, FILE *err) {
+    struct LintFile *files = (struct LintFile *)calloc(n > 0 ? (size_t)n : 1, sizeof(*files));
+    if (!files) return -1;
+    for (int k = 0; k < n; k++) { files[k].path = paths[k]; files[k].enc = enc; }
+    lint_all(files, n, jobs);
+
+    int total = 0, failed = 0;
+    for (int k = 0; k < n; k++) {
+        const struct LintFile *f = &files[k];
+        if (f->error) { fprintf(err, "mdvic: cannot open '%s': %s\n", f->path, strerror(f->error)); failed = 1; }
+        total += (int)f->found.n;
+        if (fmt == MDVIC_LINT_SARIF) continue;
+        for (size_t i = 0; i < f->found.n; i++) {
+            const struct MdvicDiagItem *x = &f->found.v[i];
+            if (fmt == MDVIC_LINT_TEXT) {
+                fprintf(out, "%s:%d:%d: %s [%s]\n", f->path, x->line, x->col, x->message, x->rule);
+            } else {
+                fputs("{\"file\":", out); mdvic_json_string(out, f->path);
+                fprintf(out, ",\"line\":%d,\"column\":%d,\"rule\":", x->line, x->col);
+                mdvic_json_string(out, x->rule);
+                fputs(",\"message\":", out); mdvic_json_string(out, x->message);
+                fputs("}\n", out);
+            }
+        }
+    }
+    if (fmt == MDVIC_LINT_SARIF) write_sarif(out, files, n);
+
+    for (int k = 0; k < n; k++) mdvic_diag_list_free(&files[k].found);
+    free(files);
+    return failed ? -1 : total;
+}
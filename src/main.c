@@ -5,10 +5,19 @@
 #include <stdbool.h>
 
 #include "mdvic/mdvic.h"
+#include "mdvic/theme.h"
+#include "mdvic/grid.h"
+#include "mdvic/lint.h"
+#include "mdvic/stats.h"
+#include "mdvic/trace.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 
 static void print_usage(const char *prog) {
     fprintf(stderr,
-            "Usage: %s [--no-color] [--no-lint] [--wrap|--no-wrap] [--width N] [--math {unicode|ascii}] [FILE...]\n",
+            "Usage: %s [--no-color] [--no-lint] [--wrap|--no-wrap] [--width N] [--math {unicode|ascii}] [--math-limit SPEC] [--theme FILE] [--no-highlight] [--pager] [--grid {binary|text}] [--lint-only [--lint-format {text|jsonl|sarif}] [--jobs N]] [--input-encoding ENC] [--stats] [--trace FILE] [FILE...]\n",
             prog);
 }
 
@@ -25,7 +34,71 @@ static int parse_int(const char *s, int *out) {
     return 0;
 }
 
+enum grid_mode { GRID_OFF, GRID_BINARY, GRID_TEXT };
+
+static int parse_grid_mode(const char *s, enum grid_mode *mode) {
+    if (strcmp(s, "binary") == 0) *mode = GRID_BINARY;
+    else if (strcmp(s, "text") == 0) *mode = GRID_TEXT;
+    else return -1;
+    return 0;
+}
+
+static int parse_lint_format(const char *s, enum mdvic_lint_format *fmt) {
+    if (strcmp(s, "text") == 0) *fmt = MDVIC_LINT_TEXT;
+    else if (strcmp(s, "jsonl") == 0) *fmt = MDVIC_LINT_JSONL;
+    else if (strcmp(s, "sarif") == 0) *fmt = MDVIC_LINT_SARIF;
+    else return -1;
+    return 0;
+}
+
+/* Render one input into a cell grid and write it to stdout. */
+static int render_grid(FILE *in, const struct MdvicOptions *opt, const char *path, enum grid_mode mode, int width) {
+    struct MdvicIr *ir = mdvic_ir_new(opt);
+    if (!ir) return -1;
+    struct MdvicDoc *d = mdvic_doc_open_ir(in, ir, path);
+    if (!d) { mdvic_ir_free(ir); return -1; }
+    while (mdvic_doc_render_next(d) > 0) {}
+    mdvic_doc_close(d);
+    struct MdvicGrid *g = mdvic_layout_grid(ir, width);
+    mdvic_ir_free(ir);
+    if (!g) return -1;
+    int rc = mode == GRID_BINARY ? mdvic_grid_write_binary(g, stdout) : mdvic_grid_write_text(g, stdout);
+    mdvic_grid_free(g);
+    return rc;
+}
+
+/* Flush stdout as part of the write phase, then report on stderr. */
+static void print_stats(struct MdvicStats *st, unsigned long long start) {
+    unsigned long long t0 = mdvic_stats_now();
+    fflush(stdout);
+    st->phase_ns[MDVIC_PHASE_WRITE] += mdvic_stats_now() - t0;
+    st->wall_ns = mdvic_stats_now() - start;
+    st->have_allocs = mdvic_alloc_stats(&st->allocs, &st->alloc_bytes);
+    st->peak_rss_kib = -1;
+#ifndef _WIN32
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+#ifdef __APPLE__
+        st->peak_rss_kib = (long)(ru.ru_maxrss / 1024); /* bytes there */
+#else
+        st->peak_rss_kib = (long)ru.ru_maxrss;
+#endif
+    }
+#endif
+    mdvic_stats_print(stderr, st);
+}
+
+static int finish_trace(struct MdvicTrace *t, FILE *f, const char *path) {
+    int rc = mdvic_trace_finish(t);
+    if (fclose(f) != 0) rc = -1;
+    if (rc != 0) fprintf(stderr, "mdvic: cannot write '%s'\n", path);
+    return rc;
+}
+
 int main(int argc, char **argv) {
+    unsigned long long start = mdvic_stats_now();
+    static struct MdvicStats stats;
+    bool want_stats = false;
     struct MdvicOptions opt;
     opt.no_color = false;
     opt.width = 0;
@@ -33,7 +106,23 @@ int main(int argc, char **argv) {
     opt.enable_lint = true;
     opt.enable_wrap = false; /* default no-wrap */
     opt.enable_osc8 = true;
+    opt.enable_highlight = true;
     opt.accent_group = false; /* default: accent last char */
+    opt.math_limits.max_depth = MDVIC_MATH_DEFAULT_DEPTH;
+    opt.math_limits.max_tokens = MDVIC_MATH_DEFAULT_TOKENS;
+    opt.math_limits.max_bytes = MDVIC_MATH_DEFAULT_BYTES;
+    opt.theme = NULL;
+    opt.stats = NULL;
+    opt.trace = NULL;
+    opt.input_encoding = MDVIC_INPUT_AUTO;
+    const char *trace_path = NULL;
+    bool use_pager = false;
+    enum grid_mode grid = GRID_OFF;
+    bool lint_only = false;
+    enum mdvic_lint_format lint_format = MDVIC_LINT_TEXT;
+    int jobs = 0;
+    const char *theme_path = getenv("MDVIC_THEME");
+    if (theme_path && theme_path[0] == '\0') theme_path = NULL;
 
     mdvic_apply_env_overrides(&opt);
 
@@ -60,6 +149,13 @@ int main(int argc, char **argv) {
             if (i + 1 >= argc) { fprintf(stderr, "--width requires a value\n"); return 2; }
             int w = 0; if (parse_int(argv[i+1], &w) != 0) { fprintf(stderr, "Invalid width: %s\n", argv[i+1]); return 2; }
             opt.width = w; i += 2;
+        } else if (strncmp(arg, "--input-encoding=", 17) == 0) {
+            if (mdvic_parse_input_encoding(arg + 17, &opt.input_encoding) != 0) { fprintf(stderr, "Invalid input encoding: %s\n", arg + 17); return 2; }
+            i++;
+        } else if (strcmp(arg, "--input-encoding") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "--input-encoding requires a value\n"); return 2; }
+            if (mdvic_parse_input_encoding(argv[i+1], &opt.input_encoding) != 0) { fprintf(stderr, "Invalid input encoding: %s\n", argv[i+1]); return 2; }
+            i += 2;
         } else if (strncmp(arg, "--math=", 8) == 0) {
             const char *m = arg + 8;
             if (strcmp(m, "unicode") == 0) opt.math_mode = MDVIC_MATH_UNICODE;
@@ -73,6 +169,18 @@ int main(int argc, char **argv) {
             else if (strcmp(m, "ascii") == 0) opt.math_mode = MDVIC_MATH_ASCII;
             else { fprintf(stderr, "Invalid math mode: %s\n", m); return 2; }
             i += 2;
+        } else if (strncmp(arg, "--math-limit=", 13) == 0) {
+            if (mdvic_parse_math_limit(arg + 13, &opt.math_limits) != 0) { fprintf(stderr, "Invalid math limit: %s\n", arg + 13); return 2; }
+            i++;
+        } else if (strcmp(arg, "--math-limit") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "--math-limit requires a value\n"); return 2; }
+            if (mdvic_parse_math_limit(argv[i+1], &opt.math_limits) != 0) { fprintf(stderr, "Invalid math limit: %s\n", argv[i+1]); return 2; }
+            i += 2;
+        } else if (strncmp(arg, "--theme=", 8) == 0) {
+            theme_path = arg + 8; i++;
+        } else if (strcmp(arg, "--theme") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "--theme requires a value\n"); return 2; }
+            theme_path = argv[i+1]; i += 2;
         } else if (strcmp(arg, "--no-lint") == 0) {
             opt.enable_lint = false; i++;
         } else if (strcmp(arg, "--lint") == 0) {
@@ -85,6 +193,42 @@ int main(int argc, char **argv) {
             opt.enable_osc8 = false; i++;
         } else if (strcmp(arg, "--osc8") == 0) {
             opt.enable_osc8 = true; i++;
+        } else if (strcmp(arg, "--no-highlight") == 0) {
+            opt.enable_highlight = false; i++;
+        } else if (strcmp(arg, "--highlight") == 0) {
+            opt.enable_highlight = true; i++;
+        } else if (strcmp(arg, "--pager") == 0) {
+            use_pager = true; i++;
+        } else if (strcmp(arg, "--stats") == 0) {
+            want_stats = true; i++;
+        } else if (strncmp(arg, "--trace=", 8) == 0) {
+            trace_path = arg + 8; i++;
+        } else if (strcmp(arg, "--trace") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "--trace requires a file\n"); return 2; }
+            trace_path = argv[i+1]; i += 2;
+        } else if (strcmp(arg, "--lint-only") == 0) {
+            lint_only = true; i++;
+        } else if (strncmp(arg, "--lint-format=", 14) == 0) {
+            if (parse_lint_format(arg + 14, &lint_format) != 0) { fprintf(stderr, "Invalid lint format: %s\n", arg + 14); return 2; }
+            i++;
+        } else if (strcmp(arg, "--lint-format") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "--lint-format requires a value\n"); return 2; }
+            if (parse_lint_format(argv[i+1], &lint_format) != 0) { fprintf(stderr, "Invalid lint format: %s\n", argv[i+1]); return 2; }
+            i += 2;
+        } else if (strncmp(arg, "--jobs=", 7) == 0) {
+            if (parse_int(arg + 7, &jobs) != 0) { fprintf(stderr, "Invalid job count: %s\n", arg + 7); return 2; }
+            i++;
+        } else if (strcmp(arg, "--jobs") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "--jobs requires a value\n"); return 2; }
+            if (parse_int(argv[i+1], &jobs) != 0) { fprintf(stderr, "Invalid job count: %s\n", argv[i+1]); return 2; }
+            i += 2;
+        } else if (strncmp(arg, "--grid=", 7) == 0) {
+            if (parse_grid_mode(arg + 7, &grid) != 0) { fprintf(stderr, "Invalid grid format: %s\n", arg + 7); return 2; }
+            i++;
+        } else if (strcmp(arg, "--grid") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "--grid requires a value\n"); return 2; }
+            if (parse_grid_mode(argv[i+1], &grid) != 0) { fprintf(stderr, "Invalid grid format: %s\n", argv[i+1]); return 2; }
+            i += 2;
         } else if (strncmp(arg, "--accent=", 9) == 0) {
             const char *am = arg + 9;
             if (strcmp(am, "last") == 0) opt.accent_group = false;
@@ -100,13 +244,90 @@ int main(int argc, char **argv) {
         }
     }
 
+    /* Events are written as blocks finish; the file is closed on the way out */
+    FILE *trace_file = NULL;
+    if (trace_path) {
+        trace_file = fopen(trace_path, "w");
+        if (!trace_file) { fprintf(stderr, "mdvic: cannot open '%s': %s\n", trace_path, strerror(errno)); return 2; }
+        opt.trace = mdvic_trace_new(trace_file);
+        if (!opt.trace) { fclose(trace_file); fprintf(stderr, "mdvic: out of memory\n"); return 2; }
+    }
+
+    if (lint_only) {
+        /* Diagnostics only, on stdout; the exit status says whether any were found */
+        static const char *const stdin_path[] = { "-" };
+        const char *const *paths = i < argc ? (const char *const *)(argv + i) : stdin_path;
+        int n = i < argc ? argc - i : 1;
+        unsigned long long t0 = mdvic_stats_now();
+        int rc = mdvic_lint_files(paths, n, opt.input_encoding, lint_format, jobs, stdout, stderr);
+        if (opt.trace) {
+            struct MdvicTraceSpan sp;
+            memset(&sp, 0, sizeof(sp));
+            sp.name = "lint"; sp.tid = MDVIC_TRACE_TID_MAIN; sp.start_ns = t0; sp.end_ns = mdvic_stats_now();
+            mdvic_trace_span(opt.trace, &sp);
+            if (finish_trace(opt.trace, trace_file, trace_path) != 0) rc = -1;
+        }
+        if (want_stats) {
+            stats.files = (unsigned long)n;
+            stats.phase_ns[MDVIC_PHASE_LINT] = mdvic_stats_now() - t0;
+            print_stats(&stats, start);
+        }
+        return rc == 0 ? 0 : 1;
+    }
+
+    /* Compile the theme once for all inputs */
+    static struct MdvicTheme theme;
+    if (theme_path) {
+        mdvic_theme_default(&theme);
+        if (mdvic_theme_load(&theme, theme_path, stderr) != 0) return 2;
+        opt.theme = &theme;
+    }
+
     if (opt.enable_wrap && opt.width == 0) {
         int detected = mdvic_detect_width();
         if (detected > 0) opt.width = detected;
     }
 
+    if (want_stats) opt.stats = &stats;
+
     int exit_code = 0;
-    if (i >= argc) {
+    if (grid != GRID_OFF) {
+        /* A grid always has a width: --width, else the terminal's, else 80 */
+        int width = opt.width > 0 ? opt.width : mdvic_detect_width();
+        if (width <= 0) width = 80;
+        int n = i < argc ? argc - i : 1;
+        for (int k = 0; k < n; k++) {
+            const char *path = i < argc ? argv[i + k] : "-";
+            FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+            if (!fp) {
+                fprintf(stderr, "mdvic: cannot open '%s': %s\n", path, strerror(errno));
+                exit_code = 1;
+                continue;
+            }
+            if (render_grid(fp, &opt, path, grid, width) != 0) exit_code = 1;
+            if (fp != stdin) fclose(fp);
+        }
+    } else if (use_pager) {
+        /* Page each input in turn; q moves on to the next, Q quits. When
+         * stdout is not a terminal the pager declines and we render. */
+        int n = i < argc ? argc - i : 1;
+        for (int k = 0; k < n; k++) {
+            const char *path = i < argc ? argv[i + k] : "-";
+            FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+            if (!fp) {
+                fprintf(stderr, "mdvic: cannot open '%s': %s\n", path, strerror(errno));
+                exit_code = 1;
+                continue;
+            }
+            int rc = mdvic_pager(fp, &opt, path);
+            if (rc < 0) {
+                if (k > 0) fputs(opt.no_color ? "\n---\n" : "\n\x1b[2m---\x1b[0m\n", stdout);
+                if (mdvic_render_stream(fp, stdout, &opt, path) != 0) exit_code = 1;
+            }
+            if (fp != stdin) fclose(fp);
+            if (rc > 0) break;
+        }
+    } else if (i >= argc) {
         if (mdvic_render_stream(stdin, stdout, &opt, "-") != 0) {
             exit_code = 1;
         }
@@ -138,5 +359,7 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (want_stats) print_stats(&stats, start);
+    if (opt.trace && finish_trace(opt.trace, trace_file, trace_path) != 0) exit_code = 1;
     return exit_code;
 }
@@ -4,14 +4,59 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 #include "mdvic/math.h"
+#include "mdvic/wcwidth.h"
+#include "mdvic/mathalpha_table.h"
 
-struct mbuf { char *p; size_t n; size_t cap; };
-static int g_display_hint = 0;
-static size_t disp_len(const char *p) { return p ? strlen(p) : 0; }
+/* State of one mdvic_math_render call, passed down the recursion so that
+ * concurrent renders do not share it. The budget is per span (see struct
+ * MdvicMathLimits); once a limit trips, hit makes every level unwind
+ * without further work. */
+struct mctx {
+    const struct MdvicOptions *opt;
+    struct MdvicMathLimits lim;
+    int display;    /* stacked layout, as for display math */
+    int depth;
+    size_t tokens;
+    size_t bytes;   /* written to any buffer of the span */
+    int hit;
+};
+
+struct mbuf { char *p; size_t n; size_t cap; struct mctx *cx; };
+
+/* Display columns of a UTF-8 string; invalid bytes count as one column. */
+static size_t disp_width(const char *p, size_t n) {
+    size_t i = 0, w = 0;
+    while (i < n) {
+        unsigned char c0 = (unsigned char)p[i];
+        uint32_t cp = c0; size_t k = 1;
+        if (c0 >= 0xC0 && c0 < 0xE0 && i + 1 < n) { cp = c0 & 0x1F; k = 2; }
+        else if (c0 >= 0xE0 && c0 < 0xF0 && i + 2 < n) { cp = c0 & 0x0F; k = 3; }
+        else if (c0 >= 0xF0 && c0 < 0xF8 && i + 3 < n) { cp = c0 & 0x07; k = 4; }
+        for (size_t j = 1; j < k; j++) {
+            unsigned char cj = (unsigned char)p[i + j];
+            if ((cj & 0xC0) != 0x80) { cp = c0; k = 1; break; }
+            cp = (cp << 6) | (cj & 0x3F);
+        }
+        int cw = (k == 1 && c0 >= 0x80) ? 1 : mdvic_wcwidth(cp);
+        w += cw > 0 ? (size_t)cw : 0;
+        i += k;
+    }
+    return w;
+}
+static size_t disp_len(const char *p) { return p ? disp_width(p, strlen(p)) : 0; }
 
 static int mb_grow(struct mbuf *b, size_t add) {
     size_t need = b->n + add + 1;
+    struct mctx *cx = b->cx;
+    if (cx && cx->lim.max_bytes) {
+        if (add > cx->lim.max_bytes - cx->bytes) {
+            if (!cx->hit) cx->hit = MDVIC_MATH_LIMIT_BYTES;
+            return -1;
+        }
+        cx->bytes += add;
+    }
     if (need <= b->cap) return 0;
     size_t ncap = b->cap ? b->cap * 2 : 128;
     while (ncap < need) ncap *= 2;
@@ -97,65 +142,244 @@ static int mb_puts_combining_last(struct mbuf *out, const char *s, size_t len, c
     return 0;
 }
 
-static const char *sup_char(int ch) {
-    switch (ch) {
-    case '0': return "⁰"; case '1': return "¹"; case '2': return "²"; case '3': return "³";
-    case '4': return "⁴"; case '5': return "⁵"; case '6': return "⁶"; case '7': return "⁷";
-    case '8': return "⁸"; case '9': return "⁹"; case '+': return "⁺"; case '-': return "⁻";
-    case '=': return "⁼"; case '(': return "⁽"; case ')': return "⁾"; case 'n': return "ⁿ"; case 'i': return "ⁱ";
-    default: return NULL;
+static int render_subexpr(const char *s, size_t len, struct mbuf *out, struct mctx *cx);
+
+/* Superscript/subscript. With Unicode, a group whose every character has a
+ * script form is emitted in it (spaces are dropped, as TeX does); otherwise
+ * the whole group falls back to mark + "(...)". Source groups are rendered
+ * first; already-rendered text (is_source == 0) is copied as is. */
+static int emit_script(struct mbuf *b, const char *s, size_t len, const char *const *tbl, char mark,
+                       int unicode, int is_source, struct mctx *cx) {
+    if (unicode) {
+        size_t i = 0;
+        while (i < len && (s[i] == ' ' || ((unsigned char)s[i] < 128 && tbl[(unsigned char)s[i]]))) i++;
+        if (i == len) {
+            for (i = 0; i < len; i++) {
+                if (s[i] != ' ' && mb_puts(b, tbl[(unsigned char)s[i]]) != 0) return -1;
+            }
+            return 0;
+        }
+    }
+    /* parenthesize anything longer than one character or one \command */
+    size_t k = 1;
+    if (len > 1 && s[0] == '\\') { while (k < len && ((s[k] >= 'a' && s[k] <= 'z') || (s[k] >= 'A' && s[k] <= 'Z'))) k++; }
+    int group = (len > k);
+    if (mb_putc(b, mark) != 0) return -1;
+    if (group) { if (mb_putc(b, '(') != 0) return -1; }
+    if (unicode && is_source) {
+        if (render_subexpr(s, len, b, cx) != 0) return -1;
+    } else {
+        if (mb_grow(b, len) != 0) return -1;
+        memcpy(b->p + b->n, s, len); b->n += len; b->p[b->n] = '\0';
     }
+    if (group) { if (mb_putc(b, ')') != 0) return -1; }
+    return 0;
+}
+static int emit_sup(struct mbuf *b, const char *s, size_t len, int unicode, int is_source, struct mctx *cx) {
+    return emit_script(b, s, len, mdvic_math_sup, '^', unicode, is_source, cx);
 }
-static const char *sub_char(int ch) {
-    switch (ch) {
-    case '0': return "₀"; case '1': return "₁"; case '2': return "₂"; case '3': return "₃";
-    case '4': return "₄"; case '5': return "₅"; case '6': return "₆"; case '7': return "₇";
-    case '8': return "₈"; case '9': return "₉"; case '+': return "₊"; case '-': return "₋";
-    case '=': return "₌"; case '(': return "₍"; case ')': return "₎";
-    case 'a': return "ₐ"; case 'e': return "ₑ"; case 'o': return "ₒ"; case 'x': return "ₓ";
-    case 'h': return "ₕ"; case 'k': return "ₖ"; case 'l': return "ₗ"; case 'm': return "ₘ";
-    case 'n': return "ₙ"; case 'p': return "ₚ"; case 's': return "ₛ"; case 't': return "ₜ";
-    default: return NULL;
+static int emit_sub(struct mbuf *b, const char *s, size_t len, int unicode, int is_source, struct mctx *cx) {
+    return emit_script(b, s, len, mdvic_math_sub, '_', unicode, is_source, cx);
+}
+
+/* Font commands map ASCII through the Mathematical Alphanumeric tables. */
+struct font_cmd { const char *name; const char *const *tbl; };
+
+static const struct font_cmd font_cmds[] = {
+    {"mathbb", mdvic_math_bb}, {"mathbf", mdvic_math_bf}, {"mathit", mdvic_math_it},
+    {"mathcal", mdvic_math_cal}, {"mathscr", mdvic_math_cal}, {"mathfrak", mdvic_math_frak},
+    {"mathsf", mdvic_math_sf}, {"mathtt", mdvic_math_tt}, {"mathrm", NULL},
+    {NULL, NULL}
+};
+
+static const struct font_cmd *find_font_cmd(const char *name) {
+    if (strncmp(name, "math", 4) != 0) return NULL;
+    for (const struct font_cmd *f = font_cmds; f->name; f++) {
+        if (strcmp(name, f->name) == 0) return f;
     }
+    return NULL;
 }
 
-static int emit_sup(struct mbuf *b, const char *s, size_t len, int unicode) {
-    if (!unicode) {
-        if (mb_putc(b, '^') != 0) return -1;
-        if (len > 1) { if (mb_putc(b, '(') != 0) return -1; }
-        if (mb_grow(b, len) != 0) return -1; memcpy(b->p + b->n, s, len); b->n += len; b->p[b->n] = '\0';
-        if (len > 1) { if (mb_putc(b, ')') != 0) return -1; }
-        return 0;
+static int mb_put_styled(struct mbuf *out, const char *s, size_t len, const char *const *tbl) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        const char *m = (tbl && c < 128) ? tbl[c] : NULL;
+        if ((m ? mb_puts(out, m) : mb_putc(out, (char)c)) != 0) return -1;
     }
-    size_t i;
-    for (i = 0; i < len; i++) {
-        const char *m = sup_char((unsigned char)s[i]);
-        if (m) { if (mb_puts(b, m) != 0) return -1; }
-        else { if (mb_putc(b, s[i]) != 0) return -1; }
+    return 0;
+}
+
+/* ---------------- Matrix environments ---------------- */
+
+struct matrix_env {
+    const char *name;
+    const char *l_uni, *r_uni; /* delimiters; "" for none */
+    const char *l_ascii, *r_ascii;
+};
+
+static const struct matrix_env matrix_envs[] = {
+    {"matrix", "", "", "", ""},
+    {"smallmatrix", "", "", "", ""},
+    {"pmatrix", "(", ")", "(", ")"},
+    {"bmatrix", "[", "]", "[", "]"},
+    {"Bmatrix", "{", "}", "{", "}"},
+    {"vmatrix", "|", "|", "|", "|"},
+    {"Vmatrix", "‖", "‖", "||", "||"},
+    {"cases", "{", "", "{", ""},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static const struct matrix_env *find_matrix_env(const char *name, size_t len) {
+    for (const struct matrix_env *e = matrix_envs; e->name; e++) {
+        if (strlen(e->name) == len && strncmp(e->name, name, len) == 0) return e;
     }
+    return NULL;
+}
+
+/* One cell: its source slice, then where its rendering lives in the shared buffer. */
+struct mcell { size_t src, src_len; size_t row; size_t col; size_t off, len, width; };
+
+struct mcells { struct mcell *v; size_t n, cap; };
+
+static int mcells_push(struct mcells *c, size_t src, size_t len, size_t row, size_t col) {
+    if (c->n == c->cap) {
+        size_t ncap = c->cap ? c->cap * 2 : 16;
+        struct mcell *nv = (struct mcell *)realloc(c->v, ncap * sizeof(*nv));
+        if (!nv) return -1;
+        c->v = nv; c->cap = ncap;
+    }
+    struct mcell *m = &c->v[c->n++];
+    m->src = src; m->src_len = len; m->row = row; m->col = col; m->off = 0; m->len = 0; m->width = 0;
     return 0;
 }
-static int emit_sub(struct mbuf *b, const char *s, size_t len, int unicode) {
-    if (!unicode) {
-        if (mb_putc(b, '_') != 0) return -1;
-        if (len > 1) { if (mb_putc(b, '(') != 0) return -1; }
-        if (mb_grow(b, len) != 0) return -1; memcpy(b->p + b->n, s, len); b->n += len; b->p[b->n] = '\0';
-        if (len > 1) { if (mb_putc(b, ')') != 0) return -1; }
-        return 0;
+
+static int is_blank_span(const char *s, size_t len) {
+    for (size_t i = 0; i < len; i++) if (s[i] != ' ' && s[i] != '\t' && s[i] != '\n') return 0;
+    return 1;
+}
+
+/* Split the body of a matrix-like environment into cells in one pass. `&` and
+ * `\\` only count at brace depth 0 outside nested environments; the scan
+ * stops at the matching \end{...}. Returns the body end; *after is set past
+ * the \end{...} (or to n when it is missing). */
+static int split_matrix(const char *s, size_t n, size_t start, struct mcells *cells, size_t *body_end, size_t *after) {
+    size_t i = start, seg = start, row = 0, col = 0; int depth = 0, envs = 0;
+    *body_end = n; *after = n;
+    while (i < n) {
+        char c = s[i];
+        if (c == '{') { depth++; i++; continue; }
+        if (c == '}') { if (depth > 0) depth--; i++; continue; }
+        if (c == '&' && depth == 0 && envs == 0) {
+            if (mcells_push(cells, seg, i - seg, row, col) != 0) return -1;
+            col++; i++; seg = i; continue;
+        }
+        if (c != '\\') { i++; continue; }
+        if (i + 1 < n && s[i + 1] == '\\') {
+            if (depth == 0 && envs == 0) {
+                if (mcells_push(cells, seg, i - seg, row, col) != 0) return -1;
+                row++; col = 0; seg = i + 2;
+            }
+            i += 2; continue;
+        }
+        size_t k = i + 1; while (k < n && ((s[k] >= 'a' && s[k] <= 'z') || (s[k] >= 'A' && s[k] <= 'Z'))) k++;
+        if (k == i + 1) { i += (i + 1 < n) ? 2 : 1; continue; } /* \&, \{, ... */
+        if (k - i - 1 == 5 && strncmp(s + i + 1, "begin", 5) == 0) { envs++; i = k; continue; }
+        if (k - i - 1 == 3 && strncmp(s + i + 1, "end", 3) == 0) {
+            if (envs > 0) { envs--; i = k; continue; }
+            *body_end = i;
+            size_t e = k; if (e < n && s[e] == '{') { while (e < n && s[e] != '}') e++; if (e < n) e++; }
+            *after = e;
+            break;
+        }
+        i = k;
     }
-    size_t i;
-    for (i = 0; i < len; i++) {
-        const char *m = sub_char((unsigned char)s[i]);
-        if (m) { if (mb_puts(b, m) != 0) return -1; }
-        else { if (mb_putc(b, s[i]) != 0) return -1; }
+    /* Last cell, unless it is the blank tail after a trailing \\ */
+    if (!(col == 0 && row > 0 && is_blank_span(s + seg, *body_end - seg))) {
+        if (mcells_push(cells, seg, *body_end - seg, row, col) != 0) return -1;
     }
     return 0;
 }
 
-static int render_subexpr(const char *s, size_t len, struct mbuf *out, const struct MdvicOptions *opt);
+/* Render a matrix-like environment. Cells are stored row-major in one array
+ * and their renderings in one buffer; widths are display columns. Linear in
+ * the number of cells plus the body length. */
+static int render_matrix(const char *s, size_t n, size_t *pos, const struct matrix_env *env,
+                         struct mbuf *out, struct mctx *cx) {
+    const struct MdvicOptions *opt = cx->opt;
+    int ascii = (opt && opt->math_mode == MDVIC_MATH_ASCII);
+    const char *L = ascii ? env->l_ascii : env->l_uni;
+    const char *R = ascii ? env->r_ascii : env->r_uni;
+    struct mcells cells = {0};
+    size_t body_end = n, after = n;
+    if (split_matrix(s, n, *pos, &cells, &body_end, &after) != 0) { free(cells.v); return -1; }
+    *pos = after;
+
+    /* Render every cell inline into one buffer. */
+    int saved_hint = cx->display; cx->display = 0;
+    struct mbuf text = { NULL, 0, 0, cx };
+    size_t ncols = 0, nrows = 0;
+    for (size_t k = 0; k < cells.n; k++) {
+        struct mcell *m = &cells.v[k];
+        m->off = text.n;
+        if (render_subexpr(s + m->src, m->src_len, &text, cx) != 0) { cx->display = saved_hint; free(text.p); free(cells.v); return -1; }
+        m->len = text.n - m->off;
+        m->width = disp_width(text.p ? text.p + m->off : "", m->len);
+        if (m->col + 1 > ncols) ncols = m->col + 1;
+        if (m->row + 1 > nrows) nrows = m->row + 1;
+    }
+    cx->display = saved_hint;
+    const char *tp = text.p ? text.p : "";
+    int rc = 0;
+
+    if (!cx->display) {
+        /* Inline: L a b ; c d R */
+        if (*L) { mb_puts(out, L); mb_putc(out, ' '); }
+        for (size_t k = 0; k < cells.n; k++) {
+            const struct mcell *m = &cells.v[k];
+            if (k > 0) mb_puts(out, (m->col == 0) ? "; " : " ");
+            if (mb_grow(out, m->len) != 0) { rc = -1; break; }
+            memcpy(out->p + out->n, tp + m->off, m->len); out->n += m->len; out->p[out->n] = '\0';
+        }
+        if (*R) { mb_putc(out, ' '); mb_puts(out, R); }
+        free(text.p); free(cells.v);
+        return rc;
+    }
+
+    /* Display: one line per row, columns padded to their widest cell. */
+    size_t *colw = (size_t *)calloc(ncols ? ncols : 1, sizeof(size_t));
+    if (!colw) { free(text.p); free(cells.v); return -1; }
+    for (size_t k = 0; k < cells.n; k++) if (cells.v[k].width > colw[cells.v[k].col]) colw[cells.v[k].col] = cells.v[k].width;
+    /* Later rows line up under the first when the matrix follows other text. */
+    size_t line_start = out->n;
+    while (line_start > 0 && out->p[line_start - 1] != '\n') line_start--;
+    size_t lead = out->n > line_start ? disp_width(out->p + line_start, out->n - line_start) : 0;
+    size_t k = 0;
+    for (size_t r = 0; r < nrows && rc == 0; r++) {
+        if (r > 0) for (size_t i = 0; i < lead; i++) mb_putc(out, ' ');
+        if (*L) { mb_puts(out, L); mb_putc(out, ' '); }
+        for (size_t c = 0; c < ncols; c++) {
+            size_t w = 0;
+            if (k < cells.n && cells.v[k].row == r && cells.v[k].col == c) {
+                const struct mcell *m = &cells.v[k++];
+                if (mb_grow(out, m->len) != 0) { rc = -1; break; }
+                memcpy(out->p + out->n, tp + m->off, m->len); out->n += m->len; out->p[out->n] = '\0';
+                w = m->width;
+            }
+            /* Pad all but the last column; keep the right delimiter aligned. */
+            if (c + 1 < ncols || *R) { for (; w < colw[c]; w++) mb_putc(out, ' '); }
+            if (c + 1 < ncols) mb_putc(out, ' ');
+        }
+        if (*R) { mb_putc(out, ' '); mb_puts(out, R); }
+        else { while (out->n > 0 && out->p[out->n - 1] == ' ') out->p[--out->n] = '\0'; }
+        mb_putc(out, '\n');
+    }
+    free(colw); free(text.p); free(cells.v);
+    return rc;
+}
 
 static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out,
-                          const struct MdvicOptions *opt) {
+                          struct mctx *cx) {
+    const struct MdvicOptions *opt = cx->opt;
     size_t i = *pos + 1;
     size_t start = i;
     while (i < n && ((s[i] >= 'a' && s[i] <= 'z') || (s[i] >= 'A' && s[i] <= 'Z'))) i++;
@@ -180,7 +404,7 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
         const char *needle = "\\right"; const char *pend = NULL; size_t nn = strlen(needle);
         for (size_t k=*pos; k+nn <= n; k++) { if (strncmp(s+k, needle, nn)==0) { pend = s + k; break; } }
         size_t content_len = pend ? (size_t)(pend - (s + *pos)) : (n - *pos); if (content_len > 65536) content_len = 65536;
-        struct mbuf inner = {0}; render_subexpr(s + *pos, content_len, &inner, opt);
+        struct mbuf inner = { NULL, 0, 0, cx }; render_subexpr(s + *pos, content_len, &inner, cx);
         if (ol) { mb_puts(out, ol); } else { mb_putc(out, od?od:'('); }
         mb_puts(out, inner.p?inner.p:"");
         const char *cr = NULL; char rchar = 0;
@@ -191,6 +415,25 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
         else { *pos = n; }
         return 0;
     }
+    /* \mathbb{R}, \mathbf x, ... */
+    const struct font_cmd *fc = find_font_cmd(name);
+    if (fc) {
+        size_t astart = *pos, alen = 0;
+        while (*pos < n && s[*pos] == ' ') (*pos)++;
+        if (*pos < n && s[*pos] == '{') {
+            astart = ++(*pos); int depth = 1;
+            while (*pos < n && depth) { if (s[*pos] == '{') depth++; else if (s[*pos] == '}') depth--; (*pos)++; }
+            alen = (*pos - astart) - (depth == 0 ? 1 : 0);
+        } else if (*pos < n) {
+            astart = (*pos)++; alen = 1;
+        }
+        struct mbuf arg = { NULL, 0, 0, cx };
+        int rc = render_subexpr(s + astart, alen, &arg, cx);
+        int unicode = (!opt || opt->math_mode == MDVIC_MATH_UNICODE);
+        if (rc == 0) rc = mb_put_styled(out, arg.p, arg.n, unicode ? fc->tbl : NULL);
+        free(arg.p);
+        return rc;
+    }
     /* Greek */
     const struct map *m;
     for (m = greek_map; m->key; m++) {
@@ -312,7 +555,7 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
         int ascii = (opt && opt->math_mode == MDVIC_MATH_ASCII);
         const char *sym = (!ascii) ? ((name[0]=='s')?"∑":"∏") : ((name[0]=='s')?"sum":"prod");
         /* capture following _{...} and ^{...} if present */
-        struct mbuf sub = {0}, sup = {0};
+        struct mbuf sub = { NULL, 0, 0, cx }, sup = { NULL, 0, 0, cx };
         for (int iter=0; iter<2; iter++) {
             if (*pos < n && (s[*pos] == '_' || s[*pos] == '^')) {
                 int is_sub = (s[*pos] == '_');
@@ -320,7 +563,7 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
                 if (*pos < n && s[*pos] == '{') {
                     size_t start = ++(*pos); int depth = 1; while (*pos < n && depth) { if (s[*pos]=='{') depth++; else if (s[*pos]=='}') depth--; (*pos)++; }
                     size_t glen = (*pos - start) - 1;
-                    struct mbuf tmp = {0}; render_subexpr(s + start, glen, &tmp, opt);
+                    struct mbuf tmp = { NULL, 0, 0, cx }; render_subexpr(s + start, glen, &tmp, cx);
                     if (is_sub) { mb_puts(&sub, tmp.p?tmp.p:""); }
                     else { mb_puts(&sup, tmp.p?tmp.p:""); }
                     free(tmp.p);
@@ -331,7 +574,7 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
                 }
             }
         }
-        if (g_display_hint) {
+        if (cx->display) {
             if (sup.p && sup.n) { mb_puts(out, sup.p); mb_putc(out, '\n'); }
             mb_puts(out, sym); mb_putc(out, '\n');
             if (sub.p && sub.n) { mb_puts(out, sub.p); mb_putc(out, '\n'); }
@@ -339,8 +582,8 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
             while (*pos < n && s[*pos] == ' ') (*pos)++;
         } else {
             mb_puts(out, sym);
-            if (sub.p && sub.n) { if (emit_sub(out, sub.p, sub.n, !ascii) != 0) { free(sub.p); free(sup.p); return -1; } }
-            if (sup.p && sup.n) { if (emit_sup(out, sup.p, sup.n, !ascii) != 0) { free(sub.p); free(sup.p); return -1; } }
+            if (sub.p && sub.n) { if (emit_sub(out, sub.p, sub.n, !ascii, 0, cx) != 0) { free(sub.p); free(sup.p); return -1; } }
+            if (sup.p && sup.n) { if (emit_sup(out, sup.p, sup.n, !ascii, 0, cx) != 0) { free(sub.p); free(sup.p); return -1; } }
         }
         free(sub.p); free(sup.p);
         return 0;
@@ -372,7 +615,7 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
         const char *needle = "\\right"; const char *pend = NULL; size_t nn = strlen(needle);
         for (size_t k=*pos; k+nn <= n; k++) { if (strncmp(s+k, needle, nn)==0) { pend = s + k; break; } }
         size_t content_len = pend ? (size_t)(pend - (s + *pos)) : (n - *pos); if (content_len > 65536) content_len = 65536;
-        struct mbuf inner = {0}; render_subexpr(s + *pos, content_len, &inner, opt);
+        struct mbuf inner = { NULL, 0, 0, cx }; render_subexpr(s + *pos, content_len, &inner, cx);
         if (ol) { mb_puts(out, ol); } else { mb_putc(out, od?od:'('); }
         mb_puts(out, inner.p?inner.p:"");
         const char *cr = NULL; char rchar = 0;
@@ -420,11 +663,11 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
         if (*pos < n && s[*pos] == '[') {
             size_t j = *pos + 1; size_t idx_start = j; while (j < n && s[j] != ']') j++; size_t idx_len = (j < n) ? (j - idx_start) : 0; *pos = (j < n) ? (j + 1) : j;
             if (ascii) {
-                mb_puts(out, "root["); if (idx_len) { mb_grow(out, idx_len); memcpy(out->p + out->n, s + idx_start, idx_len); out->n += idx_len; out->p[out->n] = '\0'; } mb_puts(out, "]");
+                mb_puts(out, "root["); if (idx_len) { if (mb_grow(out, idx_len) != 0) return -1; memcpy(out->p + out->n, s + idx_start, idx_len); out->n += idx_len; out->p[out->n] = '\0'; } mb_puts(out, "]");
                 ascii_root_prefix = 1;
             } else {
                 /* superscript index */
-                emit_sup(out, s + idx_start, idx_len, 1);
+                emit_sup(out, s + idx_start, idx_len, 1, 1, cx);
             }
         }
         if (*pos < n && s[*pos] == '{') {
@@ -434,13 +677,13 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
             if (ascii) {
                 if (ascii_root_prefix) {
                     mb_putc(out, '(');
-                    struct mbuf tmp = {0}; render_subexpr(s + startc, arglen, &tmp, opt); mb_puts(out, tmp.p ? tmp.p : ""); free(tmp.p);
+                    struct mbuf tmp = { NULL, 0, 0, cx }; render_subexpr(s + startc, arglen, &tmp, cx); mb_puts(out, tmp.p ? tmp.p : ""); free(tmp.p);
                     mb_putc(out, ')');
                 } else {
-                    mb_puts(out, "sqrt("); struct mbuf tmp = {0}; render_subexpr(s + startc, arglen, &tmp, opt); mb_puts(out, tmp.p ? tmp.p : ""); free(tmp.p); mb_putc(out, ')');
+                    mb_puts(out, "sqrt("); struct mbuf tmp = { NULL, 0, 0, cx }; render_subexpr(s + startc, arglen, &tmp, cx); mb_puts(out, tmp.p ? tmp.p : ""); free(tmp.p); mb_putc(out, ')');
                 }
             } else {
-                mb_puts(out, "√("); struct mbuf tmp = {0}; render_subexpr(s + startc, arglen, &tmp, opt); mb_puts(out, tmp.p ? tmp.p : ""); free(tmp.p); mb_putc(out, ')');
+                mb_puts(out, "√("); struct mbuf tmp = { NULL, 0, 0, cx }; render_subexpr(s + startc, arglen, &tmp, cx); mb_puts(out, tmp.p ? tmp.p : ""); free(tmp.p); mb_putc(out, ')');
             }
             return 0;
         }
@@ -454,12 +697,12 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
             if (*pos < n && s[*pos] == '{') {
                 (*pos)++; depth = 1; size_t bstart = *pos; while (*pos < n && depth) { if (s[*pos] == '{') depth++; else if (s[*pos] == '}') depth--; (*pos)++; }
                 size_t blen = (*pos - bstart) - 1;
-                struct mbuf num = {0}, den = {0};
-                render_subexpr(s + astart, alen, &num, opt);
-                render_subexpr(s + bstart, blen, &den, opt);
+                struct mbuf num = { NULL, 0, 0, cx }, den = { NULL, 0, 0, cx };
+                render_subexpr(s + astart, alen, &num, cx);
+                render_subexpr(s + bstart, blen, &den, cx);
                 size_t nlen = disp_len(num.p), dlen = disp_len(den.p);
                 int ascii = (opt && opt->math_mode == MDVIC_MATH_ASCII);
-                int stacked = g_display_hint ? 1 : 0;
+                int stacked = cx->display ? 1 : 0;
                 if (stacked) {
                     size_t w = nlen > dlen ? nlen : dlen;
                     if (out->n && out->p[out->n-1] != '\n') mb_putc(out, '\n');
@@ -478,80 +721,15 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
         return mb_puts(out, "frac");
     }
     if (strcmp(name, "begin") == 0) {
-        /* expect {pmatrix}...\end{pmatrix} */
         if (*pos < n && s[*pos] == '{') {
             size_t type_start = *pos + 1; size_t j = type_start; while (j < n && s[j] != '}') j++;
-            size_t tlen = (j < n) ? (j - type_start) : 0; *pos = (j < n) ? (j + 1) : j;
-            int is_p = (tlen == 7 && strncmp(s + type_start, "pmatrix", 7) == 0);
-            int is_b = (tlen == 7 && strncmp(s + type_start, "bmatrix", 7) == 0);
-            int is_v = (tlen == 7 && strncmp(s + type_start, "vmatrix", 7) == 0);
-            if (is_p || is_b || is_v) {
-                /* find \end{pmatrix} from *pos */
-                const char *needle = is_p?"\\end{pmatrix}": (is_b?"\\end{bmatrix}":"\\end{vmatrix}"); const char *pend = NULL; size_t nn = strlen(needle);
-                for (size_t k=*pos; k+nn <= n; k++) { if (strncmp(s+k, needle, nn)==0) { pend = s + k; break; } }
-                size_t content_len = pend ? (size_t)(pend - (s + *pos)) : (n - *pos);
-                if (content_len > 32768) content_len = 32768; /* safety cap */
-                int ascii = (opt && opt->math_mode == MDVIC_MATH_ASCII);
-                if (!g_display_hint) {
-                    /* Inline simple: ( a b ; c d ) */
-                    char l = is_p?'(' : (is_b?'[' : '|'); char r = is_p?')' : (is_b?']' : '|');
-                    mb_putc(out, l); mb_putc(out, ' ');
-                    for (size_t pcur=0; pcur < content_len; pcur++) {
-                        char ch = s[*pos + pcur];
-                        if (ch == '\\') { mb_puts(out, "; "); if (pcur+1<content_len && s[*pos+pcur+1]=='\\') pcur++; }
-                        else if (ch == '&') { mb_putc(out, ' '); }
-                        else if (ch == '{' || ch == '}') { /* skip */ }
-                        else { mb_putc(out, ch); }
-                    }
-                    mb_putc(out, ' '); mb_putc(out, r);
-                    if (pend) { *pos = (size_t)(pend - s) + nn; }
-                    return 0;
-                } else {
-                    /* Display: multi-line with padding */
-                    /* Parse into cells */
-                    size_t idx = *pos; const size_t end = *pos + content_len;
-                    size_t rows_cap=8, rows_n=0; int cols_max=0;
-                    struct mbuf **cells = (struct mbuf**)calloc(rows_cap,sizeof(*cells));
-                    int *col_counts = (int*)calloc(rows_cap,sizeof(int));
-                    while (idx < end && rows_n < 64) {
-                        size_t row_end = idx;
-                        while (row_end < end) { if (s[row_end] == '\\') { if (row_end+1<end && s[row_end+1]=='\\') break; else break; } row_end++; }
-                        int row_cols_cap=8, row_cols=0; struct mbuf *row = (struct mbuf*)calloc((size_t)row_cols_cap, sizeof(*row));
-                        size_t seg = idx;
-                        for (size_t pcur = idx; pcur <= row_end && row_cols < 32; pcur++) {
-                            if (pcur == row_end || s[pcur] == '&') {
-                                struct mbuf cell = {0}; render_subexpr(s + seg, pcur - seg, &cell, opt);
-                                if (row_cols == row_cols_cap) { row_cols_cap*=2; row = (struct mbuf*)realloc(row, (size_t)row_cols_cap*sizeof(*row)); }
-                                row[row_cols++] = cell; seg = pcur + 1;
-                            }
-                        }
-                        if (rows_n == rows_cap) { rows_cap*=2; cells = (struct mbuf**)realloc(cells, (size_t)rows_cap*sizeof(*cells)); col_counts = (int*)realloc(col_counts,(size_t)rows_cap*sizeof(int)); }
-                        cells[rows_n] = row; col_counts[rows_n] = row_cols; if (row_cols > cols_max) cols_max=row_cols; rows_n++;
-                        idx = (row_end < end) ? ( (row_end+1<end && s[row_end+1]=='\\') ? row_end+2 : row_end+1 ) : row_end;
-                    }
-                    int *colw = (int*)calloc((size_t)cols_max, sizeof(int));
-                    for (size_t r=0; r<rows_n; r++) for (int c=0; c<col_counts[r]; c++) { int w=(int)disp_len(cells[r][c].p); if (w>colw[c]) colw[c]=w; }
-                    const char *ltop = is_p?"(": (is_b?"[":"|"); const char *lmid = ltop; const char *lbot = ltop;
-                    const char *rtop = is_p?")": (is_b?"]":"|"); const char *rmid = rtop; const char *rbot = rtop;
-                    for (size_t r=0; r<rows_n; r++) {
-                        const char *L = (r==0)? ltop : (r==rows_n-1? lbot : lmid);
-                        const char *R = (r==0)? rtop : (r==rows_n-1? rbot : rmid);
-                        mb_puts(out, L); mb_putc(out, ' ');
-                        for (int c=0; c<cols_max; c++) {
-                            const char *txt = (c<col_counts[r] && cells[r][c].p)?cells[r][c].p:"";
-                            mb_puts(out, txt);
-                            int pad = colw[c] - (int)disp_len(txt);
-                            for (int k=0;k<pad;k++) mb_putc(out, ' ');
-                            if (c!=cols_max-1) mb_putc(out, ' ');
-                        }
-                        mb_putc(out, ' '); mb_puts(out, R); mb_putc(out,'\n');
-                    }
-                    for (size_t r=0;r<rows_n;r++) { for (int c=0;c<col_counts[r];c++) free(cells[r][c].p); free(cells[r]); }
-                    free(cells); free(col_counts); free(colw);
-                    if (pend) { *pos = (size_t)(pend - s) + nn; }
-                    return 0;
-                }
+            size_t tlen = (j < n) ? (j - type_start) : 0;
+            const struct matrix_env *env = find_matrix_env(s + type_start, tlen);
+            if (env) {
+                *pos = (j < n) ? (j + 1) : j;
+                return render_matrix(s, n, pos, env, out, cx);
             }
+            *pos = (j < n) ? (j + 1) : j;
         }
         return mb_puts(out, "begin");
     }
@@ -559,51 +737,295 @@ static int render_command(const char *s, size_t n, size_t *pos, struct mbuf *out
     return mb_puts(out, name);
 }
 
-static int render_subexpr(const char *s, size_t len, struct mbuf *out, const struct MdvicOptions *opt) {
-    size_t i = 0; int unicode = (!opt || opt->math_mode == MDVIC_MATH_UNICODE);
-    while (i < len) {
-        char c = s[i];
-        if (c == '\\') { if (render_command(s, len, &i, out, opt) != 0) return -1; continue; }
-        else if (c == '^' || c == '_') { int is_sup = (c == '^'); i++; if (i < len && s[i] == '{') { size_t start = ++i; int depth = 1; while (i < len && depth) { if (s[i] == '{') depth++; else if (s[i] == '}') depth--; i++; } size_t clen = (i - start) - 1; if (is_sup) { if (emit_sup(out, s + start, clen, unicode) != 0) return -1; } else { if (emit_sub(out, s + start, clen, unicode) != 0) return -1; } continue; } else if (i < len) { if (is_sup) { if (emit_sup(out, s + i, 1, unicode) != 0) return -1; } else { if (emit_sub(out, s + i, 1, unicode) != 0) return -1; } i++; continue; } }
-        if (mb_putc(out, c) != 0) return -1; i++;
-    }
-    return 0;
-}
-
-int mdvic_math_render(const char *s, size_t len, const struct MdvicOptions *opt,
-                      int display, char **out_str, size_t *out_len) {
-    struct mbuf out; out.p = NULL; out.n = 0; out.cap = 0;
-    g_display_hint = display ? 1 : 0;
-    size_t i = 0;
-    int unicode = (!opt || opt->math_mode == MDVIC_MATH_UNICODE);
-    while (i < len) {
+static int render_subexpr(const char *s, size_t len, struct mbuf *out, struct mctx *cx) {
+    if (cx->hit) return -1;
+    if (cx->lim.max_depth && cx->depth >= cx->lim.max_depth) { cx->hit = MDVIC_MATH_LIMIT_DEPTH; return -1; }
+    cx->depth++;
+    size_t i = 0; int unicode = (!cx->opt || cx->opt->math_mode == MDVIC_MATH_UNICODE); int rc = 0;
+    while (i < len && rc == 0) {
+        if (cx->hit) { rc = -1; break; }
+        if (cx->lim.max_tokens && ++cx->tokens > cx->lim.max_tokens) { cx->hit = MDVIC_MATH_LIMIT_TOKENS; rc = -1; break; }
         char c = s[i];
-        if (c == '\\') {
-            if (render_command(s, len, &i, &out, opt) != 0) { free(out.p); return -1; }
-            continue;
-        } else if (c == '^' || c == '_') {
+        if (c == '\\') { rc = render_command(s, len, &i, out, cx); continue; }
+        else if (c == '^' || c == '_') {
             int is_sup = (c == '^');
             i++;
             if (i < len && s[i] == '{') {
                 size_t start = ++i; int depth = 1;
                 while (i < len && depth) { if (s[i] == '{') depth++; else if (s[i] == '}') depth--; i++; }
                 size_t clen = (i - start) - 1;
-                if (is_sup) { if (emit_sup(&out, s + start, clen, unicode) != 0) { free(out.p); return -1; } }
-                else { if (emit_sub(&out, s + start, clen, unicode) != 0) { free(out.p); return -1; } }
+                rc = is_sup ? emit_sup(out, s + start, clen, unicode, 1, cx) : emit_sub(out, s + start, clen, unicode, 1, cx);
                 continue;
             } else if (i < len) {
-                if (is_sup) { if (emit_sup(&out, s + i, 1, unicode) != 0) { free(out.p); return -1; } }
-                else { if (emit_sub(&out, s + i, 1, unicode) != 0) { free(out.p); return -1; } }
-                i++;
+                /* a single token: one character or one \command */
+                size_t tlen = 1;
+                if (s[i] == '\\') { while (i + tlen < len && ((s[i + tlen] >= 'a' && s[i + tlen] <= 'z') || (s[i + tlen] >= 'A' && s[i + tlen] <= 'Z'))) tlen++; }
+                rc = is_sup ? emit_sup(out, s + i, tlen, unicode, 1, cx) : emit_sub(out, s + i, tlen, unicode, 1, cx);
+                i += tlen;
                 continue;
             }
         }
-        /* default: copy */
-        if (mb_putc(&out, c) != 0) { free(out.p); return -1; }
-        i++;
+        rc = mb_putc(out, c); i++;
+    }
+    cx->depth--;
+    return rc;
+}
+
+/* ---------------- Lint ---------------- */
+
+/* Whether render_command has a rendering for \name, rather than printing the
+ * bare name; the tables are matched by prefix, as there. */
+static int command_known(const char *name) {
+    static const char *const plain[] = {
+        "left", "right", "begin", "end", "text", "sum", "prod", "sqrt", "frac",
+        "hat", "bar", "tilde", "vec", "overline", "breve", "check", "acute", "grave",
+        "dot", "ddot", "underline", NULL
+    };
+    for (const char *const *p = plain; *p; p++) if (strcmp(name, *p) == 0) return 1;
+    if (find_font_cmd(name)) return 1;
+    for (const struct map *m = greek_map; m->key; m++) if (strncmp(name, m->key, strlen(m->key)) == 0) return 1;
+    for (const struct map *m = sym_map; m->key; m++) if (strncmp(name, m->key, strlen(m->key)) == 0) return 1;
+    for (size_t L = strlen(name); L > 0; L--) {
+        char tmp[32]; memcpy(tmp, name, L); tmp[L] = '\0';
+        if (func_map(tmp)) return 1;
+    }
+    return 0;
+}
+
+static size_t letters_at(const char *s, size_t n, size_t i) {
+    size_t j = i;
+    while (j < n && ((s[j] >= 'a' && s[j] <= 'z') || (s[j] >= 'A' && s[j] <= 'Z'))) j++;
+    return j - i;
+}
+
+/* After \left or \right: skip the delimiter render_command takes with it. */
+static size_t skip_delim(const char *s, size_t n, size_t i, int left) {
+    if (i >= n) return i;
+    if (s[i] != '\\') return i + 1;
+    size_t k = letters_at(s, n, i + 1);
+    static const char *const ldelims[] = { "langle", "lceil", "lfloor", NULL };
+    static const char *const rdelims[] = { "rangle", "rceil", "rfloor", NULL };
+    for (const char *const *d = left ? ldelims : rdelims; *d; d++)
+        if (strlen(*d) == k && strncmp(s + i + 1, *d, k) == 0) return i + 1 + k;
+    return left ? i : i + 1 + k;
+}
+
+/* {name} at i: points name and nlen at it and returns the offset after it, or i. */
+static size_t env_name_at(const char *s, size_t n, size_t i, const char **name, size_t *nlen) {
+    *name = ""; *nlen = 0;
+    if (i >= n || s[i] != '{') return i;
+    size_t j = i + 1; while (j < n && s[j] != '}') j++;
+    if (j >= n) return i;
+    *name = s + i + 1; *nlen = j - i - 1;
+    return j + 1;
+}
+
+#define CHECK_STACK 32
+
+int mdvic_math_check(const char *s, size_t n, mdvic_math_issue_fn fn, void *ctx) {
+    size_t lefts[CHECK_STACK]; int nleft = 0;
+    struct { size_t off; const char *name; size_t len; } envs[CHECK_STACK]; int nenv = 0;
+    int issues = 0; char msg[96];
+    size_t i = 0;
+    while (i < n) {
+        if (s[i] != '\\') { i++; continue; }
+        size_t at = i, clen = letters_at(s, n, i + 1);
+        if (clen == 0) { i += 2; continue; } /* \{, \, and friends */
+        char name[32]; size_t nl = clen < sizeof(name) ? clen : sizeof(name) - 1;
+        memcpy(name, s + i + 1, nl); name[nl] = '\0';
+        i += 1 + clen;
+        if (strcmp(name, "left") == 0) {
+            if (nleft < CHECK_STACK) lefts[nleft] = at;
+            nleft++;
+            i = skip_delim(s, n, i, 1);
+        } else if (strcmp(name, "right") == 0) {
+            if (nleft == 0) { fn(ctx, at, "math-group", "\\right without \\left"); issues++; }
+            else nleft--;
+            i = skip_delim(s, n, i, 0);
+        } else if (strcmp(name, "text") == 0) {
+            if (i < n && s[i] == '{') {
+                int depth = 1; i++;
+                while (i < n && depth) { if (s[i] == '{') depth++; else if (s[i] == '}') depth--; i++; }
+            }
+        } else if (strcmp(name, "begin") == 0) {
+            const char *env; size_t elen;
+            i = env_name_at(s, n, i, &env, &elen);
+            if (!find_matrix_env(env, elen)) {
+                snprintf(msg, sizeof(msg), "unknown math environment '%.*s'", (int)(elen > 32 ? 32 : elen), env);
+                fn(ctx, at, "math-command", msg); issues++;
+            }
+            if (nenv < CHECK_STACK) { envs[nenv].off = at; envs[nenv].name = env; envs[nenv].len = elen; }
+            nenv++;
+        } else if (strcmp(name, "end") == 0) {
+            const char *env; size_t elen;
+            i = env_name_at(s, n, i, &env, &elen);
+            if (nenv == 0) {
+                snprintf(msg, sizeof(msg), "\\end{%.*s} without \\begin", (int)(elen > 32 ? 32 : elen), env);
+                fn(ctx, at, "math-group", msg); issues++;
+            } else {
+                nenv--;
+                if (nenv < CHECK_STACK && (envs[nenv].len != elen || strncmp(envs[nenv].name, env, elen) != 0)) {
+                    snprintf(msg, sizeof(msg), "\\end{%.*s} does not match \\begin{%.*s}",
+                             (int)(elen > 32 ? 32 : elen), env, (int)(envs[nenv].len > 32 ? 32 : envs[nenv].len), envs[nenv].name);
+                    fn(ctx, at, "math-group", msg); issues++;
+                }
+            }
+        } else if (!command_known(name)) {
+            snprintf(msg, sizeof(msg), "unknown math command \\%s", name);
+            fn(ctx, at, "math-command", msg); issues++;
+        }
+    }
+    for (int k = nleft < CHECK_STACK ? nleft : CHECK_STACK; k-- > 0; ) {
+        fn(ctx, lefts[k], "math-group", "\\left without \\right"); issues++;
     }
+    for (int k = nenv < CHECK_STACK ? nenv : CHECK_STACK; k-- > 0; ) {
+        snprintf(msg, sizeof(msg), "\\begin{%.*s} is never closed", (int)(envs[k].len > 32 ? 32 : envs[k].len), envs[k].name);
+        fn(ctx, envs[k].off, "math-group", msg); issues++;
+    }
+    return issues;
+}
+
+int mdvic_math_render(const char *s, size_t len, const struct MdvicOptions *opt,
+                      int display, char **out_str, size_t *out_len) {
+    struct mctx cx;
+    memset(&cx, 0, sizeof(cx));
+    cx.opt = opt; cx.display = display ? 1 : 0;
+    if (opt) cx.lim = opt->math_limits;
+    struct mbuf out = { NULL, 0, 0, &cx };
+    int rc = render_subexpr(s, len, &out, &cx);
+    if (cx.hit) { free(out.p); return cx.hit; }
+    if (rc != 0) { free(out.p); return -1; }
     if (!out.p) { out.p = (char *)malloc(1); if (!out.p) return -1; out.p[0] = '\0'; }
     if (out_len) *out_len = out.n;
     *out_str = out.p;
     return 0;
 }
+
+const char *mdvic_math_limit_name(int limit) {
+    switch (limit) {
+    case MDVIC_MATH_LIMIT_DEPTH: return "nesting depth";
+    case MDVIC_MATH_LIMIT_TOKENS: return "token count";
+    case MDVIC_MATH_LIMIT_BYTES: return "output size";
+    default: return "limit";
+    }
+}
+
+/* ---------------- Per-document memoization ---------------- */
+
+struct mcache_entry {
+    char *key;      /* span bytes (not NUL-terminated) */
+    size_t key_len;
+    unsigned flags; /* display | math_mode | accent_group */
+    uint32_t hash;
+    char *val;      /* rendered bytes, NUL-terminated; NULL if limit is set */
+    size_t val_len;
+    int limit;      /* mdvic_math_limit the span tripped, or 0 */
+};
+
+struct MdvicMathCache {
+    struct mcache_entry *slots;
+    size_t nslots;     /* power of two */
+    size_t max_bytes;  /* cap on key+value bytes held */
+    size_t bytes;
+    size_t entries;
+    unsigned long hits;
+    unsigned long misses;
+    size_t cursor;     /* eviction clock hand */
+    char *scratch;     /* last oversized result, lent to the caller */
+};
+
+#define MCACHE_PROBE 8
+
+static uint32_t mcache_hash(const char *s, size_t len, unsigned flags) {
+    /* FNV-1a over the span, then the flags byte */
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) { h ^= (unsigned char)s[i]; h *= 16777619u; }
+    h ^= (uint32_t)flags; h *= 16777619u;
+    return h;
+}
+
+static unsigned mcache_flags(const struct MdvicOptions *opt, int display) {
+    unsigned f = display ? 1u : 0u;
+    if (opt && opt->math_mode == MDVIC_MATH_ASCII) f |= 2u;
+    if (opt && opt->accent_group) f |= 4u;
+    return f;
+}
+
+static void mcache_drop(struct MdvicMathCache *c, struct mcache_entry *e) {
+    if (!e->key) return;
+    c->bytes -= e->key_len + e->val_len;
+    c->entries--;
+    free(e->key); free(e->val);
+    e->key = NULL; e->val = NULL; e->key_len = 0; e->val_len = 0; e->limit = 0;
+}
+
+struct MdvicMathCache *mdvic_math_cache_new(size_t max_entries, size_t max_bytes) {
+    struct MdvicMathCache *c = (struct MdvicMathCache *)calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    size_t n = 16;
+    while (n < max_entries) n *= 2;
+    c->slots = (struct mcache_entry *)calloc(n, sizeof(*c->slots));
+    if (!c->slots) { free(c); return NULL; }
+    c->nslots = n;
+    c->max_bytes = max_bytes;
+    return c;
+}
+
+void mdvic_math_cache_free(struct MdvicMathCache *c) {
+    if (!c) return;
+    for (size_t i = 0; i < c->nslots; i++) { free(c->slots[i].key); free(c->slots[i].val); }
+    free(c->slots);
+    free(c->scratch);
+    free(c);
+}
+
+void mdvic_math_cache_stats(const struct MdvicMathCache *c, unsigned long *hits, unsigned long *misses) {
+    if (hits) *hits = c ? c->hits : 0;
+    if (misses) *misses = c ? c->misses : 0;
+}
+
+int mdvic_math_render_cached(struct MdvicMathCache *c, const char *s, size_t len,
+                             const struct MdvicOptions *opt, int display,
+                             const char **out_str, size_t *out_len) {
+    if (!c) return -1;
+    unsigned flags = mcache_flags(opt, display);
+    uint32_t h = mcache_hash(s, len, flags);
+    size_t mask = c->nslots - 1;
+    struct mcache_entry *victim = NULL;
+    for (size_t k = 0; k < MCACHE_PROBE; k++) {
+        struct mcache_entry *e = &c->slots[(h + k) & mask];
+        if (!e->key) { if (!victim) victim = e; continue; }
+        if (e->hash == h && e->flags == flags && e->key_len == len && memcmp(e->key, s, len) == 0) {
+            c->hits++;
+            if (e->limit) return e->limit;
+            *out_str = e->val; if (out_len) *out_len = e->val_len;
+            return 0;
+        }
+    }
+    c->misses++;
+    char *val = NULL; size_t vlen = 0;
+    int rc = mdvic_math_render(s, len, opt, display, &val, &vlen);
+    if (rc < 0) return -1;
+    if (len + vlen > c->max_bytes) {
+        if (rc > 0) return rc;
+        /* Too large to keep: lend it out until the next oversized miss. */
+        free(c->scratch); c->scratch = val;
+        *out_str = val; if (out_len) *out_len = vlen;
+        return 0;
+    }
+    if (!victim) { victim = &c->slots[h & mask]; mcache_drop(c, victim); }
+    /* Stay within the byte budget by evicting from a rotating cursor. */
+    while (c->bytes + len + vlen > c->max_bytes && c->entries > 0) {
+        struct mcache_entry *e = &c->slots[c->cursor++ & mask];
+        if (e->key) mcache_drop(c, e);
+    }
+    char *key = (char *)malloc(len ? len : 1);
+    if (!key) { free(val); return -1; }
+    memcpy(key, s, len);
+    victim->key = key; victim->key_len = len; victim->flags = flags; victim->hash = h;
+    victim->val = val; victim->val_len = vlen; victim->limit = rc;
+    c->bytes += len + vlen; c->entries++;
+    if (rc > 0) return rc;
+    *out_str = val; if (out_len) *out_len = vlen;
+    return 0;
+}
@@ -0,0 +1,462 @@
+/* Linear pre-pass that lifts $...$ / $$...$$ spans out of raw Markdown. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mdvic/mathspan.h"
+
+/* Runs longer than this never pair; they are left as literal text. */
+#define RUN_CAP 16
+
+struct tok { size_t pos; int len; int line; char kind; int next; };
+
+struct toks { struct tok *v; int n; int cap; };
+
+static int toks_push(struct toks *t, size_t pos, int len, int line, char kind) {
+    if (t->n == t->cap) {
+        int ncap = t->cap ? t->cap * 2 : 64;
+        struct tok *nv = (struct tok *)realloc(t->v, (size_t)ncap * sizeof(*nv));
+        if (!nv) return -1;
+        t->v = nv; t->cap = ncap;
+    }
+    struct tok *k = &t->v[t->n++];
+    k->pos = pos; k->len = len; k->line = line; k->kind = kind; k->next = -1;
+    return 0;
+}
+
+struct spanv {
+    struct MdvicMathSpan *v; size_t n; size_t cap;
+    struct MdvicMathDelim *lone; size_t lone_n, lone_cap; /* unpaired runs; kept when want_lone */
+    int want_lone;
+};
+
+static int spans_push(struct spanv *s, const struct MdvicMathSpan *sp) {
+    if (s->n == s->cap) {
+        size_t ncap = s->cap ? s->cap * 2 : 32;
+        struct MdvicMathSpan *nv = (struct MdvicMathSpan *)realloc(s->v, ncap * sizeof(*nv));
+        if (!nv) return -1;
+        s->v = nv; s->cap = ncap;
+    }
+    s->v[s->n++] = *sp;
+    return 0;
+}
+
+static int is_ascii_punct(unsigned char c) {
+    return (c >= 0x21 && c <= 0x2F) || (c >= 0x3A && c <= 0x40) || (c >= 0x5B && c <= 0x60) || (c >= 0x7B && c <= 0x7E);
+}
+
+static int lone_push(struct spanv *s, const struct tok *k) {
+    if (s->lone_n == s->lone_cap) {
+        size_t ncap = s->lone_cap ? s->lone_cap * 2 : 16;
+        struct MdvicMathDelim *nv = (struct MdvicMathDelim *)realloc(s->lone, ncap * sizeof(*nv));
+        if (!nv) return -1;
+        s->lone = nv; s->lone_cap = ncap;
+    }
+    struct MdvicMathDelim *d = &s->lone[s->lone_n++];
+    d->pos = k->pos; d->len = k->len; d->line = k->line;
+    return 0;
+}
+
+/* Link each token to the next token of the same kind and run length. */
+static void link_next_same(struct toks *t, char kind) {
+    int last[RUN_CAP + 1];
+    for (int k = 0; k <= RUN_CAP; k++) last[k] = -1;
+    for (int i = t->n - 1; i >= 0; i--) {
+        struct tok *k = &t->v[i];
+        if (k->kind != kind || k->len > RUN_CAP) continue;
+        k->next = last[k->len];
+        last[k->len] = i;
+    }
+}
+
+static size_t skip_container(const char *p, const char *end) {
+    const char *q = p;
+    while (q < end && (*q == ' ' || *q == '\t' || *q == '>')) q++;
+    return (size_t)(q - p);
+}
+
+static int is_alpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+static int is_alnum(char c) { return is_alpha(c) || (c >= '0' && c <= '9'); }
+
+/* Past spaces, tabs and at most one line end from src[i]. */
+static size_t skip_ws(const char *src, size_t i, size_t e) {
+    int nl = 0;
+    while (i < e && (src[i] == ' ' || src[i] == '\t' || (src[i] == '\n' && !nl++))) i++;
+    return i;
+}
+
+/* What may close a construct opened earlier in the segment. Each remembers
+ * its last search, so a run of openers without a closer costs one scan of
+ * the segment rather than one each. */
+enum { CL_COMMENT, CL_PI, CL_CDATA, CL_DECL, CL_DQUOTE, CL_SQUOTE, CL_PAREN, CL_N };
+static const char *const closer_str[CL_N] = { "-->", "?>", "]]>", ">", "\"", "'", ")" };
+#define NOT_FOUND ((size_t)-1)
+
+struct closers { size_t from[CL_N], at[CL_N]; };
+
+static void closers_init(struct closers *c) {
+    for (int k = 0; k < CL_N; k++) c->from[k] = c->at[k] = NOT_FOUND;
+}
+
+/* Offset just past the first closer k at or after i and before e, or 0.
+ * Quote and parenthesis closers skip backslash escapes. */
+static size_t find_closer(struct closers *c, int k, const char *src, size_t i, size_t e) {
+    size_t len = strlen(closer_str[k]);
+    if (c->from[k] == NOT_FOUND || c->from[k] > i || (c->at[k] != NOT_FOUND && c->at[k] < i)) {
+        size_t j = i;
+        for (; j + len <= e; j++) {
+            if (k >= CL_DQUOTE && src[j] == '\\' && j + 1 < e) { j++; continue; }
+            if (memcmp(src + j, closer_str[k], len) == 0) break;
+        }
+        c->from[k] = i; c->at[k] = j + len <= e ? j : NOT_FOUND;
+    }
+    return c->at[k] == NOT_FOUND ? 0 : c->at[k] + len;
+}
+
+/* Past a quoted string opened at src[i] ('"', '\'' or '('), or 0. */
+static size_t skip_quoted(struct closers *c, const char *src, size_t i, size_t e) {
+    int k = src[i] == '"' ? CL_DQUOTE : src[i] == '\'' ? CL_SQUOTE : CL_PAREN;
+    return find_closer(c, k, src, i + 1, e);
+}
+
+/* Past the autolink or raw HTML (tag, comment, processing instruction,
+ * declaration or CDATA) at src[i] == '<', or 0. */
+static size_t inline_tag_end(struct closers *c, const char *src, size_t i, size_t e) {
+    size_t j;
+    if (e - i < 3) return 0;
+    if (is_alpha(src[i + 1])) {
+        /* URI autolink: a scheme, ':', then no spaces or angle brackets */
+        for (j = i + 1; j < e && j - i <= 33 && (is_alnum(src[j]) || src[j] == '+' || src[j] == '.' || src[j] == '-'); j++) {}
+        if (j - i >= 3 && j < e && src[j] == ':') {
+            for (j++; j < e && (unsigned char)src[j] > 0x20 && src[j] != '<' && src[j] != '>'; j++) {}
+            if (j < e && src[j] == '>') return j + 1;
+        }
+    }
+    /* email autolink */
+    for (j = i + 1; j < e && (is_alnum(src[j]) || (src[j] && strchr(".!#$%&'*+/=?^_`{|}~-", src[j]))); j++) {}
+    if (j > i + 1 && j < e && src[j] == '@') {
+        size_t k = j + 1;
+        while (k < e && (is_alnum(src[k]) || src[k] == '-' || src[k] == '.')) k++;
+        if (k > j + 1 && k < e && src[k] == '>') return k + 1;
+    }
+    if (src[i + 1] == '?') return find_closer(c, CL_PI, src, i + 2, e);
+    if (src[i + 1] == '!') {
+        if (e - i >= 4 && src[i + 2] == '-' && src[i + 3] == '-') return find_closer(c, CL_COMMENT, src, i + 4, e);
+        if (e - i >= 9 && memcmp(src + i + 2, "[CDATA[", 7) == 0) return find_closer(c, CL_CDATA, src, i + 9, e);
+        return is_alpha(src[i + 2]) ? find_closer(c, CL_DECL, src, i + 2, e) : 0;
+    }
+    if (src[i + 1] == '/') { /* closing tag */
+        if (!is_alpha(src[i + 2])) return 0;
+        for (j = i + 3; j < e && (is_alnum(src[j]) || src[j] == '-'); j++) {}
+        j = skip_ws(src, j, e);
+        return j < e && src[j] == '>' ? j + 1 : 0;
+    }
+    if (!is_alpha(src[i + 1])) return 0;
+    /* open tag: a name, attributes, an optional '/' */
+    for (i += 2; i < e && (is_alnum(src[i]) || src[i] == '-'); i++) {}
+    for (;;) {
+        j = skip_ws(src, i, e);
+        if (j < e && src[j] == '>') return j + 1;
+        if (j + 1 < e && src[j] == '/' && src[j + 1] == '>') return j + 2;
+        if (j == i || j >= e || !(is_alpha(src[j]) || src[j] == '_' || src[j] == ':')) return 0;
+        for (i = j + 1; i < e && (is_alnum(src[i]) || (src[i] && strchr("_.:-", src[i]))); i++) {}
+        j = skip_ws(src, i, e);
+        if (j < e && src[j] == '=') {
+            j = skip_ws(src, j + 1, e);
+            if (j >= e) return 0;
+            if (src[j] == '"' || src[j] == '\'') { if (!(i = skip_quoted(c, src, j, e))) return 0; }
+            else {
+                for (i = j; i < e && !strchr(" \t\n\"'=<>`", src[i]); i++) {}
+                if (i == j) return 0;
+            }
+        }
+    }
+}
+
+/* Past an inline link's "(destination "title")" at src[i] == '(', or 0. */
+static size_t link_tail_end(struct closers *c, const char *src, size_t i, size_t e) {
+    i = skip_ws(src, i + 1, e);
+    if (i < e && src[i] == '<') {
+        for (i++; i < e && src[i] != '>' && src[i] != '<' && src[i] != '\n'; i++) if (src[i] == '\\' && i + 1 < e) i++;
+        if (i >= e || src[i] != '>') return 0;
+        i++;
+    } else {
+        int depth = 0; /* cmark stops nesting at 32 */
+        for (; i < e && (unsigned char)src[i] > 0x20; i++) {
+            if (src[i] == '\\' && i + 1 < e) { i++; continue; }
+            if (src[i] == '(' && ++depth > 32) return 0;
+            if (src[i] == ')' && depth-- == 0) break;
+        }
+    }
+    size_t j = skip_ws(src, i, e);
+    if (j > i && j < e && (src[j] == '"' || src[j] == '\'' || src[j] == '(')) {
+        if (!(j = skip_quoted(c, src, j, e))) return 0;
+        j = skip_ws(src, j, e);
+    }
+    return j < e && src[j] == ')' ? j + 1 : 0;
+}
+
+/* End of the line at src[i] if it holds a link reference definition: its
+ * destination is not text. Otherwise 0. */
+static size_t link_def_end(const char *src, size_t i, size_t e) {
+    for (int sp = 0; i < e && sp < 3 && src[i] == ' '; sp++) i++;
+    if (i >= e || src[i] != '[') return 0;
+    for (i++; i < e && src[i] != ']' && src[i] != '\n'; i++) if (src[i] == '\\' && i + 1 < e) i++;
+    if (i + 1 >= e || src[i] != ']' || src[i + 1] != ':') return 0;
+    const char *nl = (const char *)memchr(src + i, '\n', e - i);
+    return nl ? (size_t)(nl - src) : e;
+}
+
+/* Pair code spans first (they win over math, as in cmark), then dollars.
+ * Autolinks, raw HTML and link destinations are passed over whole: their
+ * dollars are never math, and cmark prints them as they are. */
+static int scan_segment(const char *src, size_t s, size_t e, int line, struct toks *t, struct spanv *out) {
+    struct closers cl;
+    closers_init(&cl);
+    t->n = 0;
+    size_t i = s;
+    while (i < e) {
+        char c = src[i];
+        size_t past = 0;
+        if (i == s || src[i - 1] == '\n') past = link_def_end(src, i + skip_container(src + i, src + e), e);
+        if (!past && c == '<') past = inline_tag_end(&cl, src, i, e);
+        else if (!past && c == ']' && i + 1 < e && src[i + 1] == '(') past = link_tail_end(&cl, src, i + 1, e);
+        if (past) {
+            for (; i < past; i++) if (src[i] == '\n') line++;
+            continue;
+        }
+        if (c == '\n') { line++; i++; continue; }
+        if (c == '\\' && i + 1 < e && is_ascii_punct((unsigned char)src[i + 1])) { i += 2; continue; }
+        if (c == '`' || c == '$') {
+            size_t j = i; while (j < e && src[j] == c) j++;
+            if (toks_push(t, i, (int)(j - i), line, c) != 0) return -1;
+            i = j; continue;
+        }
+        i++;
+    }
+    link_next_same(t, '`');
+    /* Drop backtick pairs and everything they enclose from the dollar list. */
+    int w = 0;
+    for (int k = 0; k < t->n; k++) {
+        struct tok *tk = &t->v[k];
+        if (tk->kind == '`') {
+            if (tk->next >= 0) k = tk->next;
+            continue;
+        }
+        t->v[w] = *tk; t->v[w].next = -1; w++;
+    }
+    t->n = w;
+    link_next_same(t, '$');
+    for (int k = 0; k < t->n; k++) {
+        struct tok *open = &t->v[k];
+        int pairs = open->next >= 0 && !(open->len == 1 && t->v[open->next].line != open->line);
+        if (!pairs) {
+            if (out->want_lone && lone_push(out, open) != 0) return -1;
+            continue;
+        }
+        struct tok *close = &t->v[open->next];
+        struct MdvicMathSpan sp;
+        sp.raw = src + open->pos;
+        sp.raw_len = close->pos + (size_t)close->len - open->pos;
+        sp.tex = src + open->pos + (size_t)open->len;
+        sp.tex_len = close->pos - (open->pos + (size_t)open->len);
+        sp.display = open->len >= 2;
+        sp.line = open->line;
+        if (spans_push(out, &sp) != 0) return -1;
+        k = open->next;
+    }
+    return 0;
+}
+
+/* Columns of indentation of the line at p, after any block quote markers;
+ * *content gets where the text starts. */
+static int line_indent(const char *p, const char *end, const char **content) {
+    for (;;) {
+        const char *q = p;
+        while (q < end && *q == ' ' && q - p < 3) q++;
+        if (q >= end || *q != '>') break;
+        p = q + 1;
+        if (p < end && *p == ' ') p++;
+    }
+    int col = 0;
+    for (; p < end && (*p == ' ' || *p == '\t'); p++) col = *p == '\t' ? col + 4 - col % 4 : col + 1;
+    *content = p;
+    return col;
+}
+
+/* Width of the list item marker at p and the spaces after it, which is how
+ * far the item's content is indented past the marker; 0 if none. */
+static int list_marker_width(const char *p, const char *end) {
+    const char *q = p;
+    if (q < end && (*q == '-' || *q == '+' || *q == '*')) q++;
+    else {
+        while (q < end && q - p < 9 && *q >= '0' && *q <= '9') q++;
+        if (q == p || q >= end || (*q != '.' && *q != ')')) return 0;
+        q++;
+    }
+    if (q < end && *q != ' ' && *q != '\t') return 0;
+    int sp = 0;
+    while (q + sp < end && q[sp] == ' ') sp++;
+    return (int)(q - p) + (sp >= 1 && sp <= 4 && q + sp < end ? sp : 1);
+}
+
+/* Open list items, as the content column of each, innermost last. An
+ * indented line is code only 4 columns past the innermost item's content. */
+#define LIST_MAX 32
+struct lists { int col[LIST_MAX]; int n; };
+
+/* Identify segments: paragraphs-ish runs of lines, split at blank lines and
+ * code fences; fenced and indented code is skipped entirely. */
+static int find_spans(const char *src, size_t len, struct spanv *out) {
+    struct toks t = {0};
+    struct lists ls = { {0}, 0 };
+    int in_fence = 0; char fence_ch = 0; size_t fence_n = 0;
+    size_t seg_s = 0; int seg_line = 1; int have_seg = 0;
+    int line = 1;
+    size_t i = 0;
+    while (i < len) {
+        const char *nl = (const char *)memchr(src + i, '\n', len - i);
+        size_t le = nl ? (size_t)(nl - src) : len;
+        size_t off = skip_container(src + i, src + le);
+        const char *t0 = src + i + off;
+        size_t rest = le - (i + off);
+        int blank = (rest == 0);
+        int fence = 0, code = 0, heading = 0;
+        if (!blank && !in_fence) {
+            const char *content;
+            int ind = line_indent(src + i, src + le, &content);
+            int mark = list_marker_width(content, src + le);
+            /* a lazy paragraph line leaves the items open; anything else
+             * closes those indented deeper than it */
+            if (!have_seg || mark) while (ls.n > 0 && ls.col[ls.n - 1] > ind) ls.n--;
+            int base = ls.n > 0 ? ls.col[ls.n - 1] : 0;
+            if (!have_seg && ind >= base + 4) code = 1;
+            else if (mark && ind < base + 4) {
+                if (ls.n == LIST_MAX) { memmove(ls.col, ls.col + 1, (LIST_MAX - 1) * sizeof(int)); ls.n--; }
+                ls.col[ls.n++] = ind + mark;
+            }
+            /* an ATX heading is one line: an indented line after it is code */
+            size_t h = 0;
+            while (content + h < src + le && content[h] == '#') h++;
+            heading = !code && h >= 1 && h <= 6 && (content + h == src + le || content[h] == ' ' || content[h] == '\t');
+        }
+        if (!code && rest >= 3 && (*t0 == '`' || *t0 == '~')) {
+            size_t n = 0; while (n < rest && t0[n] == *t0) n++;
+            if (in_fence) {
+                if (*t0 == fence_ch && n >= fence_n) {
+                    size_t k = n; while (k < rest && (t0[k] == ' ' || t0[k] == '\t' || t0[k] == '\r')) k++;
+                    if (k == rest) fence = 1;
+                }
+            } else if (n >= 3) {
+                fence = 1; fence_ch = *t0; fence_n = n;
+            }
+        }
+        if (in_fence || blank || fence || code) {
+            if (have_seg && scan_segment(src, seg_s, i, seg_line, &t, out) != 0) { free(t.v); return -1; }
+            have_seg = 0;
+            if (fence) in_fence = !in_fence;
+        } else if (!have_seg) {
+            have_seg = 1; seg_s = i; seg_line = line;
+        }
+        if (heading && have_seg) {
+            if (scan_segment(src, seg_s, le, seg_line, &t, out) != 0) { free(t.v); return -1; }
+            have_seg = 0;
+        }
+        i = nl ? le + 1 : le;
+        line++;
+    }
+    if (have_seg && scan_segment(src, seg_s, len, seg_line, &t, out) != 0) { free(t.v); return -1; }
+    free(t.v);
+    return 0;
+}
+
+int mdvic_math_extract(const char *src, size_t len, struct MdvicMathSpans *ms) {
+    memset(ms, 0, sizeof(*ms));
+    /* Refuse sources that already contain placeholder code points. */
+    for (const char *p = src, *end = src + len; p < end; p++) {
+        p = (const char *)memchr(p, 0xEE, (size_t)(end - p));
+        if (!p) break;
+        if (end - p >= 3 && (unsigned char)p[1] == 0x80 && ((unsigned char)p[2] == 0x80 || (unsigned char)p[2] == 0x81)) return 1;
+    }
+    struct spanv sv = {0};
+    if (find_spans(src, len, &sv) != 0) { free(sv.v); return -1; }
+    if (sv.n == 0) { free(sv.v); return 0; }
+
+    /* Size the masked copy, the multi-line arena and the line map. */
+    size_t masked_cap = len + 1, arena_cap = 0, map_n = 0;
+    for (size_t k = 0; k < sv.n; k++) {
+        masked_cap += 3 + 20 + 3;
+        if (memchr(sv.v[k].tex, '\n', sv.v[k].tex_len)) { arena_cap += sv.v[k].tex_len; map_n++; }
+    }
+    char *masked = (char *)malloc(masked_cap);
+    char *arena = arena_cap ? (char *)malloc(arena_cap) : NULL;
+    int *map = map_n ? (int *)malloc(map_n * 2 * sizeof(int)) : NULL;
+    if (!masked || (arena_cap && !arena) || (map_n && !map)) { free(masked); free(arena); free(map); free(sv.v); return -1; }
+
+    size_t mo = 0, ao = 0, mi = 0, prev = 0; int removed = 0;
+    for (size_t k = 0; k < sv.n; k++) {
+        struct MdvicMathSpan *sp = &sv.v[k];
+        size_t at = (size_t)(sp->raw - src);
+        memcpy(masked + mo, src + prev, at - prev); mo += at - prev;
+        mo += (size_t)snprintf(masked + mo, masked_cap - mo, MDVIC_MATH_PH_OPEN "%zu" MDVIC_MATH_PH_CLOSE, k);
+        prev = at + sp->raw_len;
+        if (memchr(sp->tex, '\n', sp->tex_len)) {
+            /* Fold lines to spaces, drop continuation-line container prefixes and
+             * the blank edges left by delimiters on their own lines. */
+            char *d = arena + ao; const char *p = sp->tex, *end = sp->tex + sp->tex_len; size_t dn = 0; int nls = 0;
+            while (p < end) {
+                if (*p == '\n') { d[dn++] = ' '; nls++; p++; p += skip_container(p, end); continue; }
+                d[dn++] = *p++;
+            }
+            size_t lead = 0; while (lead < dn && d[lead] == ' ') lead++;
+            while (dn > lead && (d[dn - 1] == ' ' || d[dn - 1] == '\t' || d[dn - 1] == '\r')) dn--;
+            sp->tex = d + lead; sp->tex_len = dn - lead; ao += dn;
+            removed += nls;
+            map[mi * 2] = sp->line - (removed - nls); map[mi * 2 + 1] = removed; mi++;
+        }
+    }
+    memcpy(masked + mo, src + prev, len - prev); mo += len - prev;
+    masked[mo] = '\0';
+
+    ms->spans = sv.v; ms->count = sv.n;
+    ms->masked = masked; ms->masked_len = mo;
+    ms->arena = arena; ms->line_map = map; ms->line_map_n = mi;
+    return 0;
+}
+
+int mdvic_math_lone_delims(const char *src, size_t len, struct MdvicMathDelim **out, size_t *n) {
+    struct spanv sv = {0};
+    sv.want_lone = 1;
+    int rc = find_spans(src, len, &sv);
+    free(sv.v);
+    if (rc != 0) { free(sv.lone); return -1; }
+    *out = sv.lone; *n = sv.lone_n;
+    return 0;
+}
+
+void mdvic_math_spans_free(struct MdvicMathSpans *ms) {
+    if (!ms) return;
+    free(ms->spans); free(ms->masked); free(ms->arena); free(ms->line_map);
+    memset(ms, 0, sizeof(*ms));
+}
+
+size_t mdvic_math_placeholder_at(const char *s, size_t len, size_t *index) {
+    if (len < 7 || memcmp(s, MDVIC_MATH_PH_OPEN, 3) != 0) return 0;
+    size_t i = 3, v = 0;
+    while (i < len && s[i] >= '0' && s[i] <= '9') { v = v * 10 + (size_t)(s[i] - '0'); i++; }
+    if (i == 3 || i + 3 > len || memcmp(s + i, MDVIC_MATH_PH_CLOSE, 3) != 0) return 0;
+    *index = v;
+    return i + 3;
+}
+
+int mdvic_math_source_line(const struct MdvicMathSpans *ms, int masked_line) {
+    if (!ms || ms->line_map_n == 0) return masked_line;
+    /* Last entry whose placeholder line lies strictly above masked_line. */
+    size_t lo = 0, hi = ms->line_map_n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ms->line_map[mid * 2] < masked_line) lo = mid + 1; else hi = mid;
+    }
+    return lo == 0 ? masked_line : masked_line + ms->line_map[(lo - 1) * 2 + 1];
+}
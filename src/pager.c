@@ -0,0 +1,489 @@
+/* Built-in pager: renders top-level blocks into memory as they are needed,
+ * and lays the recorded document out again when the terminal is resized. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mdvic/mdvic.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "mdvic/wcwidth.h"
+
+/* Lines rendered beyond the bottom of the screen before it is drawn. */
+#define PAGER_LOOKAHEAD_SCREENS 1
+/* Bytes rendered per idle step while no key is pending. */
+#define PAGER_IDLE_BYTES 65536
+
+enum {
+    KEY_NONE = 0,
+    KEY_UP = 0x100, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_PGUP, KEY_PGDN, KEY_HOME, KEY_END,
+    KEY_RESIZE, KEY_EOF
+};
+
+/* SGR state at the start of a line, so any line can be drawn on its own. */
+struct Sgr {
+    unsigned char attrs;   /* 1 bold 2 dim 4 italic 8 underline 16 inverse */
+    unsigned char fg[4], bg[4]; /* kind (0 none, 1 basic, 5 indexed, 2 rgb), values */
+};
+
+struct Pager {
+    struct MdvicDoc *doc;  /* NULL once every block is recorded */
+    struct MdvicIr *ir;
+    struct MdvicLayout *lay; /* NULL once the layout is finished */
+    int wrap;              /* lay out at the terminal width */
+    FILE *mem; char *buf; size_t size;
+    size_t scanned;        /* bytes of buf split into lines */
+    size_t *line_off; struct Sgr *line_sgr; size_t nlines, cap;
+    struct Sgr cur;        /* state at 'scanned' */
+    int done;
+    int rows, cols;
+    size_t top; int hoff;
+    char search[256];
+    const char *message;
+    const char *name;
+    int tty;
+};
+
+static volatile sig_atomic_t got_winch = 0, got_term = 0;
+static void on_winch(int sig) { (void)sig; got_winch = 1; }
+static void on_term(int sig) { (void)sig; got_term = 1; }
+
+/* ---- SGR tracking ---- */
+
+static void sgr_apply(struct Sgr *g, const char *p, size_t n) {
+    int v[32]; int nv = 0, cur = 0, have = 0;
+    for (size_t i = 0; i <= n && nv < 32; i++) {
+        if (i == n || p[i] == ';' || p[i] == ':') { v[nv++] = have ? cur : 0; cur = 0; have = 0; }
+        else if (p[i] >= '0' && p[i] <= '9') { cur = cur * 10 + (p[i] - '0'); have = 1; if (cur > 65535) cur = 65535; }
+    }
+    for (int i = 0; i < nv; i++) {
+        int c = v[i];
+        if (c == 0) { memset(g, 0, sizeof(*g)); }
+        else if (c == 1) g->attrs |= 1;
+        else if (c == 2) g->attrs |= 2;
+        else if (c == 3) g->attrs |= 4;
+        else if (c == 4) g->attrs |= 8;
+        else if (c == 7) g->attrs |= 16;
+        else if (c == 22) g->attrs &= (unsigned char)~3u;
+        else if (c == 23) g->attrs &= (unsigned char)~4u;
+        else if (c == 24) g->attrs &= (unsigned char)~8u;
+        else if (c == 27) g->attrs &= (unsigned char)~16u;
+        else if ((c >= 30 && c <= 37) || (c >= 90 && c <= 97)) { g->fg[0] = 1; g->fg[1] = (unsigned char)c; }
+        else if ((c >= 40 && c <= 47) || (c >= 100 && c <= 107)) { g->bg[0] = 1; g->bg[1] = (unsigned char)c; }
+        else if (c == 39) g->fg[0] = 0;
+        else if (c == 49) g->bg[0] = 0;
+        else if ((c == 38 || c == 48) && i + 1 < nv) {
+            unsigned char *col = c == 38 ? g->fg : g->bg;
+            if (v[i + 1] == 5 && i + 2 < nv) { col[0] = 5; col[1] = (unsigned char)v[i + 2]; i += 2; }
+            else if (v[i + 1] == 2 && i + 4 < nv) { col[0] = 2; col[1] = (unsigned char)v[i + 2]; col[2] = (unsigned char)v[i + 3]; col[3] = (unsigned char)v[i + 4]; i += 4; }
+            else i++;
+        }
+    }
+}
+
+static void sgr_emit(FILE *out, const struct Sgr *g) {
+    static const int codes[5] = {1, 2, 3, 4, 7};
+    if (g->attrs == 0 && g->fg[0] == 0 && g->bg[0] == 0) return;
+    fputs("\x1b[0", out);
+    for (int i = 0; i < 5; i++) if (g->attrs & (1u << i)) fprintf(out, ";%d", codes[i]);
+    for (int k = 0; k < 2; k++) {
+        const unsigned char *col = k ? g->bg : g->fg;
+        if (col[0] == 1) fprintf(out, ";%d", col[1]);
+        else if (col[0] == 5) fprintf(out, ";%d;5;%d", k ? 48 : 38, col[1]);
+        else if (col[0] == 2) fprintf(out, ";%d;2;%d;%d;%d", k ? 48 : 38, col[1], col[2], col[3]);
+    }
+    fputc('m', out);
+}
+
+/* ---- rendering into memory ---- */
+
+static int add_line(struct Pager *p, size_t off) {
+    if (p->nlines == p->cap) {
+        size_t ncap = p->cap ? p->cap * 2 : 1024;
+        size_t *no = (size_t *)realloc(p->line_off, ncap * sizeof(*no));
+        if (!no) return -1;
+        p->line_off = no;
+        struct Sgr *ns = (struct Sgr *)realloc(p->line_sgr, ncap * sizeof(*ns));
+        if (!ns) return -1;
+        p->line_sgr = ns; p->cap = ncap;
+    }
+    p->line_off[p->nlines] = off; p->line_sgr[p->nlines] = p->cur; p->nlines++;
+    return 0;
+}
+
+/* Split newly rendered bytes into lines, tracking the SGR state. Returns 0,
+ * or -1 when out of memory. */
+static int scan_new(struct Pager *p) {
+    fflush(p->mem);
+    size_t i = p->scanned;
+    const char *b = p->buf;
+    while (i < p->size) {
+        const char *nl = (const char *)memchr(b + i, '\n', p->size - i);
+        size_t stop = nl ? (size_t)(nl - b) : p->size;
+        for (const char *e = (const char *)memchr(b + i, 0x1b, stop - i); e; e = (const char *)memchr(e + 1, 0x1b, (size_t)(b + stop - e - 1))) {
+            if (e + 1 < b + stop && e[1] == '[') {
+                const char *q = e + 2;
+                while (q < b + stop && !(*q >= 0x40 && *q <= 0x7e)) q++;
+                if (q < b + stop && *q == 'm') sgr_apply(&p->cur, e + 2, (size_t)(q - e - 2));
+            }
+            if (e + 1 >= b + stop) break;
+        }
+        if (!nl) { i = stop; break; }
+        i = stop + 1;
+        if (add_line(p, i) != 0) { p->scanned = i; return -1; }
+    }
+    p->scanned = i;
+    return 0;
+}
+
+static int render_more(struct Pager *p) {
+    if (p->done) return 0;
+    if (p->doc && mdvic_doc_render_next(p->doc) == 0) {
+        mdvic_doc_close(p->doc); p->doc = NULL;
+    }
+    mdvic_layout_run(p->lay);
+    if (!p->doc) {
+        mdvic_layout_free(p->lay); p->lay = NULL;
+        p->done = 1;
+    }
+    if (scan_new(p) != 0) return -1;
+    /* the last line needs no newline to count */
+    if (p->done && p->size > p->line_off[p->nlines - 1]) return add_line(p, p->size + 1);
+    return 0;
+}
+
+/* Complete lines available: line i spans line_off[i] .. line_off[i+1]-1. */
+static size_t line_count(const struct Pager *p) { return p->nlines - 1; }
+
+static int ensure_lines(struct Pager *p, size_t n) {
+    while (!p->done && line_count(p) < n) if (render_more(p) != 0) return -1;
+    return 0;
+}
+
+/* ---- drawing ---- */
+
+static int utf8_len(unsigned char c) {
+    return c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 1;
+}
+
+static uint32_t utf8_cp(const unsigned char *s, int n) {
+    if (n == 1) return s[0];
+    uint32_t cp = s[0] & (0x7Fu >> n);
+    for (int k = 1; k < n; k++) cp = (cp << 6) | (s[k] & 0x3Fu);
+    return cp;
+}
+
+/* Draw columns [hoff, hoff+cols) of a line; escapes are always passed on. */
+static void draw_line(FILE *out, const char *s, size_t len, int hoff, int cols) {
+    int col = 0, end = hoff + cols;
+    size_t i = 0;
+    while (i < len) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == 0x1b) {
+            size_t j = i + 1;
+            if (j < len && s[j] == '[') { j++; while (j < len && !((unsigned char)s[j] >= 0x40 && (unsigned char)s[j] <= 0x7e)) j++; if (j < len) j++; }
+            else if (j < len && s[j] == ']') { while (j < len && s[j] != 0x07 && !(s[j] == 0x1b && j + 1 < len && s[j + 1] == '\\')) j++; j += (j < len && s[j] == 0x1b) ? 2 : 1; if (j > len) j = len; }
+            else if (j < len) j++;
+            fwrite(s + i, 1, j - i, out);
+            i = j; continue;
+        }
+        if (c == '\t') {
+            int w = 8 - col % 8;
+            for (int k = 0; k < w; k++, col++) if (col >= hoff && col < end) fputc(' ', out);
+            i++; continue;
+        }
+        int n = utf8_len(c);
+        if (i + (size_t)n > len) n = 1;
+        int w = c < 0x20 ? 0 : mdvic_wcwidth(utf8_cp((const unsigned char *)s + i, n));
+        if (w < 0) w = 0;
+        if (col >= end) break;
+        if (col >= hoff && col + w <= end) fwrite(s + i, 1, (size_t)n, out);
+        else if (w > 0 && col + w > hoff && col < end) for (int k = col; k < col + w; k++) if (k >= hoff && k < end) fputc(' ', out);
+        col += w; i += (size_t)n;
+    }
+}
+
+static int text_rows(const struct Pager *p) { return p->rows > 1 ? p->rows - 1 : 1; }
+
+static int draw(struct Pager *p, FILE *out, const char *prompt) {
+    int h = text_rows(p);
+    if (ensure_lines(p, p->top + (size_t)h * (1 + PAGER_LOOKAHEAD_SCREENS)) != 0) return -1;
+    fputs("\x1b[H", out);
+    for (int r = 0; r < h; r++) {
+        size_t ln = p->top + (size_t)r;
+        if (ln < line_count(p)) {
+            sgr_emit(out, &p->line_sgr[ln]);
+            size_t a = p->line_off[ln], b = p->line_off[ln + 1] - 1;
+            if (b > p->size) b = p->size;
+            draw_line(out, p->buf + a, b - a, p->hoff, p->cols);
+            fputs("\x1b[0m", out);
+        } else {
+            fputc('~', out);
+        }
+        fputs("\x1b[K\r\n", out);
+    }
+    char status[512];
+    if (prompt) snprintf(status, sizeof(status), "/%s", prompt);
+    else if (p->message) snprintf(status, sizeof(status), "%s", p->message);
+    else {
+        int at_end = p->done && p->top + (size_t)h >= line_count(p);
+        snprintf(status, sizeof(status), "%s line %zu%s", p->name, p->top + 1, at_end ? " (END)" : "");
+    }
+    fputs("\x1b[7m", out);
+    draw_line(out, status, strlen(status), 0, p->cols);
+    fputs("\x1b[0m\x1b[K", out);
+    fflush(out);
+    return 0;
+}
+
+/* ---- input ---- */
+
+static int read_byte(int fd, int timeout_ms) {
+    struct pollfd pfd; pfd.fd = fd; pfd.events = POLLIN; pfd.revents = 0;
+    int r = poll(&pfd, 1, timeout_ms);
+    if (r < 0) return errno == EINTR ? -2 : -1;
+    if (r == 0) return -3;
+    unsigned char c;
+    ssize_t n = read(fd, &c, 1);
+    if (n == 1) return c;
+    if (n < 0 && errno == EINTR) return -2;
+    return -1;
+}
+
+/* Next key, or KEY_NONE when nothing arrives within timeout_ms. */
+static int read_key(struct Pager *p, int timeout_ms) {
+    int c = read_byte(p->tty, timeout_ms);
+    if (c == -3) return KEY_NONE;
+    if (c == -2) return got_term ? KEY_EOF : got_winch ? KEY_RESIZE : KEY_NONE;
+    if (c < 0) return KEY_EOF;
+    if (c != 0x1b) return c;
+    int c1 = read_byte(p->tty, 50);
+    if (c1 != '[' && c1 != 'O') return 0x1b;
+    int c2 = read_byte(p->tty, 50);
+    switch (c2) {
+    case 'A': return KEY_UP;
+    case 'B': return KEY_DOWN;
+    case 'C': return KEY_RIGHT;
+    case 'D': return KEY_LEFT;
+    case 'H': return KEY_HOME;
+    case 'F': return KEY_END;
+    default: break;
+    }
+    if (c2 >= '0' && c2 <= '9') {
+        int c3 = read_byte(p->tty, 50);
+        if (c3 == '~') {
+            switch (c2) {
+            case '1': case '7': return KEY_HOME;
+            case '4': case '8': return KEY_END;
+            case '5': return KEY_PGUP;
+            case '6': return KEY_PGDN;
+            default: break;
+            }
+        }
+    }
+    return KEY_NONE;
+}
+
+/* Wait for a key, rendering ahead in the background while none is pending. */
+static int next_key(struct Pager *p) {
+    for (;;) {
+        int k = read_key(p, p->done ? -1 : 0);
+        if (k != KEY_NONE || got_winch || got_term) return k == KEY_NONE ? (got_term ? KEY_EOF : KEY_RESIZE) : k;
+        size_t before = p->size;
+        while (!p->done && p->size - before < PAGER_IDLE_BYTES) if (render_more(p) != 0) return KEY_EOF;
+    }
+}
+
+/* ---- search ---- */
+
+static int line_matches(struct Pager *p, size_t ln, const char *pat) {
+    size_t a = p->line_off[ln], b = p->line_off[ln + 1] - 1;
+    if (b > p->size) b = p->size;
+    /* match against the text with escape sequences removed */
+    char *t = (char *)malloc(b - a + 1);
+    if (!t) return 0;
+    size_t n = 0;
+    for (size_t i = a; i < b; i++) {
+        if (p->buf[i] == 0x1b && i + 1 < b && p->buf[i + 1] == '[') {
+            i += 2;
+            while (i < b && !((unsigned char)p->buf[i] >= 0x40 && (unsigned char)p->buf[i] <= 0x7e)) i++;
+            continue;
+        }
+        t[n++] = p->buf[i];
+    }
+    t[n] = '\0';
+    int hit = strstr(t, pat) != NULL;
+    free(t);
+    return hit;
+}
+
+static int search(struct Pager *p, int backward) {
+    if (p->search[0] == '\0') return 0;
+    if (backward) {
+        for (size_t ln = p->top; ln-- > 0; ) if (line_matches(p, ln, p->search)) { p->top = ln; return 0; }
+    } else {
+        for (size_t ln = p->top + 1; ; ln++) {
+            if (ensure_lines(p, ln + 1) != 0) return -1;
+            if (ln >= line_count(p)) break;
+            if (line_matches(p, ln, p->search)) { p->top = ln; return 0; }
+        }
+    }
+    p->message = "Pattern not found";
+    return 0;
+}
+
+static int prompt_search(struct Pager *p, FILE *out) {
+    char buf[sizeof(p->search)]; size_t n = 0; buf[0] = '\0';
+    for (;;) {
+        if (draw(p, out, buf) != 0) return -1;
+        int k = read_key(p, -1);
+        if (k == KEY_EOF) return -1;
+        if (k == '\r' || k == '\n') break;
+        if (k == 0x1b || k == 3) return 0;
+        if ((k == 127 || k == 8) && n > 0) buf[--n] = '\0';
+        else if (k >= 0x20 && k < 0x100 && k != 127 && n + 1 < sizeof(buf)) { buf[n++] = (char)k; buf[n] = '\0'; }
+    }
+    if (n > 0) memcpy(p->search, buf, n + 1);
+    return search(p, 0);
+}
+
+static void query_size(struct Pager *p) {
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) { p->rows = ws.ws_row; p->cols = ws.ws_col; }
+}
+
+/* Start a fresh layout of everything recorded so far at the current width. */
+static int layout_start(struct Pager *p) {
+    if (p->lay) { mdvic_layout_free(p->lay); p->lay = NULL; }
+    if (p->mem) { fclose(p->mem); free(p->buf); p->buf = NULL; p->size = 0; }
+    p->mem = open_memstream(&p->buf, &p->size);
+    if (!p->mem) return -1;
+    p->lay = mdvic_layout_new(p->ir, p->wrap ? p->cols : 0, p->mem);
+    if (!p->lay) return -1;
+    p->scanned = 0; p->nlines = 0;
+    memset(&p->cur, 0, sizeof(p->cur));
+    if (add_line(p, 0) != 0) return -1;
+    p->done = 0;
+    /* only the layout is redone: blocks already recorded are not re-rendered */
+    if (!p->doc) return render_more(p);
+    return 0;
+}
+
+static int clamp_top(struct Pager *p) {
+    size_t h = (size_t)text_rows(p);
+    if (ensure_lines(p, p->top + h) != 0) return -1;
+    size_t n = line_count(p);
+    if (p->top + h > n) p->top = n > h ? n - h : 0;
+    return 0;
+}
+
+int mdvic_pager(FILE *in, const struct MdvicOptions *opt, const char *filename) {
+    if (!isatty(STDOUT_FILENO)) return -1;
+    int tty = open("/dev/tty", O_RDONLY);
+    if (tty < 0) return -1;
+    struct termios saved, raw;
+    if (tcgetattr(tty, &saved) != 0) { close(tty); return -1; }
+
+    /* diagnostics would scribble over the screen, and links cannot span
+     * the lines the pager draws separately */
+    struct MdvicOptions popt = *opt;
+    popt.enable_lint = false;
+    popt.enable_osc8 = false;
+
+    struct Pager p;
+    memset(&p, 0, sizeof(p));
+    p.name = filename ? filename : "-";
+    p.tty = tty; p.rows = 24; p.cols = 80;
+    query_size(&p);
+    p.wrap = popt.enable_wrap;
+    p.ir = mdvic_ir_new(&popt);
+    if (!p.ir) { close(tty); return -1; }
+    p.doc = mdvic_doc_open_ir(in, p.ir, filename);
+    if (!p.doc || layout_start(&p) != 0) {
+        if (p.doc) mdvic_doc_close(p.doc);
+        mdvic_layout_free(p.lay);
+        if (p.mem) fclose(p.mem);
+        free(p.buf); free(p.line_off); free(p.line_sgr);
+        mdvic_ir_free(p.ir); close(tty);
+        return -1;
+    }
+
+    raw = saved;
+    raw.c_iflag &= (tcflag_t)~(IXON | ICRNL | BRKINT | INPCK | ISTRIP);
+    raw.c_lflag &= (tcflag_t)~(ECHO | ICANON | ISIG | IEXTEN);
+    raw.c_cc[VMIN] = 1; raw.c_cc[VTIME] = 0;
+    tcsetattr(tty, TCSADRAIN, &raw); /* keep keys typed during startup */
+    struct sigaction sa, old_winch, old_term, old_hup;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_winch; sigaction(SIGWINCH, &sa, &old_winch);
+    sa.sa_handler = on_term; sigaction(SIGTERM, &sa, &old_term); sigaction(SIGHUP, &sa, &old_hup);
+
+    FILE *out = stdout;
+    fputs("\x1b[?1049h\x1b[?25l", out);
+    int rc = 0;
+    for (;;) {
+        if (clamp_top(&p) != 0 || draw(&p, out, NULL) != 0) { rc = 1; break; }
+        p.message = NULL;
+        int k = next_key(&p);
+        size_t h = (size_t)text_rows(&p);
+        if (k == KEY_EOF || k == 'Q' || k == 3) { rc = 1; break; }
+        if (k == 'q') break;
+        switch (k) {
+        case 'j': case KEY_DOWN: case '\r': case '\n': case 14: p.top++; break;
+        case 'k': case KEY_UP: case 16: if (p.top > 0) p.top--; break;
+        case ' ': case 'f': case KEY_PGDN: case 6: p.top += h; break;
+        case 'b': case KEY_PGUP: case 2: p.top = p.top > h ? p.top - h : 0; break;
+        case 'd': case 4: p.top += h / 2; break;
+        case 'u': case 21: p.top = p.top > h / 2 ? p.top - h / 2 : 0; break;
+        case 'g': case '<': case KEY_HOME: p.top = 0; break;
+        case 'G': case '>': case KEY_END:
+            while (!p.done && rc == 0) if (render_more(&p) != 0) rc = 1;
+            p.top = line_count(&p);
+            break;
+        case KEY_RIGHT: p.hoff += p.cols / 2; break;
+        case KEY_LEFT: p.hoff = p.hoff > p.cols / 2 ? p.hoff - p.cols / 2 : 0; break;
+        case '/': if (prompt_search(&p, out) != 0) rc = 1; break;
+        case 'n': if (search(&p, 0) != 0) rc = 1; break;
+        case 'N': if (search(&p, 1) != 0) rc = 1; break;
+        case KEY_RESIZE: {
+            int old_cols = p.cols;
+            got_winch = 0; query_size(&p);
+            if (p.wrap && p.cols != old_cols && layout_start(&p) != 0) rc = 1;
+            break;
+        }
+        default: break;
+        }
+        if (rc != 0) break;
+    }
+    fputs("\x1b[?25h\x1b[?1049l", out);
+    fflush(out);
+    tcsetattr(tty, TCSADRAIN, &saved);
+    sigaction(SIGWINCH, &old_winch, NULL); sigaction(SIGTERM, &old_term, NULL); sigaction(SIGHUP, &old_hup, NULL);
+    close(tty);
+    if (p.doc) mdvic_doc_close(p.doc);
+    mdvic_layout_free(p.lay);
+    if (p.mem) fclose(p.mem);
+    free(p.buf); free(p.line_off); free(p.line_sgr);
+    mdvic_ir_free(p.ir);
+    return rc;
+}
+
+#else
+
+int mdvic_pager(FILE *in, const struct MdvicOptions *opt, const char *filename) {
+    (void)in; (void)opt; (void)filename;
+    return -1;
+}
+
+#endif
@@ -1,9 +1,12 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <string.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdint.h>
 #ifndef _WIN32
+#include <pthread.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #else
@@ -13,104 +16,461 @@
 #include "mdvic/mdvic.h"
 #include "mdvic/wrap.h"
 #include "mdvic/math.h"
+#include "mdvic/mathspan.h"
 #include "mdvic/lint.h"
+#include "mdvic/theme.h"
+#include "mdvic/highlight.h"
+#include "mdvic/grid.h"
+#include "mdvic/stats.h"
+#include "mdvic/trace.h"
+#include "mdvic/utf8.h"
 #ifdef HAVE_LIBCMARK
 #include <cmark.h>
 #endif
 #include "mdvic/wcwidth.h"
 
-static int heading_color_code(int level) {
-    switch (level) {
-        case 1: return 31; /* red */
-        case 2: return 33; /* yellow */
-        case 3: return 32; /* green */
-        case 4: return 36; /* cyan */
-        case 5: return 34; /* blue */
-        case 6: return 35; /* magenta */
-        default: return -1;
-    }
-}
+/* Documents at least this large are linted on a thread beside parsing. */
+#ifndef LINT_THREAD_MIN_BYTES
+#define LINT_THREAD_MIN_BYTES (64u * 1024u)
+#endif
+
+/* Math memo bounds per document: slots and stored bytes (source + output). */
+#define MATH_CACHE_SLOTS 1024
+#define MATH_CACHE_BYTES (1u << 20)
+
+/* Prepared SGR transitions per document (direct-mapped). */
+#define SGR_CACHE_SLOTS 64
 
 /* ---------------- Rendering primitives ---------------- */
 
 struct Style {
-    int bold;
-    int italic;
-    int underline;
-    int inverse;
-    int dim;
-    int fg; /* -1=default, 30..37 basic */
+    unsigned attrs; /* MDVIC_ATTR_* */
+    int fg;         /* theme element whose foreground applies; -1 = default */
+    int bg;         /* likewise for the background */
 };
 
+struct SgrEntry { uint32_t key; unsigned char len; char seq[63]; };
+
+/* Line prefixes of the enclosing blocks (quote markers, list bullets). Each
+ * level adds a segment with a text for its first line and one for the lines
+ * after it. The joined line prefixes and their widths are rebuilt only when
+ * the stack changes or a fresh segment has printed its first line. */
+struct PrefixSeg {
+    size_t first_off, first_len, next_off, next_len; /* into PrefixStack.text */
+    int first_w, next_w;
+};
+
+struct PrefixStack {
+    struct PrefixSeg *seg; size_t n, cap;
+    char *text; size_t text_len, text_cap;
+    size_t fresh;       /* segments [fresh, n) have not printed a line yet */
+    int dirty;
+    char *line; size_t line_len, line_cap; /* joined: first line of fresh segments */
+    char *wrap; size_t wrap_len, wrap_cap; /* joined: continuation lines */
+    int line_w, wrap_w;
+};
+
+/* Width-independent rendering: with Out.ir set, the output primitives append
+ * operations here instead of writing, and mdvic_layout replays them through
+ * the same primitives for any width. Text runs carry the style they were
+ * written in and their display width, so layout does no parsing, math or
+ * (mostly) measuring. */
+enum ir_kind {
+    IR_TEXT,        /* wrappable text, through the writer */
+    IR_RAW,         /* bytes copied as-is in op style (table cells, code) */
+    IR_LF,          /* table row end: newline outside column tracking */
+    IR_NEWLINE,
+    IR_CODE,        /* start of a code line: prefix and indent */
+    IR_PREFIX_PUSH, /* text holds "first\0next\0" */
+    IR_PREFIX_POP,
+    IR_LINK_BEGIN,  /* text holds "url\0" */
+    IR_LINK_END
+};
+
+struct IrOp {
+    unsigned char kind;
+    unsigned char nowrap; /* IR_TEXT inside a table row */
+    struct Style style;
+    int width;            /* IR_TEXT: display columns, or -1 if the wrapper must measure */
+    size_t off, len;      /* into MdvicIr.text */
+};
+
+struct MdvicIr {
+    struct IrOp *op; size_t n, cap;
+    char *text; size_t text_len, text_cap;
+    struct MdvicOptions opt;
+};
+
+/* Buffer lint running beside parse and render. Its findings are printed
+ * before the renderer's first own diagnostic or when the document closes,
+ * so stderr reads as if lint had run first. */
+struct LintJob {
+    const char *data; size_t len; const char *filename;
+    struct MdvicDiagList found;
+    struct MdvicStats *stats; struct MdvicTrace *trace;
+    unsigned long long t0, t1; /* when the thread ran, if timed */
+#ifndef _WIN32
+    pthread_t thread;
+#endif
+    int running;
+};
+
+struct Out;
+typedef void (*out_write_fn)(struct Out *o, const char *s, size_t len);
+
 struct Out {
     FILE *out;
     int width;
-    int col;
-    int need_reset;
+    int col;       /* display column; without wrapping only col == 0 is meaningful */
+    out_write_fn write; /* chosen by out_init for the wrap and colour settings */
+    int code_col;  /* display columns since the start of the code line, or -1 if it has no tabs */
     int color_enabled;
     int osc8_enabled;
-    struct Style style;
+    struct Style style; /* wanted for the next text */
+    struct Style term;  /* SGR state last sent to the terminal */
+    const struct MdvicTheme *theme;
+    struct SgrEntry sgr_cache[SGR_CACHE_SLOTS];
     int list_depth;
     int quote_depth;
     int list_tight; /* 1 when rendering a tight list */
-    char prefix_first[32];
-    int prefix_first_len;
-    char prefix_next[32];
-    int prefix_next_len;
+    struct PrefixStack prefix;
+    struct MdvicIr *ir; /* record instead of writing; width is then -1 */
+    struct MdvicGrid *grid; /* layout into cells instead of out */
+    mdvic_diag_fn diag; void *diag_ctx; /* table findings; NULL prints them to stderr */
+    int diag_count;
+    int lint_only;      /* check tables without rendering them */
+    struct LintJob *lint; /* pending buffer lint, or NULL */
     const char *filename;
     const char *source;
     size_t source_len;
+    int span_line; size_t span_off; /* last line looked up in source */
+    struct MdvicMathCache *math_cache; /* per-document memo; NULL renders every span afresh */
+    const struct MdvicMathSpans *math; /* pre-extracted spans; NULL means scan text for $ */
+    struct MdvicStats *stats; /* --stats counters, or NULL */
+    struct MdvicTrace *trace; /* --trace events, or NULL */
+    const char *input; size_t input_len; /* unmasked source, for trace byte ranges */
+    int trace_line; size_t trace_off; /* last line start looked up in input */
 };
 
 static void style_init(struct Style *s) {
-    s->bold = 0; s->italic = 0; s->underline = 0; s->inverse = 0; s->dim = 0; s->fg = -1;
+    s->attrs = 0; s->fg = -1; s->bg = -1;
+}
+
+static const struct MdvicTheme *default_theme(void) {
+    static struct MdvicTheme theme;
+    static int ready = 0;
+    if (!ready) { mdvic_theme_default(&theme); ready = 1; }
+    return &theme;
 }
 
+static void out_write_wrapped(struct Out *o, const char *s, size_t len);
+static void out_write_plain(struct Out *o, const char *s, size_t len);
+static void out_write_plain_color(struct Out *o, const char *s, size_t len);
+
 static void out_init(struct Out *o, FILE *out, int width, const struct MdvicOptions *opt) {
     o->out = out;
     o->width = width;
     o->col = 0;
-    o->need_reset = 0;
+    o->code_col = -1;
     o->color_enabled = opt && !opt->no_color;
+    o->write = width > 0 ? out_write_wrapped : o->color_enabled ? out_write_plain_color : out_write_plain;
     o->osc8_enabled = opt && opt->enable_osc8;
     style_init(&o->style);
+    style_init(&o->term);
+    o->theme = (opt && opt->theme) ? opt->theme : default_theme();
+    memset(o->sgr_cache, 0, sizeof(o->sgr_cache));
     o->list_depth = 0;
     o->quote_depth = 0;
     o->list_tight = 0;
-    o->prefix_first[0] = '\0';
-    o->prefix_first_len = 0;
-    o->prefix_next[0] = '\0';
-    o->prefix_next_len = 0;
+    memset(&o->prefix, 0, sizeof(o->prefix));
+    o->ir = NULL;
+    o->grid = NULL;
+    o->diag = NULL; o->diag_ctx = NULL; o->diag_count = 0;
+    o->lint_only = 0;
+    o->lint = NULL;
+    o->span_line = 0; o->span_off = 0;
     o->filename = NULL;
     o->source = NULL; o->source_len = 0;
+    o->math_cache = NULL;
+    o->math = NULL;
+    o->stats = opt ? opt->stats : NULL;
+    o->trace = opt ? opt->trace : NULL;
+    o->input = NULL; o->input_len = 0;
+    o->trace_line = 1; o->trace_off = 0;
+}
+
+/* Every byte of laid-out output goes through here. */
+static void out_bytes(struct Out *o, const char *s, size_t n) {
+    if (o->grid) { mdvic_grid_put(o->grid, s, n); return; }
+    if (o->stats) {
+        unsigned long long t0 = mdvic_stats_now();
+        fwrite(s, 1, n, o->out);
+        o->stats->phase_ns[MDVIC_PHASE_WRITE] += mdvic_stats_now() - t0;
+        o->stats->output_bytes += n;
+        return;
+    }
+    fwrite(s, 1, n, o->out);
+}
+
+static int out_sink(void *ctx, const char *s, size_t n) {
+    out_bytes((struct Out *)ctx, s, n);
+    return 0;
+}
+
+/* Pack a style into 15 bits: attrs, then fg and bg element + 1. */
+static uint32_t style_key(const struct Style *s) {
+    return (uint32_t)s->attrs | (uint32_t)(s->fg + 1) << 5 | (uint32_t)(s->bg + 1) << 10;
+}
+
+/* Format the SGR sequence that takes the terminal from t to w: only changed
+ * parameters, or a bare reset when w is plain. Returns its length. */
+static size_t sgr_transition(const struct MdvicTheme *th, const struct Style *t, const struct Style *w, char *seq, size_t cap) {
+    if (w->attrs == 0 && w->fg < 0 && w->bg < 0) { memcpy(seq, "\x1b[0m", 4); return 4; }
+    size_t n = 2;
+    unsigned ta = t->attrs, wa = w->attrs;
+#define SGR_ADD(str) do { const char *p_ = (str); size_t l_ = strlen(p_); \
+        if (n + l_ + 2 < cap) { if (n > 2) seq[n++] = ';'; memcpy(seq + n, p_, l_); n += l_; } } while (0)
+    /* 22 clears both bold and dim, so re-enable whichever stays on */
+    int intensity_off = ((ta & MDVIC_ATTR_BOLD) && !(wa & MDVIC_ATTR_BOLD)) || ((ta & MDVIC_ATTR_DIM) && !(wa & MDVIC_ATTR_DIM));
+    if (intensity_off) SGR_ADD("22");
+    if ((wa & MDVIC_ATTR_BOLD) && (intensity_off || !(ta & MDVIC_ATTR_BOLD))) SGR_ADD("1");
+    if ((wa & MDVIC_ATTR_DIM) && (intensity_off || !(ta & MDVIC_ATTR_DIM))) SGR_ADD("2");
+    if ((ta ^ wa) & MDVIC_ATTR_ITALIC) SGR_ADD((wa & MDVIC_ATTR_ITALIC) ? "3" : "23");
+    if ((ta ^ wa) & MDVIC_ATTR_UNDERLINE) SGR_ADD((wa & MDVIC_ATTR_UNDERLINE) ? "4" : "24");
+    if ((ta ^ wa) & MDVIC_ATTR_INVERSE) SGR_ADD((wa & MDVIC_ATTR_INVERSE) ? "7" : "27");
+    if (t->fg != w->fg) SGR_ADD(w->fg >= 0 && th->fg_sgr[w->fg][0] ? th->fg_sgr[w->fg] : "39");
+    if (t->bg != w->bg) SGR_ADD(w->bg >= 0 && th->bg_sgr[w->bg][0] ? th->bg_sgr[w->bg] : "49");
+#undef SGR_ADD
+    seq[0] = '\x1b'; seq[1] = '['; seq[n++] = 'm';
+    return n;
 }
 
-static void out_emit_style(struct Out *o) {
-    if (!o->color_enabled) return;
-    /* Build minimal SGR sequence */
-    fputs("\x1b[0m", o->out);
-    if (o->style.bold) fputs("\x1b[1m", o->out);
-    if (o->style.dim) fputs("\x1b[2m", o->out);
-    if (o->style.italic) fputs("\x1b[3m", o->out);
-    if (o->style.underline) fputs("\x1b[4m", o->out);
-    if (o->style.inverse) fputs("\x1b[7m", o->out);
-    if (o->style.fg >= 30 && o->style.fg <= 37) {
-        fprintf(o->out, "\x1b[%dm", o->style.fg);
+/* Bring the terminal from o->term to o->style. Sequences come from a small
+ * per-document cache keyed by the (from, to) pair, so steady-state output
+ * is one lookup and one fwrite per transition. */
+static void out_sync_style(struct Out *o) {
+    if (!o->color_enabled || o->ir) return;
+    uint32_t from = style_key(&o->term), to = style_key(&o->style);
+    if (from == to) return;
+    if (o->grid) {
+        const struct MdvicThemeStyle *el = o->theme->el;
+        mdvic_grid_set_style(o->grid, o->style.attrs, o->style.fg >= 0 ? &el[o->style.fg].fg : NULL,
+                             o->style.bg >= 0 ? &el[o->style.bg].bg : NULL);
+        o->term = o->style;
+        return;
+    }
+    uint32_t key = ((from << 15) | to) + 1;
+    struct SgrEntry *e = &o->sgr_cache[(key * 2654435761u) >> 26];
+    if (e->key != key) {
+        e->len = (unsigned char)sgr_transition(o->theme, &o->term, &o->style, e->seq, sizeof(e->seq));
+        e->key = key;
     }
-    o->need_reset = 1;
+    out_bytes(o, e->seq, e->len);
+    if (o->stats) o->stats->escape_bytes += e->len;
+    o->term = o->style;
 }
 
+/* Leave the terminal in its default state. */
 static void out_reset(struct Out *o) {
-    if (o->color_enabled && o->need_reset) {
-        fputs("\x1b[0m", o->out);
-        o->need_reset = 0;
+    style_init(&o->style);
+    out_sync_style(o);
+}
+
+/* Layer a theme element's attributes over the current style; el < 0 is a no-op. */
+static void style_push(struct Out *o, struct Style *saved, int el) {
+    *saved = o->style;
+    if (el < 0) return;
+    const struct MdvicThemeStyle *ts = &o->theme->el[el];
+    o->style.attrs |= ts->attrs;
+    if (ts->fg.kind != MDVIC_COLOR_NONE) o->style.fg = el;
+    if (ts->bg.kind != MDVIC_COLOR_NONE) o->style.bg = el;
+}
+
+static void style_pop(struct Out *o, const struct Style *saved) {
+    o->style = *saved;
+}
+
+static int cell_width(const char *s) {
+    /* measure display width using wcwidth; the text is normalised input or
+     * built from it, so it is valid UTF-8 */
+    int w = 0; const char *p = s;
+    while (*p) {
+        uint32_t cp;
+        p += mdvic_utf8_decode(p, &cp);
+        w += mdvic_wcwidth(cp);
     }
+    return w < 0 ? 0 : w;
+}
+
+static int grow_bytes(char **p, size_t *cap, size_t need) {
+    if (need <= *cap) return 0;
+    size_t ncap = *cap ? *cap * 2 : 64;
+    while (ncap < need) ncap *= 2;
+    char *np = (char *)realloc(*p, ncap);
+    if (!np) return -1;
+    *p = np; *cap = ncap; return 0;
+}
+
+static void prefix_refresh(struct PrefixStack *ps) {
+    if (!ps->dirty) return;
+    size_t need = 0;
+    for (size_t i = 0; i < ps->n; i++) need += ps->seg[i].first_len + ps->seg[i].next_len;
+    if (grow_bytes(&ps->line, &ps->line_cap, need + 1) != 0 || grow_bytes(&ps->wrap, &ps->wrap_cap, need + 1) != 0) return;
+    ps->line_len = ps->wrap_len = 0; ps->line_w = ps->wrap_w = 0;
+    for (size_t i = 0; i < ps->n; i++) {
+        const struct PrefixSeg *g = &ps->seg[i];
+        int fresh = (i >= ps->fresh);
+        size_t lo = fresh ? g->first_off : g->next_off, ll = fresh ? g->first_len : g->next_len;
+        memcpy(ps->line + ps->line_len, ps->text + lo, ll); ps->line_len += ll;
+        ps->line_w += fresh ? g->first_w : g->next_w;
+        memcpy(ps->wrap + ps->wrap_len, ps->text + g->next_off, g->next_len); ps->wrap_len += g->next_len;
+        ps->wrap_w += g->next_w;
+    }
+    ps->dirty = 0;
+}
+
+/* Display width of a run the wrapper would measure the same way, or -1 if
+ * it holds newlines, escapes, controls or malformed UTF-8. */
+static int run_width(const char *s, size_t len) {
+    int w = 0;
+    for (size_t i = 0; i < len; ) {
+        unsigned char c = (unsigned char)s[i];
+        uint32_t cp; size_t n;
+        if (c < 0x80) { cp = c; n = 1; }
+        else if ((c & 0xE0) == 0xC0) { cp = c & 0x1Fu; n = 2; }
+        else if ((c & 0xF0) == 0xE0) { cp = c & 0x0Fu; n = 3; }
+        else if ((c & 0xF8) == 0xF0) { cp = c & 0x07u; n = 4; }
+        else return -1;
+        if (i + n > len) return -1;
+        for (size_t k = 1; k < n; k++) {
+            if (((unsigned char)s[i + k] & 0xC0) != 0x80) return -1;
+            cp = (cp << 6) | ((unsigned char)s[i + k] & 0x3Fu);
+        }
+        int cw = mdvic_wcwidth(cp);
+        if (cw < 0 || cp < 0x20 || cp == 0x7F) return -1;
+        w += cw; i += n;
+    }
+    return w;
+}
+
+/* Append an operation in the current style; adjacent text or raw runs in
+ * the same style are merged. */
+static int ir_add(struct Out *o, int kind, const char *s, size_t len) {
+    struct MdvicIr *ir = o->ir;
+    int nowrap = (kind == IR_TEXT && o->width == 0);
+    if (ir->n > 0 && (kind == IR_TEXT || kind == IR_RAW)) {
+        struct IrOp *last = &ir->op[ir->n - 1];
+        if (last->kind == kind && last->nowrap == nowrap && last->off + last->len == ir->text_len &&
+            style_key(&last->style) == style_key(&o->style)) {
+            if (grow_bytes(&ir->text, &ir->text_cap, ir->text_len + len) != 0) return -1;
+            memcpy(ir->text + ir->text_len, s, len); ir->text_len += len;
+            if (kind == IR_TEXT) {
+                int w = run_width(s, len);
+                last->width = (last->width < 0 || w < 0) ? -1 : last->width + w;
+            }
+            last->len += len;
+            return 0;
+        }
+    }
+    if (ir->n == ir->cap) {
+        size_t ncap = ir->cap ? ir->cap * 2 : 256;
+        struct IrOp *nop = (struct IrOp *)realloc(ir->op, ncap * sizeof(*nop));
+        if (!nop) return -1;
+        ir->op = nop; ir->cap = ncap;
+    }
+    if (grow_bytes(&ir->text, &ir->text_cap, ir->text_len + len) != 0) return -1;
+    struct IrOp *op = &ir->op[ir->n++];
+    op->kind = (unsigned char)kind; op->nowrap = (unsigned char)nowrap;
+    op->style = o->style;
+    op->width = kind == IR_TEXT ? run_width(s, len) : 0;
+    op->off = ir->text_len; op->len = len;
+    if (len) memcpy(ir->text + ir->text_len, s, len);
+    ir->text_len += len;
+    return 0;
+}
+
+/* Recording writer: keeps the column bookkeeping of out_write_plain, which
+ * is all the renderer's own decisions depend on, so the IR is the same for
+ * every width. */
+static void out_write_record(struct Out *o, const char *s, size_t len) {
+    struct PrefixStack *ps = &o->prefix;
+    ir_add(o, IR_TEXT, s, len);
+    if (ps->n) prefix_refresh(ps);
+    if (o->col == 0 && ps->n) {
+        o->col = ps->line_w;
+        if (len && ps->fresh < ps->n) { ps->fresh = ps->n; ps->dirty = 1; }
+    }
+    const char *end = s + len;
+    while (s < end) {
+        const char *nl = (const char *)memchr(s, '\n', (size_t)(end - s));
+        if (!nl) { if (o->col == 0) o->col = 1; break; }
+        o->col = ps->n ? ps->wrap_w : 0;
+        s = nl + 1;
+    }
+}
+
+/* Bytes written as they are, after the caller has synced the style. */
+static void out_raw(struct Out *o, const char *s, size_t len) {
+    if (o->ir) ir_add(o, IR_RAW, s, len);
+    else out_bytes(o, s, len);
+}
+
+static void out_fill(struct Out *o, char c, int n) {
+    char chunk[64];
+    memset(chunk, c, sizeof(chunk));
+    for (; n > 0; n -= (int)sizeof(chunk)) out_raw(o, chunk, n < (int)sizeof(chunk) ? (size_t)n : sizeof(chunk));
+}
+
+/* Newline that leaves the column and style alone (table rows). */
+static void out_lf(struct Out *o) {
+    if (o->ir) ir_add(o, IR_LF, NULL, 0);
+    else out_bytes(o, "\n", 1);
+}
+
+/* General writer: wraps at o->width and tracks exact display columns. */
+static void out_write_wrapped(struct Out *o, const char *s, size_t len) {
+    if (len) out_sync_style(o);
+    struct PrefixStack *ps = &o->prefix;
+    struct MdvicWrapPrefix pfx = {0};
+    if (ps->n) {
+        prefix_refresh(ps);
+        pfx.first = ps->line; pfx.first_len = ps->line_len; pfx.first_width = ps->line_w;
+        pfx.next = ps->wrap; pfx.next_len = ps->wrap_len; pfx.next_width = ps->wrap_w;
+    }
+    int started = (o->col == 0 && len > 0);
+    (void)mdvic_wrap_emit(out_sink, o, s, len, o->width, &o->col, ps->n ? &pfx : NULL);
+    /* once a segment has printed its first line it shows its continuation */
+    if (started && ps->fresh < ps->n) { ps->fresh = ps->n; ps->dirty = 1; }
+}
+
+/* No-wrap writer: nothing is measured, bytes are copied between newlines and
+ * prefixes are inserted where the wrapper would put them. */
+static void out_write_plain(struct Out *o, const char *s, size_t len) {
+    struct PrefixStack *ps = &o->prefix;
+    if (ps->n) prefix_refresh(ps);
+    if (o->col == 0 && ps->n) {
+        out_bytes(o, ps->line, ps->line_len);
+        o->col = ps->line_w;
+        if (len && ps->fresh < ps->n) { ps->fresh = ps->n; ps->dirty = 1; }
+    }
+    const char *end = s + len;
+    while (s < end) {
+        const char *nl = (const char *)memchr(s, '\n', (size_t)(end - s));
+        if (!nl) { out_bytes(o, s, (size_t)(end - s)); if (o->col == 0) o->col = 1; break; }
+        out_bytes(o, s, (size_t)(nl - s) + 1);
+        o->col = 0;
+        if (ps->n) { out_bytes(o, ps->wrap, ps->wrap_len); o->col = ps->wrap_w; }
+        s = nl + 1;
+    }
+}
+
+static void out_write_plain_color(struct Out *o, const char *s, size_t len) {
+    if (len) out_sync_style(o);
+    out_write_plain(o, s, len);
 }
 
 static void out_write(struct Out *o, const char *s, size_t len) {
-    (void)mdvic_wrap_write_pref2(o->out, s, len, o->width, &o->col,
-                                 o->prefix_first, o->prefix_first_len,
-                                 o->prefix_next, o->prefix_next_len);
+    o->write(o, s, len);
 }
 
 static void out_text(struct Out *o, const char *s) {
@@ -118,52 +478,237 @@ static void out_text(struct Out *o, const char *s) {
     out_write(o, s, len);
 }
 
+static void out_newline(struct Out *o) {
+    if (o->ir) ir_add(o, IR_NEWLINE, NULL, 0);
+    else out_bytes(o, "\n", 1);
+    o->col = 0;
+}
+
 static void out_puts(struct Out *o, const char *s) {
     out_text(o, s);
-    if (o->col != 0) { fputc('\n', o->out); o->col = 0; }
+    if (o->col != 0) out_newline(o);
 }
 
-static void out_newline(struct Out *o) {
-    fputc('\n', o->out);
-    o->col = 0;
+/* Push a prefix segment: first on the level's first line, next after it. */
+static void out_push_prefix(struct Out *o, const char *first, const char *next) {
+    struct PrefixStack *ps = &o->prefix;
+    size_t n1 = strlen(first), n2 = strlen(next);
+    if (o->ir) {
+        struct MdvicIr *ir = o->ir;
+        if (ir_add(o, IR_PREFIX_PUSH, first, n1 + 1) == 0 && grow_bytes(&ir->text, &ir->text_cap, ir->text_len + n2 + 1) == 0) {
+            memcpy(ir->text + ir->text_len, next, n2 + 1); ir->text_len += n2 + 1; ir->op[ir->n - 1].len += n2 + 1;
+        }
+    }
+    if (ps->n == ps->cap) {
+        size_t ncap = ps->cap ? ps->cap * 2 : 8;
+        struct PrefixSeg *ns = (struct PrefixSeg *)realloc(ps->seg, ncap * sizeof(*ns));
+        if (!ns) return;
+        ps->seg = ns; ps->cap = ncap;
+    }
+    if (grow_bytes(&ps->text, &ps->text_cap, ps->text_len + n1 + n2) != 0) return;
+    struct PrefixSeg *g = &ps->seg[ps->n++];
+    g->first_off = ps->text_len; g->first_len = n1; memcpy(ps->text + ps->text_len, first, n1); ps->text_len += n1;
+    g->next_off = ps->text_len; g->next_len = n2; memcpy(ps->text + ps->text_len, next, n2); ps->text_len += n2;
+    g->first_w = cell_width(first); g->next_w = cell_width(next);
+    ps->dirty = 1;
 }
 
-static void out_set_prefix(struct Out *o, const char *first, const char *next) {
-    size_t n1 = strlen(first);
-    if (n1 > sizeof(o->prefix_first) - 1) n1 = sizeof(o->prefix_first) - 1;
-    memcpy(o->prefix_first, first, n1);
-    o->prefix_first[n1] = '\0';
-    o->prefix_first_len = (int)n1;
-    size_t n2 = strlen(next);
-    if (n2 > sizeof(o->prefix_next) - 1) n2 = sizeof(o->prefix_next) - 1;
-    memcpy(o->prefix_next, next, n2);
-    o->prefix_next[n2] = '\0';
-    o->prefix_next_len = (int)n2;
+static void out_pop_prefix(struct Out *o) {
+    struct PrefixStack *ps = &o->prefix;
+    if (ps->n == 0) return;
+    if (o->ir) ir_add(o, IR_PREFIX_POP, NULL, 0);
+    ps->n--;
+    ps->text_len = ps->seg[ps->n].first_off;
+    if (ps->fresh > ps->n) ps->fresh = ps->n;
+    ps->dirty = 1;
 }
 
-static void out_clear_prefix(struct Out *o) {
-    o->prefix_first[0] = '\0';
-    o->prefix_first_len = 0;
-    o->prefix_next[0] = '\0';
-    o->prefix_next_len = 0;
+static void out_free(struct Out *o) {
+    struct PrefixStack *ps = &o->prefix;
+    free(ps->seg); free(ps->text); free(ps->line); free(ps->wrap);
+    memset(ps, 0, sizeof(*ps));
 }
 
 static void osc8_begin(struct Out *o, const char *url) {
+    if (o->ir) { ir_add(o, IR_LINK_BEGIN, url ? url : "", url ? strlen(url) + 1 : 1); return; }
+    if (o->grid) { mdvic_grid_set_link(o->grid, url); return; }
     if (o->color_enabled && o->osc8_enabled) {
-        fputs("\x1b]8;;", o->out);
-        fputs(url ? url : "", o->out);
-        fputc('\a', o->out);
+        size_t n = url ? strlen(url) : 0;
+        out_bytes(o, "\x1b]8;;", 5);
+        out_bytes(o, url ? url : "", n);
+        out_bytes(o, "\a", 1);
+        if (o->stats) o->stats->escape_bytes += 6 + n;
     }
 }
 
 static void osc8_end(struct Out *o) {
+    if (o->ir) { ir_add(o, IR_LINK_END, NULL, 0); return; }
+    if (o->grid) { mdvic_grid_set_link(o->grid, NULL); return; }
     if (o->color_enabled && o->osc8_enabled) {
-        fputs("\x1b]8;;\a", o->out);
+        out_bytes(o, "\x1b]8;;\a", 6);
+        if (o->stats) o->stats->escape_bytes += 6;
+    }
+}
+
+/* The lint time for --stats and its event for --trace. */
+static void lint_job_account(struct LintJob *j, int tid) {
+    if (j->stats) j->stats->phase_ns[MDVIC_PHASE_LINT] += j->t1 - j->t0;
+    if (j->trace) {
+        struct MdvicTraceSpan sp;
+        memset(&sp, 0, sizeof(sp));
+        sp.name = "lint"; sp.file = j->filename; sp.tid = tid;
+        sp.start_ns = j->t0; sp.end_ns = j->t1;
+        sp.has_range = 1; sp.off = 0; sp.len = j->len;
+        mdvic_trace_span(j->trace, &sp);
+    }
+}
+
+#ifndef _WIN32
+static void *lint_job_run(void *arg) {
+    struct LintJob *j = (struct LintJob *)arg;
+    int timed = j->stats || j->trace;
+    if (timed) j->t0 = mdvic_stats_now();
+    (void)mdvic_lint_scan(j->data, j->len, j->filename, mdvic_diag_collect, &j->found);
+    if (timed) j->t1 = mdvic_stats_now();
+    return NULL;
+}
+#endif
+
+/* Lint data on a thread; small buffers, or no thread, are linted right
+ * away. Either way the findings come out in the same order. */
+static void lint_job_start(struct LintJob *j, const char *data, size_t len, const char *filename, const struct MdvicOptions *opt) {
+    memset(j, 0, sizeof(*j));
+    j->data = data; j->len = len; j->filename = filename;
+    j->stats = opt ? opt->stats : NULL; j->trace = opt ? opt->trace : NULL;
+#ifndef _WIN32
+    if (len >= LINT_THREAD_MIN_BYTES && pthread_create(&j->thread, NULL, lint_job_run, j) == 0) { j->running = 1; return; }
+#endif
+    int timed = j->stats || j->trace;
+    if (timed) j->t0 = mdvic_stats_now();
+    (void)mdvic_lint_buffer(data, len, stderr, filename);
+    if (timed) { j->t1 = mdvic_stats_now(); lint_job_account(j, MDVIC_TRACE_TID_MAIN); }
+}
+
+static void lint_job_finish(struct LintJob *j) {
+    if (!j || !j->running) return;
+#ifndef _WIN32
+    pthread_join(j->thread, NULL);
+#endif
+    j->running = 0;
+    if (j->stats || j->trace) lint_job_account(j, MDVIC_TRACE_TID_LINT);
+    mdvic_diag_list_print(stderr, &j->found, j->filename);
+    mdvic_diag_list_free(&j->found);
+}
+
+static void math_limit_warn(const struct Out *o, const struct MdvicMathSpan *sp, int limit, const struct MdvicOptions *opt) {
+    if (opt && !opt->enable_lint) return;
+    lint_job_finish(o->lint);
+    fprintf(stderr, "%s:%d: math span exceeds %s limit; shown as TeX\n", o->filename ? o->filename : "-",
+            sp->line, mdvic_math_limit_name(limit));
+}
+
+/* Offset of the start of a 1-based line of the input, or input_len past its
+ * end. The cursor moves from the previous lookup in either direction, so
+ * events that arrive in document order cost one pass over the input. */
+static size_t trace_line_off(struct Out *o, int line) {
+    const char *s = o->input; size_t n = o->input_len, i = o->trace_off; int l = o->trace_line;
+    while (l > line && i > 0) { i--; while (i > 0 && s[i - 1] != '\n') i--; l--; }
+    while (l < line) {
+        const char *nl = (const char *)memchr(s + i, '\n', n - i);
+        if (!nl) return n;
+        i = (size_t)(nl - s) + 1; l++;
+    }
+    o->trace_line = l; o->trace_off = i;
+    return i;
+}
+
+/* One --trace event from t0 until now for input lines line..end_line; the
+ * byte range is those lines unless [off, off + len) is given. */
+static void trace_event(struct Out *o, const char *name, unsigned long long t0, int line, int end_line, const char *raw, size_t raw_len) {
+    struct MdvicTraceSpan sp;
+    memset(&sp, 0, sizeof(sp));
+    sp.name = name; sp.file = o->filename; sp.tid = MDVIC_TRACE_TID_MAIN;
+    sp.start_ns = t0; sp.end_ns = mdvic_stats_now();
+    sp.line = line; sp.end_line = end_line;
+    if (o->input && raw && raw >= o->input && raw + raw_len <= o->input + o->input_len) {
+        sp.has_range = 1; sp.off = (size_t)(raw - o->input); sp.len = raw_len;
+    } else if (o->input && line > 0 && !raw) {
+        size_t a = trace_line_off(o, line), b = trace_line_off(o, end_line + 1);
+        if (b > a && o->input[b - 1] == '\n') b--;
+        sp.has_range = 1; sp.off = a; sp.len = b > a ? b - a : 0;
     }
+    mdvic_trace_span(o->trace, &sp);
 }
 
-/* Math-aware text: find $...$ or $$...$$ and render math via mdvic_math_render. */
-static void render_text_with_math(struct Out *o, const char *lit, const struct MdvicOptions *opt) {
+/* Render one math span at the current position; display math sits on its own lines. */
+static void out_math(struct Out *o, const struct MdvicMathSpan *sp, const struct MdvicOptions *opt) {
+    char *mout = NULL; const char *cout = NULL; size_t mlen = 0;
+    if (o->stats) o->stats->math_spans++;
+    unsigned long long t0 = o->trace ? mdvic_stats_now() : 0;
+    int rc = o->math_cache
+        ? mdvic_math_render_cached(o->math_cache, sp->tex, sp->tex_len, opt, sp->display, &cout, &mlen)
+        : mdvic_math_render(sp->tex, sp->tex_len, opt, sp->display, &mout, &mlen);
+    if (mout) cout = mout;
+    if (rc == 0 && cout) {
+        if (sp->display) { if (o->col != 0) out_newline(o); }
+        struct Style saved; style_push(o, &saved, MDVIC_EL_MATH);
+        out_write(o, cout, mlen);
+        style_pop(o, &saved);
+        if (sp->display) { out_newline(o); }
+        free(mout);
+    } else if (rc > 0) {
+        math_limit_warn(o, sp, rc, opt);
+        out_write(o, sp->raw, sp->raw_len);
+    } else {
+        out_write(o, sp->tex, sp->tex_len);
+    }
+    if (o->trace) {
+        int end_line = sp->line;
+        for (const char *p = sp->raw, *e = sp->raw + sp->raw_len; (p = (const char *)memchr(p, '\n', (size_t)(e - p))) != NULL; p++) end_line++;
+        trace_event(o, sp->display ? "display_math" : "math", t0, sp->line, end_line, sp->raw, sp->raw_len);
+    }
+}
+
+/* Next placeholder in [p, end), or NULL. */
+static const char *find_placeholder(const char *p, const char *end, size_t *ph_len, size_t *index) {
+    while (p < end) {
+        p = (const char *)memchr(p, MDVIC_MATH_PH_OPEN[0], (size_t)(end - p));
+        if (!p) return NULL;
+        size_t n = mdvic_math_placeholder_at(p, (size_t)(end - p), index);
+        if (n) { *ph_len = n; return p; }
+        p++;
+    }
+    return NULL;
+}
+
+/* Write literal text (code), putting back the original TeX of any placeholder. */
+static void out_write_restored(struct Out *o, const char *s, size_t len) {
+    const char *p = s, *end = s + len; size_t n = 0, idx = 0;
+    if (o->math) {
+        const char *ph;
+        while ((ph = find_placeholder(p, end, &n, &idx)) != NULL) {
+            if (ph > p) out_write(o, p, (size_t)(ph - p));
+            if (idx < o->math->count) out_write(o, o->math->spans[idx].raw, o->math->spans[idx].raw_len);
+            p = ph + n;
+        }
+    }
+    if (end > p) out_write(o, p, (size_t)(end - p));
+}
+
+/* Math-aware text. With pre-extracted spans the text only carries placeholders;
+ * otherwise find $...$ or $$...$$ here and render math via mdvic_math_render. */
+static void render_text_with_math(struct Out *o, const char *lit, int line, const struct MdvicOptions *opt) {
+    if (o->math) {
+        const char *p = lit, *end = lit + strlen(lit); size_t n = 0, idx = 0;
+        const char *ph;
+        while ((ph = find_placeholder(p, end, &n, &idx)) != NULL) {
+            if (ph > p) out_write(o, p, (size_t)(ph - p));
+            if (idx < o->math->count) out_math(o, &o->math->spans[idx], opt);
+            p = ph + n;
+        }
+        if (end > p) out_write(o, p, (size_t)(end - p));
+        return;
+    }
     const char *p = lit;
     while (*p) {
         const char *d = strchr(p, '$');
@@ -194,26 +739,89 @@ static void render_text_with_math(struct Out *o, const char *lit, const struct M
             out_write(o, d, strlen(d));
             break;
         }
-        char *mout = NULL; size_t mlen = 0;
-        int is_display = (count >= 2);
-        if (mdvic_math_render(start, (size_t)(end - start), opt, is_display, &mout, &mlen) == 0 && mout) {
-            if (is_display) { if (o->col != 0) out_newline(o); }
-            out_write(o, mout, mlen);
-            if (is_display) { out_newline(o); }
-            free(mout);
-        } else {
-            out_write(o, start, (size_t)(end - start));
-        }
+        struct MdvicMathSpan sp;
+        sp.raw = d; sp.raw_len = (size_t)(end + count - d);
+        sp.tex = start; sp.tex_len = (size_t)(end - start);
+        sp.display = count >= 2; sp.line = line;
+        out_math(o, &sp, opt);
         p = end + count;
     }
 }
 
+/* Code lines are never wrapped, so they skip the wrapper: the line prefix
+ * and indent are written once, then the bytes are copied through. Tabs expand
+ * to stops every 8 columns from the start of the code, counting display
+ * columns by mdvic_wcwidth; lines without tabs are not scanned at all. */
+#define CODE_INDENT "    "
+#define CODE_TAB_STOP 8
+
+static void out_code_begin(struct Out *o, const char *line, size_t len) {
+    struct PrefixStack *ps = &o->prefix;
+    out_sync_style(o);
+    if (o->ir) ir_add(o, IR_CODE, NULL, 0);
+    int w = 0;
+    if (ps->n) {
+        prefix_refresh(ps);
+        if (!o->ir) out_bytes(o, ps->line, ps->line_len);
+        w = ps->line_w;
+        if (ps->fresh < ps->n) { ps->fresh = ps->n; ps->dirty = 1; }
+    }
+    if (!o->ir) out_bytes(o, CODE_INDENT, sizeof(CODE_INDENT) - 1);
+    o->col = w + (int)sizeof(CODE_INDENT) - 1;
+    o->code_col = memchr(line, '\t', len) ? 0 : -1;
+}
+
+static void out_code_put(struct Out *o, const char *s, size_t len) {
+    if (len == 0) return;
+    out_sync_style(o);
+    if (o->code_col < 0) { out_raw(o, s, len); return; }
+    static const char spaces[CODE_TAB_STOP] = "        ";
+    const char *end = s + len;
+    while (s < end) {
+        const char *tab = (const char *)memchr(s, '\t', (size_t)(end - s));
+        const char *stop = tab ? tab : end;
+        out_raw(o, s, (size_t)(stop - s));
+        for (const char *p = s; p < stop; ) {
+            unsigned char c = (unsigned char)*p;
+            size_t n = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+            if (n > (size_t)(stop - p)) { o->code_col++; break; }
+            uint32_t cp; p += mdvic_utf8_decode(p, &cp);
+            int cw = mdvic_wcwidth(cp);
+            if (cw > 0) o->code_col += cw;
+        }
+        if (!tab) break;
+        int n = CODE_TAB_STOP - o->code_col % CODE_TAB_STOP;
+        out_raw(o, spaces, (size_t)n);
+        o->code_col += n;
+        s = tab + 1;
+    }
+}
+
 #ifdef HAVE_LIBCMARK
-static void render_node(struct Out *o, cmark_node *node, const struct MdvicOptions *opt);
+static const int hl_elements[MDVIC_HL_KIND_COUNT] = {
+    -1, MDVIC_EL_CODE_KEYWORD, MDVIC_EL_CODE_TYPE, MDVIC_EL_CODE_LITERAL, MDVIC_EL_CODE_STRING,
+    MDVIC_EL_CODE_NUMBER, MDVIC_EL_CODE_COMMENT, MDVIC_EL_CODE_PREPROC
+};
+
+/* Highlighter callback: one styled write per token run. */
+static void hl_emit(void *ctx, int kind, const char *s, size_t len) {
+    struct Out *o = (struct Out *)ctx;
+    struct Style saved; style_push(o, &saved, hl_elements[kind]);
+    out_code_put(o, s, len);
+    style_pop(o, &saved);
+}
+
+static void render_tree(struct Out *o, cmark_node *root, int with_root, const struct MdvicOptions *opt);
 
-static void render_inlines(struct Out *o, cmark_node *node, const struct MdvicOptions *opt) {
-    for (cmark_node *n = cmark_node_first_child(node); n; n = cmark_node_next(n)) {
-        render_node(o, n, opt);
+/* Nodes the iterator reports with a single enter event. */
+static int node_is_leaf(cmark_node *node) {
+    switch (cmark_node_get_type(node)) {
+    case CMARK_NODE_TEXT: case CMARK_NODE_SOFTBREAK: case CMARK_NODE_LINEBREAK: case CMARK_NODE_CODE:
+    case CMARK_NODE_HTML_INLINE: case CMARK_NODE_CODE_BLOCK: case CMARK_NODE_HTML_BLOCK:
+    case CMARK_NODE_THEMATIC_BREAK:
+        return 1;
+    default:
+        return 0;
     }
 }
 
@@ -239,31 +847,58 @@ static int buf_putc(struct Buf *b, char c) {
 }
 static void buf_free(struct Buf *b) { free(b->p); b->p = NULL; b->n = b->cap = 0; }
 
-static void collect_plain_text_inline(struct Buf *b, cmark_node *node) {
-    switch (cmark_node_get_type(node)) {
-    case CMARK_NODE_TEXT:
-    case CMARK_NODE_CODE: {
-        const char *lit = cmark_node_get_literal(node);
-        if (lit) buf_puts(b, lit);
-        break;
-    }
-    case CMARK_NODE_SOFTBREAK:
-        buf_putc(b, '\n'); break;
-    case CMARK_NODE_LINEBREAK:
-        buf_putc(b, '\n'); break;
-    case CMARK_NODE_EMPH:
-    case CMARK_NODE_STRONG:
-    case CMARK_NODE_LINK:
-    case CMARK_NODE_IMAGE: {
-        for (cmark_node *n = cmark_node_first_child(node); n; n = cmark_node_next(n)) {
-            collect_plain_text_inline(b, n);
+/* Append a literal to b, expanding placeholders: rendered math for text,
+ * the original TeX for code. */
+static void buf_put_literal(struct Out *o, struct Buf *b, const char *lit, int is_code, const struct MdvicOptions *opt) {
+    const char *p = lit, *end = lit + strlen(lit); size_t n = 0, idx = 0;
+    if (o->math) {
+        const char *ph;
+        while ((ph = find_placeholder(p, end, &n, &idx)) != NULL) {
+            if (ph > p && buf_grow(b, (size_t)(ph - p)) == 0) { memcpy(b->p + b->n, p, (size_t)(ph - p)); b->n += (size_t)(ph - p); b->p[b->n] = '\0'; }
+            if (idx < o->math->count) {
+                const struct MdvicMathSpan *sp = &o->math->spans[idx];
+                const char *m = sp->raw; size_t mlen = sp->raw_len; char *own = NULL;
+                if (!is_code) {
+                    int rc = o->math_cache
+                        ? mdvic_math_render_cached(o->math_cache, sp->tex, sp->tex_len, opt, sp->display, &m, &mlen)
+                        : mdvic_math_render(sp->tex, sp->tex_len, opt, sp->display, &own, &mlen);
+                    if (own) m = own;
+                    if (rc > 0) { math_limit_warn(o, sp, rc, opt); m = sp->raw; mlen = sp->raw_len; }
+                    else if (rc < 0) { m = sp->tex; mlen = sp->tex_len; }
+                }
+                if (buf_grow(b, mlen) == 0) { memcpy(b->p + b->n, m, mlen); b->n += mlen; b->p[b->n] = '\0'; }
+                free(own);
+            }
+            p = ph + n;
         }
-        break;
     }
-    default:
-        /* ignore */
-        break;
+    if (end > p) buf_puts(b, p);
+}
+
+/* Append the plain text under node (text, code, breaks) to b. */
+static void collect_plain_text(struct Out *o, struct Buf *b, cmark_node *node, const struct MdvicOptions *opt) {
+    cmark_iter *it = cmark_iter_new(node);
+    if (!it) return;
+    cmark_event_type ev;
+    while ((ev = cmark_iter_next(it)) != CMARK_EVENT_DONE) {
+        if (ev != CMARK_EVENT_ENTER) continue;
+        cmark_node *n = cmark_iter_get_node(it);
+        switch (cmark_node_get_type(n)) {
+        case CMARK_NODE_TEXT:
+        case CMARK_NODE_CODE: {
+            const char *lit = cmark_node_get_literal(n);
+            if (lit) buf_put_literal(o, b, lit, cmark_node_get_type(n) == CMARK_NODE_CODE, opt);
+            break;
+        }
+        case CMARK_NODE_SOFTBREAK:
+        case CMARK_NODE_LINEBREAK:
+            buf_putc(b, '\n'); break;
+        default:
+            /* containers are descended into, other leaves ignored */
+            break;
+        }
     }
+    cmark_iter_free(it);
 }
 
 static char *str_trim(char *s) {
@@ -273,6 +908,13 @@ static char *str_trim(char *s) {
     return s;
 }
 
+/* 1-based byte column of p in the NUL-split line buffer starting at base. */
+static int line_col(const char *base, const char *p) {
+    const char *q = p;
+    while (q > base && q[-1] != '\0') q--;
+    return (int)(p - q) + 1;
+}
+
 static int split_pipe(char *line, char ***out_fields, int *out_count) {
     int cap = 8, n = 0; char **arr = (char **)malloc((size_t)cap * sizeof(char*)); if (!arr) return -1;
     char *p = line;
@@ -313,47 +955,35 @@ static int parse_sep_fields(char **fields, int n, int *align) {
     return 0;
 }
 
-static int cell_width(const char *s) {
-    /* measure display width using wcwidth */
-    int w = 0; const char *p = s;
-    while (*p) {
-        unsigned char c0 = (unsigned char)*p;
-        size_t consumed = 1; uint32_t cp = 0;
-        if ((c0 & 0x80) == 0) { cp = c0; }
-        else if ((c0 & 0xE0) == 0xC0 && (p[1] & 0xC0) == 0x80) { cp = ((uint32_t)(c0 & 0x1F) << 6) | (uint32_t)(p[1] & 0x3F); consumed = 2; }
-        else if ((c0 & 0xF0) == 0xE0 && (p[1] & 0xC0) == 0x80 && (p[2] & 0xC0) == 0x80) { cp = ((uint32_t)(c0 & 0x0F) << 12) | ((uint32_t)(p[1] & 0x3F) << 6) | (uint32_t)(p[2] & 0x3F); consumed = 3; }
-        else if ((c0 & 0xF8) == 0xF0 && (p[1] & 0xC0) == 0x80 && (p[2] & 0xC0) == 0x80 && (p[3] & 0xC0) == 0x80) { cp = ((uint32_t)(c0 & 0x07) << 18) | ((uint32_t)(p[1] & 0x3F) << 12) | ((uint32_t)(p[2] & 0x3F) << 6) | (uint32_t)(p[3] & 0x3F); consumed = 4; }
-        else { cp = c0; consumed = 1; }
-        w += mdvic_wcwidth(cp);
-        p += consumed;
-    }
-    return w < 0 ? 0 : w;
-}
-
 /* Forward decls for style helpers used in cell rendering */
-static void style_push(struct Out *o, struct Style *saved, const struct Style *delta);
-static void style_pop(struct Out *o, const struct Style *saved);
 
-static int line_span_from_source(const char *src, size_t len, int start_line, int end_line, size_t *out_s, size_t *out_e) {
+/* Byte span of source lines start_line..end_line. Blocks are visited in
+ * document order, so the scan resumes from the previous lookup. */
+static int line_span_from_source(struct Out *o, int start_line, int end_line, size_t *out_s, size_t *out_e) {
+    const char *src = o->source; size_t len = o->source_len;
     if (start_line < 1 || end_line < start_line) return -1;
     int line = 1; size_t i = 0; size_t s = 0, e = len;
-    while (i < len && line < start_line) { if (src[i++] == '\n') line++; }
+    if (o->span_line > 1 && o->span_line <= start_line) { line = o->span_line; i = o->span_off; }
+    while (i < len && line < start_line) {
+        const char *nl = (const char *)memchr(src + i, '\n', len - i);
+        if (!nl) { i = len; break; }
+        i = (size_t)(nl - src) + 1; line++;
+    }
     if (line != start_line) return -1; s = i;
+    o->span_line = line; o->span_off = i;
     while (i < len && line <= end_line) { if (src[i++] == '\n') line++; }
     e = (line > end_line) ? (i - 1) : i;
     *out_s = s; *out_e = e; return 0;
 }
 
-static int rendered_text_width(const char *s) {
+static int rendered_text_width(struct Out *o, const char *s, const struct MdvicOptions *opt) {
 #ifdef HAVE_LIBCMARK
     cmark_node *doc = cmark_parse_document(s, strlen(s), CMARK_OPT_DEFAULT);
     if (!doc) return cell_width(s);
     struct Buf b; buf_init(&b);
     for (cmark_node *blk = cmark_node_first_child(doc); blk; blk = cmark_node_next(blk)) {
         if (cmark_node_get_type(blk) == CMARK_NODE_PARAGRAPH) {
-            for (cmark_node *n = cmark_node_first_child(blk); n; n = cmark_node_next(n)) {
-                collect_plain_text_inline(&b, n);
-            }
+            collect_plain_text(o, &b, blk, opt);
         }
     }
     int w = cell_width(b.p ? b.p : "");
@@ -365,16 +995,28 @@ static int rendered_text_width(const char *s) {
 #endif
 }
 
+/* Table borders and padding are written directly, after syncing the style. */
+static void tbl_border(struct Out *o, const char *s) {
+    struct Style saved; style_push(o, &saved, MDVIC_EL_TABLE_BORDER); out_sync_style(o);
+    out_raw(o, s, strlen(s));
+    style_pop(o, &saved);
+}
+
+static void tbl_pad(struct Out *o, int n) {
+    out_sync_style(o);
+    out_fill(o, ' ', n);
+}
+
 static void render_cell_content(struct Out *o, const char *s, int is_header, const struct MdvicOptions *opt) {
 #ifdef HAVE_LIBCMARK
     cmark_node *doc = cmark_parse_document(s, strlen(s), CMARK_OPT_DEFAULT);
     if (doc) {
-        struct Style saved, delta; style_init(&delta); if (is_header) delta.bold = 1;
-        style_push(o, &saved, &delta);
+        struct Style saved;
+        style_push(o, &saved, is_header ? MDVIC_EL_TABLE_HEADER : -1);
         int saved_w = o->width; o->width = 0;
         for (cmark_node *blk = cmark_node_first_child(doc); blk; blk = cmark_node_next(blk)) {
             if (cmark_node_get_type(blk) == CMARK_NODE_PARAGRAPH) {
-                render_inlines(o, blk, opt);
+                render_tree(o, blk, 0, opt);
             }
         }
         o->width = saved_w;
@@ -385,16 +1027,51 @@ static void render_cell_content(struct Out *o, const char *s, int is_header, con
 #endif
     /* Fallback: plain */
     int saved_w = o->width; o->width = 0;
-    if (is_header) { struct Style saved, delta; style_init(&delta); delta.bold = 1; style_push(o, &saved, &delta); out_text(o, s); style_pop(o, &saved); }
+    if (is_header) { struct Style saved; style_push(o, &saved, MDVIC_EL_TABLE_HEADER); out_text(o, s); style_pop(o, &saved); }
     else { out_text(o, s); }
     o->width = saved_w;
 }
 
+/* Source line and code-point column of byte column mcol on masked line mline;
+ * placeholders before it count as the TeX they stand for. */
+static void source_pos(struct Out *o, int mline, int mcol, int *line, int *col) {
+    size_t s = 0, e = 0, n = 0, idx = 0;
+    *line = mdvic_math_source_line(o->math, mline); *col = 1;
+    if (mcol < 1 || line_span_from_source(o, mline, mline, &s, &e) != 0) return;
+    const char *p = o->source + s, *end = o->source + e;
+    const char *stop = (size_t)(mcol - 1) < e - s ? p + (mcol - 1) : end;
+    while (p < stop) {
+        if (o->math && *p == MDVIC_MATH_PH_OPEN[0] && (n = mdvic_math_placeholder_at(p, (size_t)(end - p), &idx)) != 0) {
+            if (idx < o->math->count) {
+                const struct MdvicMathSpan *sp = &o->math->spans[idx];
+                for (size_t i = 0; i < sp->raw_len; i++) {
+                    if (sp->raw[i] == '\n') { (*line)++; *col = 1; }
+                    else if (((unsigned char)sp->raw[i] & 0xC0) != 0x80) (*col)++;
+                }
+            }
+            p += n;
+            continue;
+        }
+        if (((unsigned char)*p & 0xC0) != 0x80) (*col)++;
+        p++;
+    }
+}
+
+/* line and col are positions in o->source, mapped back through any math masking. */
+static void out_diag(struct Out *o, int line, int col, const char *rule, const char *message) {
+    struct MdvicDiag d;
+    d.file = o->filename ? o->filename : "-";
+    source_pos(o, line, col, &d.line, &d.col);
+    d.rule = rule; d.message = message;
+    if (o->diag) o->diag(o->diag_ctx, &d);
+    else { lint_job_finish(o->lint); mdvic_diag_print(stderr, &d); }
+    o->diag_count++;
+}
+
 static int mdvic_render_gfm_table_if_any(struct Out *o, cmark_node *node, const struct MdvicOptions *opt) {
-    (void)opt;
     if (!o->source) return 0;
     size_t sidx = 0, eidx = 0;
-    if (line_span_from_source(o->source, o->source_len, cmark_node_get_start_line(node), cmark_node_get_end_line(node), &sidx, &eidx) != 0) return 0;
+    if (line_span_from_source(o, cmark_node_get_start_line(node), cmark_node_get_end_line(node), &sidx, &eidx) != 0) return 0;
     struct Buf b; buf_init(&b);
     if (buf_puts(&b, "") != 0) { buf_free(&b); return 0; }
     if (buf_grow(&b, eidx - sidx) != 0) { buf_free(&b); return 0; }
@@ -425,7 +1102,7 @@ static int mdvic_render_gfm_table_if_any(struct Out *o, cmark_node *node, const
     char **sep_fields = NULL; int ncols = 0; if (split_pipe(sep_line, &sep_fields, &ncols) != 0 || ncols <= 0) { free(sep_line); free(lines); buf_free(&b); return 0; }
     int *align = (int *)calloc((size_t)ncols, sizeof(int)); if (!align) { free(sep_fields); free(sep_line); free(lines); buf_free(&b); return 0; }
     if (parse_sep_fields(sep_fields, ncols, align) != 0) {
-        if (!opt || opt->enable_lint) fprintf(stderr, "%s:%d: malformed table separator row\n", o->filename ? o->filename : "-", cmark_node_get_start_line(node) + 1);
+        if (!opt || opt->enable_lint) out_diag(o, cmark_node_get_start_line(node) + 1, line_col(b.p, lines[1]), "table-separator", "malformed table separator row");
         free(align); free(sep_fields); free(sep_line); free(lines); buf_free(&b); return 0;
     }
     free(sep_fields); free(sep_line);
@@ -446,8 +1123,8 @@ static int mdvic_render_gfm_table_if_any(struct Out *o, cmark_node *node, const
             if (!nr || !nc) { /* out of mem */ break; }
             rows = nr; row_counts = nc; rows_cap = ncap;
         }
-        char *dup = strdup(lines[li]); if (!dup) break;
-        char **cells = NULL; int cn = 0; if (split_pipe(dup, &cells, &cn) != 0) { free(dup); break; }
+        /* body lines are not needed after this, so split them in place */
+        char **cells = NULL; int cn = 0; if (split_pipe(lines[li], &cells, &cn) != 0) break;
         rows[rows_n] = cells; row_counts[rows_n] = cn; rows_n++;
     }
 
@@ -456,249 +1133,285 @@ static int mdvic_render_gfm_table_if_any(struct Out *o, cmark_node *node, const
 
     /* Compute col widths based on rendered text widths */
     int *colw = (int *)calloc((size_t)ncols, sizeof(int)); if (!colw) { for (int r=0;r<rows_n;r++) free(rows[r]); free(row_counts); free(rows); free(hdr_cells); free(hdr_line); free(align); free(lines); buf_free(&b); return 0; }
-    for (int i = 0; i < ncols; i++) {
+    for (int i = 0; i < ncols && !o->lint_only; i++) {
         const char *hc = (i < hdr_n) ? hdr_cells[i] : "";
-        int w = rendered_text_width(hc); if (w > colw[i]) colw[i] = w;
+        int w = rendered_text_width(o, hc, opt); if (w > colw[i]) colw[i] = w;
     }
     for (int r = 0; r < rows_n; r++) {
-        if (row_counts[r] != ncols) {
-            if (!opt || opt->enable_lint) fprintf(stderr, "%s:%d: table row has %d columns; expected %d\n", o->filename ? o->filename : "-", cmark_node_get_start_line(node) + 1 + r + 2, row_counts[r], ncols);
+        if (row_counts[r] != ncols && (!opt || opt->enable_lint)) {
+            char msg[80];
+            snprintf(msg, sizeof(msg), "table row has %d columns; expected %d", row_counts[r], ncols);
+            out_diag(o, cmark_node_get_start_line(node) + 2 + r, line_col(b.p, lines[2 + r]), "table-columns", msg);
         }
+        if (o->lint_only) continue;
         for (int i = 0; i < ncols; i++) {
             const char *c = (i < row_counts[r]) ? rows[r][i] : "";
-            int w = rendered_text_width(c); if (w > colw[i]) colw[i] = w;
+            int w = rendered_text_width(o, c, opt); if (w > colw[i]) colw[i] = w;
         }
     }
 
+    if (o->lint_only) {
+        for (int r = 0; r < rows_n; r++) free(rows[r]);
+        free(colw); free(row_counts); free(rows); free(hdr_cells); free(hdr_line); free(align); free(lines); buf_free(&b);
+        return 1;
+    }
+
     /* Print table */
+    if (o->stats) o->stats->table_cells += (unsigned long)(rows_n + 1) * (unsigned long)ncols;
     int saved_w = o->width; o->width = 0;
     /* header */
-    fputc('|', o->out);
+    tbl_border(o, "|");
     for (int i = 0; i < ncols; i++) {
-        fputc(' ', o->out);
+        tbl_pad(o, 1);
         const char *hc = (i < hdr_n) ? hdr_cells[i] : "";
         /* left pad according to alignment */
-        int w = rendered_text_width(hc);
+        int w = rendered_text_width(o, hc, opt);
         int pad = (w < colw[i]) ? (colw[i] - w) : 0;
         int lp=0, rp=0; if (align[i] == 2) { lp = pad; } else if (align[i] == 1) { lp = pad/2; rp = pad - lp; } else { rp = pad; }
-        for (int k=0;k<lp;k++) fputc(' ', o->out);
+        tbl_pad(o, lp);
         render_cell_content(o, hc, 1, opt);
-        for (int k=0;k<rp;k++) fputc(' ', o->out);
-        fputc(' ', o->out);
-        fputc('|', o->out);
+        tbl_pad(o, rp);
+        tbl_pad(o, 1);
+        tbl_border(o, "|");
     }
-    fputc('\n', o->out);
+    out_lf(o);
     /* separator (render according to width) */
-    fputc('|', o->out);
+    tbl_border(o, "|");
     for (int i = 0; i < ncols; i++) {
-        fputc(' ', o->out);
+        tbl_pad(o, 1);
         int left = (align[i] == 1 || align[i] == 0) ? 1 : 0;
         int right = (align[i] == 1 || align[i] == 2) ? 1 : 0;
-        if (left) fputc(':', o->out);
-        for (int k = 0; k < colw[i]; k++) fputc('-', o->out);
-        if (right) fputc(':', o->out);
-        fputc(' ', o->out);
-        fputc('|', o->out);
+        struct Style saved; style_push(o, &saved, MDVIC_EL_TABLE_BORDER); out_sync_style(o);
+        if (left) out_raw(o, ":", 1);
+        out_fill(o, '-', colw[i]);
+        if (right) out_raw(o, ":", 1);
+        style_pop(o, &saved);
+        tbl_pad(o, 1);
+        tbl_border(o, "|");
     }
-    fputc('\n', o->out);
+    out_lf(o);
     /* rows */
     for (int r = 0; r < rows_n; r++) {
-        fputc('|', o->out);
+        tbl_border(o, "|");
         for (int i = 0; i < ncols; i++) {
-            fputc(' ', o->out);
+            tbl_pad(o, 1);
             const char *c = (i < row_counts[r]) ? rows[r][i] : "";
-            int w = rendered_text_width(c);
+            int w = rendered_text_width(o, c, opt);
             int pad = (w < colw[i]) ? (colw[i] - w) : 0;
             int lp=0, rp=0; if (align[i] == 2) { lp = pad; } else if (align[i] == 1) { lp = pad/2; rp = pad - lp; } else { rp = pad; }
-            for (int k=0;k<lp;k++) fputc(' ', o->out);
+            tbl_pad(o, lp);
             render_cell_content(o, c, 0, opt);
-            for (int k=0;k<rp;k++) fputc(' ', o->out);
-            fputc(' ', o->out);
-            fputc('|', o->out);
+            tbl_pad(o, rp);
+            tbl_pad(o, 1);
+            tbl_border(o, "|");
         }
-        fputc('\n', o->out);
+        out_lf(o);
     }
-    fputc('\n', o->out);
+    out_lf(o);
     o->width = saved_w;
 
     /* cleanup */
     for (int r = 0; r < rows_n; r++) free(rows[r]);
-    free(row_counts); free(rows);
+    free(colw); free(row_counts); free(rows);
     free(hdr_cells); free(hdr_line);
     free(align);
     free(lines); buf_free(&b);
     return 1;
 }
 
-static void style_push(struct Out *o, struct Style *saved, const struct Style *delta) {
-    *saved = o->style;
-    if (delta->bold) o->style.bold = 1;
-    if (delta->italic) o->style.italic = 1;
-    if (delta->underline) o->style.underline = 1;
-    if (delta->inverse) o->style.inverse = 1;
-    if (delta->dim) o->style.dim = 1;
-    if (delta->fg >= 0) o->style.fg = delta->fg;
-    out_emit_style(o);
-}
+/* State saved when entering a container node and restored on its exit. */
+struct Frame {
+    struct Style saved;
+    int index;      /* lists: number of the next item */
+    int prev_tight; /* lists: enclosing list's tightness */
+};
 
-static void style_pop(struct Out *o, const struct Style *saved) {
-    o->style = *saved;
-    out_emit_style(o);
-}
+struct FrameStack { struct Frame *f; size_t n, cap; };
 
-static void render_node(struct Out *o, cmark_node *node, const struct MdvicOptions *opt) {
-    switch (cmark_node_get_type(node)) {
-    case CMARK_NODE_DOCUMENT: {
-        for (cmark_node *n = cmark_node_first_child(node); n; n = cmark_node_next(n)) {
-            render_node(o, n, opt);
-        }
-        break;
+static struct Frame *frame_push(struct FrameStack *fs) {
+    if (fs->n == fs->cap) {
+        size_t ncap = fs->cap ? fs->cap * 2 : 32;
+        struct Frame *nf = (struct Frame *)realloc(fs->f, ncap * sizeof(*nf));
+        if (!nf) return NULL;
+        fs->f = nf; fs->cap = ncap;
     }
-    case CMARK_NODE_PARAGRAPH: {
-        if (!mdvic_render_gfm_table_if_any(o, node, opt)) {
-            render_inlines(o, node, opt);
-            if (o->list_depth > 0) {
-                if (o->list_tight) {
-                    out_newline(o);
-                } else {
-                    out_newline(o);
-                    out_newline(o);
-                }
-            } else {
-                out_newline(o);
-                out_newline(o);
-            }
-        }
-        break;
-    }
-    case CMARK_NODE_HEADING: {
-        int level = cmark_node_get_heading_level(node);
-        struct Style saved, delta; style_init(&delta);
-        delta.bold = 1;
-        delta.fg = heading_color_code(level);
-        style_push(o, &saved, &delta);
-        render_inlines(o, node, opt);
+    struct Frame *f = &fs->f[fs->n++];
+    memset(f, 0, sizeof(*f));
+    return f;
+}
+
+static void render_code_block(struct Out *o, cmark_node *node, const struct MdvicOptions *opt) {
+    const char *lit = cmark_node_get_literal(node);
+    const struct MdvicHlLang *lang = NULL;
+    if (o->color_enabled && opt && opt->enable_highlight) lang = mdvic_hl_find(cmark_node_get_fence_info(node));
+    struct MdvicHlState hl = {0, 0};
+    /* Print as indented block without wrapping */
+    if (!lit) return;
+    const char *p = lit, *end = lit + strlen(lit);
+    while (p < end) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        size_t seg = nl ? (size_t)(nl - p) : (size_t)(end - p);
+        out_code_begin(o, p, seg);
+        struct Style saved; style_push(o, &saved, MDVIC_EL_CODE_BLOCK);
+        if (lang) mdvic_hl_line(lang, &hl, p, seg, hl_emit, o);
+        else out_code_put(o, p, seg);
         style_pop(o, &saved);
         out_newline(o);
-        out_newline(o);
-        break;
+        if (!nl) break;
+        p = nl + 1;
     }
+    out_newline(o);
+}
+
+/* Leaf nodes only see an enter event. */
+static void render_leaf(struct Out *o, cmark_node *node, const struct MdvicOptions *opt) {
+    switch (cmark_node_get_type(node)) {
     case CMARK_NODE_TEXT: {
         const char *lit = cmark_node_get_literal(node);
         if (lit) {
             /* math-aware write */
-            render_text_with_math(o, lit, opt);
+            render_text_with_math(o, lit, cmark_node_get_start_line(node), opt);
         }
         break;
     }
-    case CMARK_NODE_SOFTBREAK: {
+    case CMARK_NODE_SOFTBREAK:
         out_write(o, " ", 1);
         break;
-    }
-    case CMARK_NODE_LINEBREAK: {
+    case CMARK_NODE_LINEBREAK:
         out_newline(o);
         break;
-    }
-    case CMARK_NODE_STRONG: {
-        struct Style saved, delta; style_init(&delta); delta.bold = 1;
-        style_push(o, &saved, &delta);
-        render_inlines(o, node, opt);
+    case CMARK_NODE_CODE: {
+        const char *lit = cmark_node_get_literal(node);
+        struct Style saved;
+        style_push(o, &saved, MDVIC_EL_CODE);
+        if (lit) out_write_restored(o, lit, strlen(lit));
         style_pop(o, &saved);
         break;
     }
-    case CMARK_NODE_EMPH: {
-        struct Style saved, delta; style_init(&delta); delta.italic = 1;
-        style_push(o, &saved, &delta);
-        render_inlines(o, node, opt);
-        style_pop(o, &saved);
+    case CMARK_NODE_CODE_BLOCK:
+        render_code_block(o, node, opt);
         break;
-    }
-    case CMARK_NODE_CODE: {
-        const char *lit = cmark_node_get_literal(node);
-        struct Style saved, delta; style_init(&delta); delta.inverse = 1;
-        style_push(o, &saved, &delta);
-        if (lit) out_write(o, lit, strlen(lit));
-        style_pop(o, &saved);
+    case CMARK_NODE_THEMATIC_BREAK:
+        out_puts(o, "-----");
+        out_newline(o);
+        break;
+    default:
         break;
     }
-    case CMARK_NODE_CODE_BLOCK: {
-        const char *lit = cmark_node_get_literal(node);
-        (void)cmark_node_get_fence_info(node);
-        /* Print as indented block without wrapping */
-        if (lit) {
-            const char *p = lit;
-            while (*p) {
-                const char *nl = strchr(p, '\n');
-                size_t seg = nl ? (size_t)(nl - p) : strlen(p);
-                out_write(o, "    ", 4);
-                /* Temporarily bypass soft wrap for code by using width=0 */
-                int saved_w = o->width; o->width = 0;
-                out_write(o, p, seg);
-                o->width = saved_w;
-                out_newline(o);
-                if (!nl) break;
-                p = nl + 1;
-            }
-            out_newline(o);
-        }
+}
+
+/* --trace event for a block, with its lines mapped back to the input. */
+static void trace_node(struct Out *o, const char *name, cmark_node *node, unsigned long long t0) {
+    int line = cmark_node_get_start_line(node), end = cmark_node_get_end_line(node);
+    if (line > 0) { end = mdvic_math_source_line(o->math, (end >= line ? end : line) + 1) - 1; line = mdvic_math_source_line(o->math, line); }
+    trace_event(o, name, t0, line, end, NULL, 0);
+}
+
+/* Returns 0 to descend into the node, 1 to skip its children. */
+static int render_enter(struct Out *o, cmark_node *node, struct Frame *f, struct Frame *parent, const struct MdvicOptions *opt) {
+    switch (cmark_node_get_type(node)) {
+    case CMARK_NODE_PARAGRAPH: {
+        unsigned long long t0 = o->trace ? mdvic_stats_now() : 0;
+        int table = mdvic_render_gfm_table_if_any(o, node, opt);
+        if (table && o->trace) trace_node(o, "table", node, t0);
+        return table;
+    }
+    case CMARK_NODE_HEADING: {
+        int level = cmark_node_get_heading_level(node);
+        style_push(o, &f->saved, (level >= 1 && level <= 6) ? MDVIC_EL_H1 + level - 1 : MDVIC_EL_STRONG);
         break;
     }
+    case CMARK_NODE_STRONG:
+        style_push(o, &f->saved, MDVIC_EL_STRONG);
+        break;
+    case CMARK_NODE_EMPH:
+        style_push(o, &f->saved, MDVIC_EL_EMPH);
+        break;
     case CMARK_NODE_LIST: {
-        int tight = cmark_node_get_list_tight(node);
-        cmark_list_type lt = cmark_node_get_list_type(node);
         int start = cmark_node_get_list_start(node);
-        int index = start ? start : 1;
+        f->index = start ? start : 1;
         o->list_depth++;
-        int prev_tight = o->list_tight; o->list_tight = tight ? 1 : 0;
-        for (cmark_node *it = cmark_node_first_child(node); it; it = cmark_node_next(it)) {
-            char bullet[32], spaces[32];
-            if (lt == CMARK_ORDERED_LIST) { snprintf(bullet, sizeof(bullet), "%d. ", index++); }
-            else { snprintf(bullet, sizeof(bullet), "- "); }
-            size_t blen = strlen(bullet);
-            if (blen >= sizeof(spaces)) blen = sizeof(spaces)-1;
-            for (size_t k = 0; k < blen; k++) spaces[k] = ' ';
-            spaces[blen] = '\0';
-            out_set_prefix(o, bullet, spaces);
-            /* Render item children (blocks) */
-            for (cmark_node *blk = cmark_node_first_child(it); blk; blk = cmark_node_next(blk)) {
-                render_node(o, blk, opt);
+        f->prev_tight = o->list_tight; o->list_tight = cmark_node_get_list_tight(node) ? 1 : 0;
+        break;
+    }
+    case CMARK_NODE_ITEM: {
+        char bullet[32], spaces[32];
+        cmark_node *list = cmark_node_parent(node);
+        if (list && cmark_node_get_list_type(list) == CMARK_ORDERED_LIST) {
+            snprintf(bullet, sizeof(bullet), "%d. ", parent ? parent->index++ : 1);
+        } else { snprintf(bullet, sizeof(bullet), "- "); }
+        size_t blen = strlen(bullet);
+        if (blen >= sizeof(spaces)) blen = sizeof(spaces)-1;
+        for (size_t k = 0; k < blen; k++) spaces[k] = ' ';
+        spaces[blen] = '\0';
+        out_push_prefix(o, bullet, spaces);
+        break;
+    }
+    case CMARK_NODE_BLOCK_QUOTE:
+        o->quote_depth++;
+        out_push_prefix(o, "> ", "> ");
+        style_push(o, &f->saved, MDVIC_EL_QUOTE);
+        break;
+    case CMARK_NODE_LINK: {
+        const char *url = cmark_node_get_url(node);
+        if (o->color_enabled && o->osc8_enabled && url) osc8_begin(o, url);
+        style_push(o, &f->saved, MDVIC_EL_LINK);
+        break;
+    }
+    case CMARK_NODE_IMAGE:
+        out_text(o, "[image: ");
+        break;
+    default:
+        /* Fallback: render children */
+        break;
+    }
+    return 0;
+}
+
+static void render_exit(struct Out *o, cmark_node *node, const struct Frame *f) {
+    switch (cmark_node_get_type(node)) {
+    case CMARK_NODE_PARAGRAPH:
+        if (o->list_depth > 0) {
+            if (o->list_tight) {
+                out_newline(o);
+            } else {
+                out_newline(o);
+                out_newline(o);
             }
-            out_clear_prefix(o);
+        } else {
+            out_newline(o);
+            out_newline(o);
         }
-        if (tight) {
+        break;
+    case CMARK_NODE_HEADING:
+        style_pop(o, &f->saved);
+        out_newline(o);
+        out_newline(o);
+        break;
+    case CMARK_NODE_STRONG:
+    case CMARK_NODE_EMPH:
+        style_pop(o, &f->saved);
+        break;
+    case CMARK_NODE_LIST:
+        if (o->list_tight) {
             /* Respect a blank line after the last item for tight lists */
             out_newline(o);
         }
-        o->list_tight = prev_tight;
+        o->list_tight = f->prev_tight;
         o->list_depth--;
         break;
-    }
-    case CMARK_NODE_BLOCK_QUOTE: {
-        o->quote_depth++;
-        char qpref1[32]; char qpref2[32];
-        int n = 0; for (int i = 0; i < o->quote_depth; i++) { if (n + 2 < (int)sizeof(qpref1)) { qpref1[n++] = '>'; qpref1[n++] = ' '; } }
-        qpref1[n] = '\0';
-        /* next lines align with 2 spaces after the '>'s */
-        for (int i = 0; i < n; i++) qpref2[i] = (qpref1[i] == '>') ? '>' : ' ';
-        qpref2[n] = '\0';
-        out_set_prefix(o, qpref1, qpref2);
-        for (cmark_node *n = cmark_node_first_child(node); n; n = cmark_node_next(n)) {
-            render_node(o, n, opt);
-        }
-        out_clear_prefix(o);
-        o->quote_depth--;
+    case CMARK_NODE_ITEM:
+        out_pop_prefix(o);
         break;
-    }
-    case CMARK_NODE_THEMATIC_BREAK: {
-        out_puts(o, "-----");
-        out_newline(o);
+    case CMARK_NODE_BLOCK_QUOTE:
+        style_pop(o, &f->saved);
+        out_pop_prefix(o);
+        o->quote_depth--;
         break;
-    }
     case CMARK_NODE_LINK: {
         const char *url = cmark_node_get_url(node);
         int have_osc8 = o->color_enabled && o->osc8_enabled;
-        if (have_osc8 && url) osc8_begin(o, url);
-        render_inlines(o, node, opt);
+        style_pop(o, &f->saved);
         if (have_osc8 && url) osc8_end(o);
         if (!have_osc8 && url && url[0] != '\0') {
             out_text(o, " (" ); out_text(o, url); out_text(o, ")");
@@ -707,60 +1420,320 @@ static void render_node(struct Out *o, cmark_node *node, const struct MdvicOptio
     }
     case CMARK_NODE_IMAGE: {
         const char *url = cmark_node_get_url(node);
-        out_text(o, "[image: ");
-        render_inlines(o, node, opt);
         out_text(o, "]");
         if (url) { out_text(o, " (" ); out_text(o, url); out_text(o, ")"); }
         break;
     }
-    default: {
-        /* Fallback: render children */
-        for (cmark_node *n = cmark_node_first_child(node); n; n = cmark_node_next(n)) {
-            render_node(o, n, opt);
-        }
+    default:
         break;
     }
+}
+
+/* Render root (or only its descendants, without with_root). The walk is
+ * iterative: each open container keeps its saved state in a heap frame, so
+ * nesting depth costs memory, not C stack. */
+static void render_tree(struct Out *o, cmark_node *root, int with_root, const struct MdvicOptions *opt) {
+    cmark_iter *it = cmark_iter_new(root);
+    if (!it) return;
+    struct FrameStack fs = { NULL, 0, 0 };
+    cmark_node *skip = NULL; /* container whose children are already rendered */
+    cmark_event_type ev;
+    while ((ev = cmark_iter_next(it)) != CMARK_EVENT_DONE) {
+        cmark_node *node = cmark_iter_get_node(it);
+        if (node == root && !with_root) continue;
+        if (skip) { if (node == skip && ev == CMARK_EVENT_EXIT) skip = NULL; continue; }
+        if (ev == CMARK_EVENT_ENTER) {
+            if (node_is_leaf(node)) { render_leaf(o, node, opt); continue; }
+            struct Frame *f = frame_push(&fs);
+            if (!f) break;
+            if (render_enter(o, node, f, fs.n > 1 ? &fs.f[fs.n - 2] : NULL, opt)) { fs.n--; skip = node; }
+        } else if (ev == CMARK_EVENT_EXIT && fs.n > 0) {
+            render_exit(o, node, &fs.f[fs.n - 1]);
+            fs.n--;
+        }
     }
+    free(fs.f);
+    cmark_iter_free(it);
 }
 #endif /* HAVE_LIBCMARK */
 
-int mdvic_render_stream(FILE *in, FILE *out, const struct MdvicOptions *opt, const char *filename) {
-    (void)filename;
-    int width = opt ? opt->width : 0;
+struct MdvicDoc {
+    struct Out o;
+    const struct MdvicOptions *opt;
+    FILE *out;
+#ifdef HAVE_LIBCMARK
+    char *data;
+    struct LintJob lint;
+    struct MdvicMathSpans spans;
+    cmark_node *root;
+    cmark_node *next; /* next top-level block to render */
+#else
+    FILE *in;
+#endif
+    unsigned long long opened; /* for the --trace document event */
+    size_t len;
+};
+
+/* --trace event for a phase that covers the whole input. */
+static void trace_whole(struct MdvicTrace *t, const char *name, const char *filename, unsigned long long t0, size_t len) {
+    struct MdvicTraceSpan sp;
+    memset(&sp, 0, sizeof(sp));
+    sp.name = name; sp.file = filename; sp.tid = MDVIC_TRACE_TID_MAIN;
+    sp.start_ns = t0; sp.end_ns = mdvic_stats_now();
+    sp.has_range = len > 0; sp.len = len;
+    mdvic_trace_span(t, &sp);
+}
+
+/* Open for writing to out, or for recording into ir when it is set. */
+static struct MdvicDoc *doc_open(FILE *in, FILE *out, struct MdvicIr *ir, const struct MdvicOptions *opt, const char *filename) {
+    int width = (opt && opt->enable_wrap) ? opt->width : 0;
+    struct MdvicDoc *d = (struct MdvicDoc *)calloc(1, sizeof(*d));
+    if (!d) return NULL;
+    d->opt = opt; d->out = out;
+    struct MdvicStats *stats = opt ? opt->stats : NULL;
+    struct MdvicTrace *trace = opt ? opt->trace : NULL;
+    unsigned long long t0 = (stats || trace) ? mdvic_stats_now() : 0;
+    d->opened = t0;
+    if (stats) stats->files++;
 
 #ifdef HAVE_LIBCMARK
-    /* Slurp input */
-    size_t cap = 8192, len = 0; char *data = (char *)malloc(cap);
-    if (!data) return -1;
-    for (;;) {
-        if (cap - len < 4096) { size_t ncap = cap * 2; char *nd = (char *)realloc(data, ncap); if (!nd) { free(data); return -1; } data = nd; cap = ncap; }
-        size_t n = fread(data + len, 1, 4096, in); len += n; if (n < 4096) { if (feof(in)) break; if (ferror(in)) { free(data); return -1; } }
-    }
-    /* Lint before parsing */
-    if (!opt || opt->enable_lint) {
-        (void)mdvic_lint_buffer(data, len, stderr, filename);
-    }
-    cmark_node *doc = cmark_parse_document(data, len, CMARK_OPT_DEFAULT);
-    if (!doc) return -1;
-    struct Out o; out_init(&o, out, width, opt); o.filename = filename; o.source = data; o.source_len = len;
-    render_node(&o, doc, opt);
-    cmark_node_free(doc);
-    free(data);
-    out_reset(&o);
-    if (o.col != 0) fputc('\n', out);
-    return 0;
+    /* Slurp input as UTF-8; lint, cmark and the renderer all see valid
+     * UTF-8 with LF line ends */
+    char *data = NULL; size_t len = 0, raw_len = 0;
+    if (mdvic_read_input(in, opt ? opt->input_encoding : MDVIC_INPUT_AUTO, &data, &len, &raw_len) != 0) { free(d); return NULL; }
+    if (stats) { stats->input_bytes += raw_len; stats->phase_ns[MDVIC_PHASE_READ] += mdvic_stats_now() - t0; }
+    if (trace) trace_whole(trace, "read", filename, t0, raw_len);
+    d->len = len;
+    /* Lint alongside parsing; it only reads data */
+    if (!opt || opt->enable_lint) lint_job_start(&d->lint, data, len, filename, opt);
+    /* Lift math spans out of the source so inline parsing cannot split them */
+    t0 = (stats || trace) ? mdvic_stats_now() : 0;
+    int have_spans = (mdvic_math_extract(data, len, &d->spans) == 0 && d->spans.count > 0);
+    const char *src = have_spans ? d->spans.masked : data;
+    size_t src_len = have_spans ? d->spans.masked_len : len;
+    d->root = cmark_parse_document(src, src_len, CMARK_OPT_DEFAULT);
+    if (stats) stats->phase_ns[MDVIC_PHASE_PARSE] += mdvic_stats_now() - t0;
+    if (trace) trace_whole(trace, "parse", filename, t0, len);
+    if (!d->root) { lint_job_finish(&d->lint); mdvic_math_spans_free(&d->spans); free(data); free(d); return NULL; }
+    d->data = data;
+    d->next = cmark_node_first_child(d->root);
+    out_init(&d->o, out, width, opt); d->o.filename = filename; d->o.source = src; d->o.source_len = src_len;
+    d->o.math = have_spans ? &d->spans : NULL;
+    d->o.input = data; d->o.input_len = len;
+    d->o.lint = &d->lint;
+    d->o.math_cache = mdvic_math_cache_new(MATH_CACHE_SLOTS, MATH_CACHE_BYTES);
+#else
+    /* Passthrough: one line per block */
+    (void)t0;
+    d->in = in;
+    out_init(&d->o, out, width, opt); d->o.filename = filename;
+#endif
+    if (ir) { d->o.ir = ir; d->o.width = -1; d->o.write = out_write_record; }
+    return d;
+}
+
+struct MdvicDoc *mdvic_doc_open(FILE *in, FILE *out, const struct MdvicOptions *opt, const char *filename) {
+    return doc_open(in, out, NULL, opt, filename);
+}
+
+struct MdvicDoc *mdvic_doc_open_ir(FILE *in, struct MdvicIr *ir, const char *filename) {
+    return doc_open(in, NULL, ir, &ir->opt, filename);
+}
+
+/* Render time excludes what out_bytes spent writing meanwhile. */
+static void stats_render_since(struct MdvicStats *stats, unsigned long long t0, unsigned long long w0) {
+    unsigned long long wrote = stats->phase_ns[MDVIC_PHASE_WRITE] - w0, dt = mdvic_stats_now() - t0;
+    stats->phase_ns[MDVIC_PHASE_RENDER] += dt > wrote ? dt - wrote : 0;
+}
+
+int mdvic_doc_render_next(struct MdvicDoc *d) {
+#ifdef HAVE_LIBCMARK
+    if (!d->next) return 0;
+    struct MdvicStats *stats = d->o.stats;
+    unsigned long long t0 = stats ? mdvic_stats_now() : 0, w0 = stats ? stats->phase_ns[MDVIC_PHASE_WRITE] : 0;
+    unsigned long long b0 = d->o.trace ? mdvic_stats_now() : 0;
+    render_tree(&d->o, d->next, 1, d->opt);
+    if (stats) stats_render_since(stats, t0, w0);
+    if (d->o.trace) trace_node(&d->o, cmark_node_get_type_string(d->next), d->next, b0);
+    d->next = cmark_node_next(d->next);
+    return 1;
 #else
-    /* Passthrough */
-    struct Out o; out_init(&o, out, width, opt); o.filename = filename;
     char buf[4096];
-    while (fgets(buf, (int)sizeof(buf), in) != NULL) {
-        size_t n = strlen(buf);
-        out_write(&o, buf, n);
-    }
-    out_reset(&o);
-    if (o.col != 0) fputc('\n', out);
+    if (fgets(buf, (int)sizeof(buf), d->in) == NULL) return 0;
+    if (d->o.stats) d->o.stats->input_bytes += strlen(buf);
+    d->len += strlen(buf);
+    out_write(&d->o, buf, strlen(buf));
+    return 1;
+#endif
+}
+
+void mdvic_doc_close(struct MdvicDoc *d) {
+    if (!d) return;
+    out_reset(&d->o);
+    out_free(&d->o);
+    if (d->o.col != 0 && !d->o.ir) out_bytes(&d->o, "\n", 1);
+#ifdef HAVE_LIBCMARK
+    lint_job_finish(&d->lint);
+    mdvic_math_cache_free(d->o.math_cache);
+    cmark_node_free(d->root);
+    mdvic_math_spans_free(&d->spans);
+    free(d->data);
+#endif
+    if (d->o.trace) trace_whole(d->o.trace, "document", d->o.filename, d->opened, d->len);
+    free(d);
+}
+
+int mdvic_render_stream(FILE *in, FILE *out, const struct MdvicOptions *opt, const char *filename) {
+    struct MdvicDoc *d = mdvic_doc_open(in, out, opt, filename);
+    if (!d) return -1;
+    while (mdvic_doc_render_next(d) > 0) {}
+    mdvic_doc_close(d);
     return 0;
+}
+
+int mdvic_lint_document(const char *data, size_t len, const char *filename, mdvic_diag_fn fn, void *ctx) {
+    int issues = mdvic_lint_scan(data, len, filename, fn, ctx);
+    struct MdvicMathSpans spans;
+    memset(&spans, 0, sizeof(spans));
+    int have_spans = (mdvic_math_extract(data, len, &spans) == 0 && spans.count > 0);
+    issues += mdvic_lint_math(data, len, have_spans ? &spans : NULL, filename, fn, ctx);
+#ifdef HAVE_LIBCMARK
+    /* Tables and links are recognised on the parse, as when rendering */
+    const char *src = have_spans ? spans.masked : data;
+    size_t src_len = have_spans ? spans.masked_len : len;
+    cmark_node *root = cmark_parse_document(src, src_len, CMARK_OPT_DEFAULT);
+    if (root) {
+        /* only the checks run: no theme, width or output */
+        struct Out o;
+        memset(&o, 0, sizeof(o));
+        o.filename = filename; o.source = src; o.source_len = src_len;
+        o.math = have_spans ? &spans : NULL;
+        o.diag = fn; o.diag_ctx = ctx; o.lint_only = 1;
+        cmark_iter *it = cmark_iter_new(root);
+        cmark_event_type ev;
+        while (it && (ev = cmark_iter_next(it)) != CMARK_EVENT_DONE) {
+            if (ev != CMARK_EVENT_ENTER) continue;
+            cmark_node *n = cmark_iter_get_node(it);
+            cmark_node_type t = cmark_node_get_type(n);
+            if (t == CMARK_NODE_PARAGRAPH) {
+                (void)mdvic_render_gfm_table_if_any(&o, n, NULL);
+            } else if (t == CMARK_NODE_LINK || t == CMARK_NODE_IMAGE) {
+                /* the target as written, not as masked */
+                const char *url = cmark_node_get_url(n);
+                struct Buf u; buf_init(&u);
+                if (url && o.math && buf_puts(&u, "") == 0) { buf_put_literal(&o, &u, url, 1, NULL); url = u.p; }
+                if (mdvic_link_target_missing(url, filename)) {
+                    char msg[512];
+                    snprintf(msg, sizeof(msg), "%s target '%.400s' does not exist", t == CMARK_NODE_IMAGE ? "image" : "link", url);
+                    out_diag(&o, cmark_node_get_start_line(n), cmark_node_get_start_column(n), "missing-link-target", msg);
+                }
+                buf_free(&u);
+            }
+        }
+        cmark_iter_free(it);
+        cmark_node_free(root);
+        issues += o.diag_count;
+    }
 #endif
+    mdvic_math_spans_free(&spans);
+    return issues;
+}
+
+/* ---------------- Layout of recorded documents ---------------- */
+
+struct MdvicIr *mdvic_ir_new(const struct MdvicOptions *opt) {
+    struct MdvicIr *ir = (struct MdvicIr *)calloc(1, sizeof(*ir));
+    if (!ir) return NULL;
+    ir->opt = *opt;
+    return ir;
+}
+
+void mdvic_ir_free(struct MdvicIr *ir) {
+    if (!ir) return;
+    free(ir->op); free(ir->text); free(ir);
+}
+
+struct MdvicLayout {
+    struct Out o;
+    const struct MdvicIr *ir;
+    size_t next; /* first operation not laid out yet */
+    int width;
+};
+
+struct MdvicLayout *mdvic_layout_new(const struct MdvicIr *ir, int width, FILE *out) {
+    struct MdvicLayout *l = (struct MdvicLayout *)calloc(1, sizeof(*l));
+    if (!l) return NULL;
+    l->ir = ir; l->width = width > 0 ? width : 0;
+    out_init(&l->o, out, l->width, &ir->opt);
+    return l;
+}
+
+/* One linear pass over the operations recorded since the last call. A text
+ * run that ends before the right margin is copied without measuring. */
+void mdvic_layout_run(struct MdvicLayout *l) {
+    struct Out *o = &l->o;
+    const struct MdvicIr *ir = l->ir;
+    for (; l->next < ir->n; l->next++) {
+        const struct IrOp *op = &ir->op[l->next];
+        const char *t = ir->text + op->off;
+        switch (op->kind) {
+        case IR_TEXT:
+            o->style = op->style;
+            o->width = op->nowrap ? 0 : l->width;
+            if (op->width >= 0 && o->width > 0 && o->col > 0 && o->col + op->width < o->width) {
+                if (op->len) out_sync_style(o);
+                out_bytes(o, t, op->len);
+                o->col += op->width;
+            } else {
+                out_write(o, t, op->len);
+            }
+            break;
+        case IR_RAW:
+            o->style = op->style;
+            out_sync_style(o);
+            out_bytes(o, t, op->len);
+            break;
+        case IR_LF: out_bytes(o, "\n", 1); break;
+        case IR_NEWLINE: out_newline(o); break;
+        case IR_CODE:
+            o->style = op->style;
+            out_code_begin(o, "", 0);
+            break;
+        case IR_PREFIX_PUSH: out_push_prefix(o, t, t + strlen(t) + 1); break;
+        case IR_PREFIX_POP: out_pop_prefix(o); break;
+        case IR_LINK_BEGIN: osc8_begin(o, t); break;
+        case IR_LINK_END: osc8_end(o); break;
+        default: break;
+        }
+    }
+}
+
+void mdvic_layout_free(struct MdvicLayout *l) {
+    if (!l) return;
+    out_reset(&l->o);
+    out_free(&l->o);
+    if (l->o.col != 0) out_bytes(&l->o, "\n", 1);
+    free(l);
+}
+
+int mdvic_layout(const struct MdvicIr *ir, int width, FILE *out) {
+    struct MdvicLayout *l = mdvic_layout_new(ir, width, out);
+    if (!l) return -1;
+    mdvic_layout_run(l);
+    mdvic_layout_free(l);
+    return 0;
+}
+
+struct MdvicGrid *mdvic_layout_grid(const struct MdvicIr *ir, int width) {
+    struct MdvicGrid *g = mdvic_grid_new(width);
+    if (!g) return NULL;
+    struct MdvicLayout *l = mdvic_layout_new(ir, g->width, NULL);
+    if (!l) { mdvic_grid_free(g); return NULL; }
+    l->o.grid = g;
+    mdvic_layout_run(l);
+    mdvic_layout_free(l);
+    mdvic_grid_finish(g);
+    return g;
 }
 
 void mdvic_apply_env_overrides(struct MdvicOptions *opt) {
@@ -784,6 +1757,10 @@ void mdvic_apply_env_overrides(struct MdvicOptions *opt) {
     if (no_osc8 && no_osc8[0] != '\0') {
         opt->enable_osc8 = false;
     }
+    const char *no_hl = getenv("MDVIC_NO_HIGHLIGHT");
+    if (no_hl && no_hl[0] != '\0') {
+        opt->enable_highlight = false;
+    }
     const char *width = getenv("MDVIC_WIDTH");
     if (width && width[0] != '\0') {
         char *end = NULL;
@@ -802,6 +1779,36 @@ void mdvic_apply_env_overrides(struct MdvicOptions *opt) {
         if (strcmp(accent, "group") == 0) opt->accent_group = true;
         else if (strcmp(accent, "last") == 0) opt->accent_group = false;
     }
+    const char *input_enc = getenv("MDVIC_INPUT_ENCODING");
+    if (input_enc && input_enc[0] != '\0') {
+        enum mdvic_input_encoding enc;
+        if (mdvic_parse_input_encoding(input_enc, &enc) == 0) opt->input_encoding = enc;
+    }
+    const char *math_limit = getenv("MDVIC_MATH_LIMIT");
+    if (math_limit && math_limit[0] != '\0') {
+        struct MdvicMathLimits lim = opt->math_limits;
+        if (mdvic_parse_math_limit(math_limit, &lim) == 0) opt->math_limits = lim;
+    }
+}
+
+int mdvic_parse_math_limit(const char *spec, struct MdvicMathLimits *lim) {
+    if (!spec || !lim) return -1;
+    if (strcmp(spec, "none") == 0) { memset(lim, 0, sizeof(*lim)); return 0; }
+    const char *p = spec;
+    while (*p) {
+        const char *eq = strchr(p, '=');
+        if (!eq) return -1;
+        size_t klen = (size_t)(eq - p);
+        char *end = NULL;
+        unsigned long long v = strtoull(eq + 1, &end, 10);
+        if (end == eq + 1 || (*end != ',' && *end != '\0')) return -1;
+        if (klen == 5 && strncmp(p, "depth", 5) == 0) { if (v > 100000) return -1; lim->max_depth = (int)v; }
+        else if (klen == 6 && strncmp(p, "tokens", 6) == 0) lim->max_tokens = (size_t)v;
+        else if (klen == 5 && strncmp(p, "bytes", 5) == 0) lim->max_bytes = (size_t)v;
+        else return -1;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return 0;
 }
 
 int mdvic_detect_width(void) {
@@ -0,0 +1,32 @@
+/* --stats: clock and report; the counters are kept by the renderer. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <time.h>
+
+#include "mdvic/stats.h"
+
+unsigned long long mdvic_stats_now(void) {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) return 0;
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+static double ms(unsigned long long ns) { return (double)ns / 1e6; }
+
+static double mib(unsigned long long bytes) { return (double)bytes / (1024.0 * 1024.0); }
+
+void mdvic_stats_print(FILE *err, const struct MdvicStats *s) {
+    static const char *const names[MDVIC_PHASE_COUNT] = { "read", "lint", "parse", "render", "write" };
+    fprintf(err, "mdvic stats: %lu file%s, %llu bytes in\n", s->files, s->files == 1 ? "" : "s", s->input_bytes);
+    for (int p = 0; p < MDVIC_PHASE_COUNT; p++)
+        fprintf(err, "  %-12s %10.3f ms\n", names[p], ms(s->phase_ns[p]));
+    fprintf(err, "  %-12s %10.3f ms\n", "total", ms(s->wall_ns));
+    fprintf(err, "  %-12s %10lu\n", "math spans", s->math_spans);
+    fprintf(err, "  %-12s %10lu\n", "table cells", s->table_cells);
+    fprintf(err, "  %-12s %10llu (escapes %llu)\n", "output bytes", s->output_bytes, s->escape_bytes);
+    if (s->have_allocs) fprintf(err, "  %-12s %10llu (%.1f MiB)\n", "allocations", s->allocs, mib(s->alloc_bytes));
+    else fprintf(err, "  %-12s %10s\n", "allocations", "n/a");
+    if (s->peak_rss_kib >= 0) fprintf(err, "  %-12s %10.1f MiB\n", "peak RSS", (double)s->peak_rss_kib / 1024.0);
+    else fprintf(err, "  %-12s %10s\n", "peak RSS", "n/a");
+}
@@ -0,0 +1,256 @@
+/* Theme files and their compilation to SGR parameter strings. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mdvic/theme.h"
+
+static const char *const el_names[MDVIC_EL_COUNT] = {
+    "h1", "h2", "h3", "h4", "h5", "h6",
+    "strong", "emph", "code", "code-block",
+    "link", "quote", "table-border", "table-header",
+    "math",
+    "code-keyword", "code-type", "code-literal", "code-string",
+    "code-number", "code-comment", "code-preproc"
+};
+
+static const char *const color_names[8] = {
+    "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white"
+};
+
+/* xterm's default RGB for the 16 basic colours, used when downgrading. */
+static const unsigned char basic_rgb[16][3] = {
+    {0, 0, 0}, {205, 0, 0}, {0, 205, 0}, {205, 205, 0}, {0, 0, 238}, {205, 0, 205}, {0, 205, 205}, {229, 229, 229},
+    {127, 127, 127}, {255, 0, 0}, {0, 255, 0}, {255, 255, 0}, {92, 92, 255}, {255, 0, 255}, {0, 255, 255}, {255, 255, 255}
+};
+
+static const unsigned char cube_level[6] = {0, 95, 135, 175, 215, 255};
+
+static struct MdvicColor color16(int idx) {
+    struct MdvicColor c; c.kind = MDVIC_COLOR_16; c.r = (unsigned char)idx; c.g = 0; c.b = 0; return c;
+}
+
+void mdvic_theme_default(struct MdvicTheme *t) {
+    static const int heading_colors[6] = {1, 3, 2, 6, 4, 5}; /* red yellow green cyan blue magenta */
+    memset(t, 0, sizeof(*t));
+    for (int i = 0; i < 6; i++) {
+        t->el[MDVIC_EL_H1 + i].attrs = MDVIC_ATTR_BOLD;
+        t->el[MDVIC_EL_H1 + i].fg = color16(heading_colors[i]);
+    }
+    t->el[MDVIC_EL_STRONG].attrs = MDVIC_ATTR_BOLD;
+    t->el[MDVIC_EL_EMPH].attrs = MDVIC_ATTR_ITALIC;
+    t->el[MDVIC_EL_CODE].attrs = MDVIC_ATTR_INVERSE;
+    t->el[MDVIC_EL_TABLE_HEADER].attrs = MDVIC_ATTR_BOLD;
+    t->el[MDVIC_EL_CODE_KEYWORD].fg = color16(5);
+    t->el[MDVIC_EL_CODE_TYPE].fg = color16(6);
+    t->el[MDVIC_EL_CODE_LITERAL].fg = color16(3);
+    t->el[MDVIC_EL_CODE_STRING].fg = color16(2);
+    t->el[MDVIC_EL_CODE_NUMBER].fg = color16(3);
+    t->el[MDVIC_EL_CODE_COMMENT].attrs = MDVIC_ATTR_DIM;
+    t->el[MDVIC_EL_CODE_PREPROC].fg = color16(4);
+    mdvic_theme_compile(t, mdvic_detect_color_depth());
+}
+
+int mdvic_detect_color_depth(void) {
+    const char *v = getenv("MDVIC_COLORS");
+    if (v && v[0] != '\0') {
+        if (strcmp(v, "truecolor") == 0 || strcmp(v, "24bit") == 0) return MDVIC_DEPTH_TRUE;
+        if (strcmp(v, "256") == 0) return MDVIC_DEPTH_256;
+        if (strcmp(v, "16") == 0 || strcmp(v, "8") == 0) return MDVIC_DEPTH_16;
+    }
+    v = getenv("COLORTERM");
+    if (v && (strcmp(v, "truecolor") == 0 || strcmp(v, "24bit") == 0)) return MDVIC_DEPTH_TRUE;
+    v = getenv("TERM");
+    if (v && strstr(v, "256")) return MDVIC_DEPTH_256;
+    return MDVIC_DEPTH_16;
+}
+
+/* ---------------- Colour depth conversion ---------------- */
+
+static void rgb_of_256(int idx, int *r, int *g, int *b) {
+    if (idx < 16) { *r = basic_rgb[idx][0]; *g = basic_rgb[idx][1]; *b = basic_rgb[idx][2]; return; }
+    if (idx >= 232) { *r = *g = *b = 8 + 10 * (idx - 232); return; }
+    idx -= 16;
+    *r = cube_level[idx / 36]; *g = cube_level[(idx / 6) % 6]; *b = cube_level[idx % 6];
+}
+
+static int dist2(int r1, int g1, int b1, int r2, int g2, int b2) {
+    return (r1 - r2) * (r1 - r2) + (g1 - g2) * (g1 - g2) + (b1 - b2) * (b1 - b2);
+}
+
+static int nearest_cube(int v) {
+    int best = 0;
+    for (int i = 1; i < 6; i++) if (abs(cube_level[i] - v) < abs(cube_level[best] - v)) best = i;
+    return best;
+}
+
+static int rgb_to_256(int r, int g, int b) {
+    int ci = nearest_cube(r), cj = nearest_cube(g), ck = nearest_cube(b);
+    int cube = 16 + 36 * ci + 6 * cj + ck;
+    int avg = (r + g + b) / 3;
+    int gi = avg < 8 ? 0 : (avg > 238 ? 23 : (avg - 8 + 5) / 10);
+    int gv = 8 + 10 * gi;
+    if (dist2(r, g, b, gv, gv, gv) < dist2(r, g, b, cube_level[ci], cube_level[cj], cube_level[ck])) return 232 + gi;
+    return cube;
+}
+
+static int rgb_to_16(int r, int g, int b) {
+    int best = 0, bestd = -1;
+    for (int i = 0; i < 16; i++) {
+        int d = dist2(r, g, b, basic_rgb[i][0], basic_rgb[i][1], basic_rgb[i][2]);
+        if (bestd < 0 || d < bestd) { best = i; bestd = d; }
+    }
+    return best;
+}
+
+/* Format one colour as SGR parameters for depth; base is 30 (fg) or 40 (bg). */
+static void color_sgr(char *dst, size_t cap, const struct MdvicColor *c, int depth, int base) {
+    int r = c->r, g = c->g, b = c->b, idx = c->r;
+    dst[0] = '\0';
+    switch (c->kind) {
+    case MDVIC_COLOR_NONE: return;
+    case MDVIC_COLOR_RGB:
+        if (depth == MDVIC_DEPTH_TRUE) { snprintf(dst, cap, "%d;2;%d;%d;%d", base + 8, r, g, b); return; }
+        idx = (depth == MDVIC_DEPTH_256) ? rgb_to_256(r, g, b) : rgb_to_16(r, g, b);
+        if (depth == MDVIC_DEPTH_256 && idx >= 16) { snprintf(dst, cap, "%d;5;%d", base + 8, idx); return; }
+        break;
+    case MDVIC_COLOR_256:
+        if (idx >= 16) {
+            if (depth != MDVIC_DEPTH_16) { snprintf(dst, cap, "%d;5;%d", base + 8, idx); return; }
+            rgb_of_256(idx, &r, &g, &b);
+            idx = rgb_to_16(r, g, b);
+        }
+        break;
+    default: break;
+    }
+    if (idx < 8) snprintf(dst, cap, "%d", base + idx);
+    else snprintf(dst, cap, "%d", base + 60 + (idx - 8));
+}
+
+void mdvic_theme_compile(struct MdvicTheme *t, int depth) {
+    t->depth = depth;
+    for (int i = 0; i < MDVIC_EL_COUNT; i++) {
+        color_sgr(t->fg_sgr[i], sizeof(t->fg_sgr[i]), &t->el[i].fg, depth, 30);
+        color_sgr(t->bg_sgr[i], sizeof(t->bg_sgr[i]), &t->el[i].bg, depth, 40);
+    }
+}
+
+/* ---------------- Theme file parsing ---------------- */
+
+static int parse_color(const char *s, size_t n, struct MdvicColor *c) {
+    c->kind = MDVIC_COLOR_NONE; c->r = c->g = c->b = 0;
+    if (n == 7 && s[0] == '#') {
+        unsigned v = 0;
+        for (size_t i = 1; i < 7; i++) {
+            char ch = s[i]; int d;
+            if (ch >= '0' && ch <= '9') d = ch - '0';
+            else if (ch >= 'a' && ch <= 'f') d = ch - 'a' + 10;
+            else if (ch >= 'A' && ch <= 'F') d = ch - 'A' + 10;
+            else return -1;
+            v = v * 16 + (unsigned)d;
+        }
+        c->kind = MDVIC_COLOR_RGB; c->r = (unsigned char)(v >> 16); c->g = (unsigned char)(v >> 8); c->b = (unsigned char)v;
+        return 0;
+    }
+    if (n > 0 && s[0] >= '0' && s[0] <= '9') {
+        unsigned v = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (s[i] < '0' || s[i] > '9' || v > 255) return -1;
+            v = v * 10 + (unsigned)(s[i] - '0');
+        }
+        if (v > 255) return -1;
+        c->kind = MDVIC_COLOR_256; c->r = (unsigned char)v;
+        return 0;
+    }
+    if (n == 7 && strncmp(s, "default", 7) == 0) return 0;
+    int bright = 0;
+    if (n > 7 && strncmp(s, "bright-", 7) == 0) { bright = 8; s += 7; n -= 7; }
+    for (int i = 0; i < 8; i++) {
+        if (strlen(color_names[i]) == n && strncmp(s, color_names[i], n) == 0) { *c = color16(i + bright); return 0; }
+    }
+    return -1;
+}
+
+static int parse_attrs(const char *p, const char *end, struct MdvicThemeStyle *st, const char **bad, size_t *bad_len) {
+    memset(st, 0, sizeof(*st));
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        const char *w = p;
+        while (p < end && *p != ' ' && *p != '\t') p++;
+        size_t n = (size_t)(p - w);
+        if (n == 0) break;
+        *bad = w; *bad_len = n;
+        if (n == 4 && strncmp(w, "bold", 4) == 0) st->attrs |= MDVIC_ATTR_BOLD;
+        else if (n == 3 && strncmp(w, "dim", 3) == 0) st->attrs |= MDVIC_ATTR_DIM;
+        else if (n == 6 && strncmp(w, "italic", 6) == 0) st->attrs |= MDVIC_ATTR_ITALIC;
+        else if (n == 9 && strncmp(w, "underline", 9) == 0) st->attrs |= MDVIC_ATTR_UNDERLINE;
+        else if (n == 7 && strncmp(w, "inverse", 7) == 0) st->attrs |= MDVIC_ATTR_INVERSE;
+        else if (n == 5 && strncmp(w, "plain", 5) == 0) memset(st, 0, sizeof(*st));
+        else if (n > 3 && strncmp(w, "fg=", 3) == 0) { if (parse_color(w + 3, n - 3, &st->fg) != 0) return -1; }
+        else if (n > 3 && strncmp(w, "bg=", 3) == 0) { if (parse_color(w + 3, n - 3, &st->bg) != 0) return -1; }
+        else return -1;
+    }
+    return 0;
+}
+
+int mdvic_theme_parse(struct MdvicTheme *t, const char *text, size_t len, const char *name, FILE *err) {
+    const char *p = text, *end = text + len;
+    int line = 0, rc = 0;
+    if (!name) name = "-";
+    while (p < end) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        const char *le = nl ? nl : end;
+        line++;
+        const char *hash = (const char *)memchr(p, '#', (size_t)(le - p));
+        /* '#' starts a comment unless it opens an #rrggbb colour */
+        while (hash && hash > p && hash[-1] == '=') hash = (const char *)memchr(hash + 1, '#', (size_t)(le - hash - 1));
+        const char *ce = hash ? hash : le;
+        const char *k = p;
+        while (k < ce && (*k == ' ' || *k == '\t')) k++;
+        while (ce > k && (ce[-1] == ' ' || ce[-1] == '\t' || ce[-1] == '\r')) ce--;
+        if (k < ce) {
+            const char *eq = (const char *)memchr(k, '=', (size_t)(ce - k));
+            const char *ke = eq ? eq : ce;
+            while (ke > k && (ke[-1] == ' ' || ke[-1] == '\t')) ke--;
+            size_t kn = (size_t)(ke - k);
+            int first = -1, last = -1;
+            if (kn == 7 && strncmp(k, "heading", 7) == 0) { first = MDVIC_EL_H1; last = MDVIC_EL_H6; }
+            for (int i = 0; first < 0 && i < MDVIC_EL_COUNT; i++) {
+                if (strlen(el_names[i]) == kn && strncmp(k, el_names[i], kn) == 0) first = last = i;
+            }
+            struct MdvicThemeStyle st; const char *bad = k; size_t bad_len = kn;
+            if (!eq) {
+                if (err) fprintf(err, "%s:%d: expected 'element = attributes'\n", name, line);
+                rc = -1;
+            } else if (first < 0) {
+                if (err) fprintf(err, "%s:%d: unknown element '%.*s'\n", name, line, (int)kn, k);
+                rc = -1;
+            } else if (parse_attrs(eq + 1, ce, &st, &bad, &bad_len) != 0) {
+                if (err) fprintf(err, "%s:%d: invalid attribute '%.*s'\n", name, line, (int)bad_len, bad);
+                rc = -1;
+            } else {
+                for (int i = first; i <= last; i++) t->el[i] = st;
+            }
+        }
+        p = nl ? nl + 1 : end;
+    }
+    mdvic_theme_compile(t, t->depth ? t->depth : mdvic_detect_color_depth());
+    return rc;
+}
+
+int mdvic_theme_load(struct MdvicTheme *t, const char *path, FILE *err) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) { if (err) fprintf(err, "mdvic: cannot open theme '%s'\n", path); return -1; }
+    size_t cap = 4096, len = 0; char *data = (char *)malloc(cap);
+    if (!data) { fclose(fp); return -1; }
+    for (;;) {
+        if (cap - len < 1024) { char *nd = (char *)realloc(data, cap * 2); if (!nd) { free(data); fclose(fp); return -1; } data = nd; cap *= 2; }
+        size_t n = fread(data + len, 1, cap - len, fp); len += n;
+        if (n == 0) break;
+    }
+    fclose(fp);
+    int rc = mdvic_theme_parse(t, data, len, path, err);
+    free(data);
+    return rc;
+}
@@ -0,0 +1,57 @@
+/* --trace: Chrome trace-event JSON writer. */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mdvic/trace.h"
+#include "mdvic/stats.h"
+#include "mdvic/utf8.h"
+
+struct MdvicTrace {
+    FILE *f;
+    unsigned long long t0;
+};
+
+static void thread_name(FILE *f, int tid, const char *name) {
+    fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", tid);
+    mdvic_json_string(f, name);
+    fputs("}}", f);
+}
+
+struct MdvicTrace *mdvic_trace_new(FILE *f) {
+    struct MdvicTrace *t = (struct MdvicTrace *)calloc(1, sizeof(*t));
+    if (!t) return NULL;
+    t->f = f;
+    t->t0 = mdvic_stats_now();
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"mdvic\"}}", f);
+    thread_name(f, MDVIC_TRACE_TID_MAIN, "render");
+    thread_name(f, MDVIC_TRACE_TID_LINT, "lint");
+    return t;
+}
+
+/* Microseconds since the trace started, which is the unit the format wants. */
+static double trace_us(const struct MdvicTrace *t, unsigned long long ns) {
+    return ns > t->t0 ? (double)(ns - t->t0) / 1e3 : 0.0;
+}
+
+void mdvic_trace_span(struct MdvicTrace *t, const struct MdvicTraceSpan *sp) {
+    if (!t) return;
+    FILE *f = t->f;
+    unsigned long long end = sp->end_ns > sp->start_ns ? sp->end_ns : sp->start_ns;
+    fputs(",\n{\"name\":", f); mdvic_json_string(f, sp->name);
+    fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{",
+            sp->tid, trace_us(t, sp->start_ns), (double)(end - sp->start_ns) / 1e3);
+    const char *sep = "";
+    if (sp->file) { fputs("\"file\":", f); mdvic_json_string(f, sp->file); sep = ","; }
+    if (sp->line > 0) { fprintf(f, "%s\"line\":%d,\"end_line\":%d", sep, sp->line, sp->end_line > sp->line ? sp->end_line : sp->line); sep = ","; }
+    if (sp->has_range) fprintf(f, "%s\"offset\":%zu,\"length\":%zu", sep, sp->off, sp->len);
+    fputs("}}", f);
+}
+
+int mdvic_trace_finish(struct MdvicTrace *t) {
+    if (!t) return 0;
+    fputs("\n]}\n", t->f);
+    int rc = (fflush(t->f) != 0 || ferror(t->f)) ? -1 : 0;
+    free(t);
+    return rc;
+}
@@ -0,0 +1,328 @@
+/* Input reading: transcoding to UTF-8, then one pass that leaves valid
+ * UTF-8 with LF line ends. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "mdvic/utf8.h"
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define UTF8_SSE2 1
+#endif
+
+#define REPLACEMENT "\xEF\xBF\xBD" /* U+FFFD */
+
+/* Raw bytes transcoded per step when the input is not UTF-8. */
+#define INPUT_CHUNK (64u * 1024u)
+
+static int has_bom(const unsigned char *s, size_t len) {
+    return len >= 3 && s[0] == 0xEF && s[1] == 0xBB && s[2] == 0xBF;
+}
+
+/* Length of the valid sequence at s (n > 0 bytes available), or 0 with
+ * *bad set to the length of its maximal invalid subpart: the lead byte and
+ * whatever continuation bytes were still acceptable after it. */
+static int seq_len(const unsigned char *s, size_t n, int *bad) {
+    unsigned c = s[0], lo = 0x80, hi = 0xBF;
+    int need;
+    if (c < 0x80) return 1;
+    /* the common three-byte case, with no range exceptions */
+    if (c >= 0xE1 && c <= 0xEF && c != 0xED && n >= 3 && (s[1] & 0xC0) == 0x80 && (s[2] & 0xC0) == 0x80) return 3;
+    if (c >= 0xC2 && c <= 0xDF) need = 1;
+    else if (c >= 0xE0 && c <= 0xEF) { need = 2; if (c == 0xE0) lo = 0xA0; else if (c == 0xED) hi = 0x9F; }
+    else if (c >= 0xF0 && c <= 0xF4) { need = 3; if (c == 0xF0) lo = 0x90; else if (c == 0xF4) hi = 0x8F; }
+    else { *bad = 1; return 0; }
+    for (int i = 1; i <= need; i++) {
+        if ((size_t)i >= n || s[i] < lo || s[i] > hi) { *bad = i; return 0; }
+        lo = 0x80; hi = 0xBF;
+    }
+    return need + 1;
+}
+
+/* First byte at or after i that normalisation changes (CR, NUL or the
+ * start of an invalid sequence), or len. ASCII blocks are passed over 16
+ * bytes at a time with SSE2; multibyte sequences are checked one by one. */
+static size_t skip_clean(const unsigned char *s, size_t i, size_t len) {
+    int bad;
+#ifdef UTF8_SSE2
+    const __m128i cr = _mm_set1_epi8('\r'), zero = _mm_setzero_si128();
+#endif
+    while (i < len) {
+#ifdef UTF8_SSE2
+        /* the high bit of each lane is set by non-ASCII, CR or NUL */
+        for (; len - i >= 16; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(s + i));
+            unsigned m = (unsigned)_mm_movemask_epi8(_mm_or_si128(v, _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, zero))));
+            if (m) { i += (unsigned)__builtin_ctz(m); break; }
+        }
+        if (i >= len) break;
+#endif
+        unsigned char c = s[i];
+        if (c >= 0x80) {
+            /* stay scalar through a run of non-ASCII, as in CJK text */
+            do {
+                int n = seq_len(s + i, len - i, &bad);
+                if (n == 0) return i;
+                i += (size_t)n;
+            } while (i < len && s[i] >= 0x80);
+        } else if (c == '\r' || c == 0) {
+            return i;
+        } else {
+            i++;
+        }
+    }
+    return len;
+}
+
+/* Bytes consumed by the change at s[i] (which skip_clean stopped at), and
+ * the bytes it becomes in *out_n. */
+static size_t change_at(const unsigned char *s, size_t i, size_t len, size_t *out_n) {
+    int bad = 1;
+    if (s[i] == '\r') { *out_n = 1; return (i + 1 < len && s[i + 1] == '\n') ? 2 : 1; }
+    if (s[i] != 0) (void)seq_len(s + i, len - i, &bad);
+    *out_n = 3;
+    return (size_t)bad;
+}
+
+int mdvic_utf8_normalize(char **buf, size_t *len, size_t *cap) {
+    unsigned char *s = (unsigned char *)*buf;
+    size_t n = *len;
+    int bom = has_bom(s, n);
+    size_t start = bom ? 0 : skip_clean(s, 0, n);
+    if (start == n) return 0;
+
+    /* Pass 1: the output length, and how far it runs ahead of the input at
+     * most; replacements can outgrow what they replace before any CR
+     * removed later makes up for it. */
+    size_t i = start + (bom ? 3 : 0), o = start, ahead = 0;
+    for (;;) {
+        size_t j = skip_clean(s, i, n);
+        o += j - i; i = j;
+        if (i == n) break;
+        size_t out_n, in_n = change_at(s, i, n, &out_n);
+        i += in_n; o += out_n;
+        if (o > i && o - i > ahead) ahead = o - i;
+    }
+
+    /* Pass 2, in place: with the unread input moved up by ahead bytes, the
+     * write position never passes the read position */
+    if (ahead) {
+        if (*cap < n + ahead) {
+            unsigned char *ns = (unsigned char *)realloc(s, n + ahead);
+            if (!ns) return -1;
+            s = ns; *buf = (char *)ns; *cap = n + ahead;
+        }
+        memmove(s + start + ahead, s + start, n - start);
+    }
+    size_t r = start + ahead + (bom ? 3 : 0), end = n + ahead, w = start;
+    for (;;) {
+        size_t j = skip_clean(s, r, end);
+        if (w != r) memmove(s + w, s + r, j - r);
+        w += j - r; r = j;
+        if (r == end) break;
+        size_t out_n;
+        r += change_at(s, r, end, &out_n);
+        if (out_n == 1) s[w] = '\n';
+        else memcpy(s + w, REPLACEMENT, 3);
+        w += out_n;
+    }
+    *len = w;
+    return 0;
+}
+
+size_t mdvic_utf8_decode(const char *s, uint32_t *cp) {
+    const unsigned char *p = (const unsigned char *)s;
+    if (p[0] < 0x80) { *cp = p[0]; return 1; }
+    if (p[0] < 0xE0) { *cp = ((uint32_t)(p[0] & 0x1F) << 6) | (uint32_t)(p[1] & 0x3F); return 2; }
+    if (p[0] < 0xF0) { *cp = ((uint32_t)(p[0] & 0x0F) << 12) | ((uint32_t)(p[1] & 0x3F) << 6) | (uint32_t)(p[2] & 0x3F); return 3; }
+    *cp = ((uint32_t)(p[0] & 0x07) << 18) | ((uint32_t)(p[1] & 0x3F) << 12) | ((uint32_t)(p[2] & 0x3F) << 6) | (uint32_t)(p[3] & 0x3F);
+    return 4;
+}
+
+void mdvic_json_string(FILE *out, const char *s) {
+    const unsigned char *p = (const unsigned char *)s;
+    size_t n = strlen(s);
+    int bad;
+    fputc('"', out);
+    while (n > 0) {
+        unsigned char c = *p;
+        size_t k = 1;
+        if (c == '"' || c == '\\') { fputc('\\', out); fputc(c, out); }
+        else if (c == '\n') fputs("\\n", out);
+        else if (c == '\t') fputs("\\t", out);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else if (c < 0x80) fputc(c, out);
+        else if ((k = (size_t)seq_len(p, n, &bad)) != 0) fwrite(p, 1, k, out);
+        else { fputs(REPLACEMENT, out); k = (size_t)bad; }
+        p += k; n -= k;
+    }
+    fputc('"', out);
+}
+
+static size_t put_utf8(unsigned char *d, uint32_t cp) {
+    if (cp < 0x80) { d[0] = (unsigned char)cp; return 1; }
+    if (cp < 0x800) { d[0] = (unsigned char)(0xC0 | cp >> 6); d[1] = (unsigned char)(0x80 | (cp & 0x3F)); return 2; }
+    if (cp < 0x10000) {
+        d[0] = (unsigned char)(0xE0 | cp >> 12); d[1] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+        d[2] = (unsigned char)(0x80 | (cp & 0x3F)); return 3;
+    }
+    d[0] = (unsigned char)(0xF0 | cp >> 18); d[1] = (unsigned char)(0x80 | ((cp >> 12) & 0x3F));
+    d[2] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F)); d[3] = (unsigned char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/* ASCII blocks are stored as they are; any other block byte by byte. */
+static size_t latin1_to_utf8(const unsigned char *s, size_t n, unsigned char *d) {
+    size_t i = 0, o = 0;
+#ifdef UTF8_SSE2
+    for (; n - i >= 16; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(s + i));
+        if (!_mm_movemask_epi8(v)) { _mm_storeu_si128((__m128i *)(void *)(d + o), v); o += 16; continue; }
+        for (size_t k = 0; k < 16; k++) o += put_utf8(d + o, s[i + k]);
+    }
+#endif
+    for (; i < n; i++) o += put_utf8(d + o, s[i]);
+    return o;
+}
+
+static uint32_t unit16(const unsigned char *p, int be) {
+    return be ? (uint32_t)p[0] << 8 | p[1] : (uint32_t)p[1] << 8 | p[0];
+}
+
+/* Blocks of eight ASCII code units are narrowed with one saturating pack;
+ * the rest go through the scalar loop, a block at a time. */
+static size_t utf16_to_utf8(const unsigned char *s, size_t n, int be, int last, unsigned char *d, size_t *used) {
+    size_t i = 0, o = 0;
+#ifdef UTF8_SSE2
+    const __m128i not_ascii = _mm_set1_epi16((short)0xFF80), zero = _mm_setzero_si128();
+#endif
+    while (n - i >= 2) {
+        size_t stop = n;
+#ifdef UTF8_SSE2
+        for (; n - i >= 16; i += 16, o += 8) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(s + i));
+            if (be) v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, not_ascii), zero)) != 0xFFFF) break;
+            _mm_storel_epi64((__m128i *)(void *)(d + o), _mm_packus_epi16(v, v));
+        }
+        if (n - i < 2) break;
+        if (n - i > 16) stop = i + 16;
+#endif
+        while (i + 2 <= stop) {
+            uint32_t u = unit16(s + i, be), u2;
+            if (u >= 0xD800 && u <= 0xDBFF) {
+                if (n - i < 4) {
+                    if (!last) goto done; /* the low half is in the next chunk */
+                    u = 0xFFFD; i = n - 2; /* one U+FFFD with any odd byte after it */
+                } else if ((u2 = unit16(s + i + 2, be)) >= 0xDC00 && u2 <= 0xDFFF) {
+                    u = 0x10000 + ((u - 0xD800) << 10) + (u2 - 0xDC00); i += 2;
+                } else {
+                    u = 0xFFFD;
+                }
+            } else if (u >= 0xDC00 && u <= 0xDFFF) {
+                u = 0xFFFD;
+            }
+            i += 2;
+            o += put_utf8(d + o, u);
+        }
+    }
+done:
+    if (last && i < n) { memcpy(d + o, REPLACEMENT, 3); o += 3; i = n; } /* odd byte */
+    *used = i;
+    return o;
+}
+
+size_t mdvic_transcode(enum mdvic_input_encoding enc, const char *in, size_t n, int last, char *out, size_t *used) {
+    const unsigned char *s = (const unsigned char *)in;
+    unsigned char *d = (unsigned char *)out;
+    switch (enc) {
+    case MDVIC_INPUT_LATIN1: *used = n; return latin1_to_utf8(s, n, d);
+    case MDVIC_INPUT_UTF16:
+    case MDVIC_INPUT_UTF16LE: return utf16_to_utf8(s, n, 0, last, d, used);
+    case MDVIC_INPUT_UTF16BE: return utf16_to_utf8(s, n, 1, last, d, used);
+    default: memcpy(d, s, n); *used = n; return n;
+    }
+}
+
+int mdvic_parse_input_encoding(const char *name, enum mdvic_input_encoding *enc) {
+    static const struct { const char *name; enum mdvic_input_encoding enc; } names[] = {
+        { "auto", MDVIC_INPUT_AUTO }, { "utf-8", MDVIC_INPUT_UTF8 }, { "utf8", MDVIC_INPUT_UTF8 },
+        { "utf-16", MDVIC_INPUT_UTF16 }, { "utf16", MDVIC_INPUT_UTF16 },
+        { "utf-16le", MDVIC_INPUT_UTF16LE }, { "utf16le", MDVIC_INPUT_UTF16LE },
+        { "utf-16be", MDVIC_INPUT_UTF16BE }, { "utf16be", MDVIC_INPUT_UTF16BE },
+        { "latin-1", MDVIC_INPUT_LATIN1 }, { "latin1", MDVIC_INPUT_LATIN1 }, { "iso-8859-1", MDVIC_INPUT_LATIN1 },
+    };
+    if (!name || !enc) return -1;
+    for (size_t k = 0; k < sizeof(names) / sizeof(names[0]); k++) {
+        if (strcasecmp(name, names[k].name) == 0) { *enc = names[k].enc; return 0; }
+    }
+    return -1;
+}
+
+/* Make room for extra more bytes after len. */
+static int reserve(char **buf, size_t *cap, size_t len, size_t extra) {
+    if (*cap - len >= extra) return 0;
+    size_t ncap = *cap;
+    while (ncap - len < extra) ncap *= 2;
+    char *nb = (char *)realloc(*buf, ncap);
+    if (!nb) return -1;
+    *buf = nb; *cap = ncap;
+    return 0;
+}
+
+int mdvic_read_input(FILE *in, enum mdvic_input_encoding enc, char **data, size_t *len, size_t *raw_len) {
+    unsigned char head[2];
+    size_t nh = fread(head, 1, 2, in), skip = 0, raw = nh;
+    if (nh < 2 && ferror(in)) return -1;
+    int le_bom = nh == 2 && head[0] == 0xFF && head[1] == 0xFE, be_bom = nh == 2 && head[0] == 0xFE && head[1] == 0xFF;
+    if (enc == MDVIC_INPUT_AUTO || enc == MDVIC_INPUT_UTF16) {
+        if (le_bom) enc = MDVIC_INPUT_UTF16LE;
+        else if (be_bom) enc = MDVIC_INPUT_UTF16BE;
+        else enc = enc == MDVIC_INPUT_AUTO ? MDVIC_INPUT_UTF8 : MDVIC_INPUT_UTF16LE;
+    }
+    if ((enc == MDVIC_INPUT_UTF16LE && le_bom) || (enc == MDVIC_INPUT_UTF16BE && be_bom)) skip = 2;
+
+    size_t cap = 8192, n = 0;
+    char *buf = (char *)malloc(cap);
+    if (!buf) return -1;
+    if (enc == MDVIC_INPUT_UTF8) {
+        memcpy(buf, head, nh); n = nh;
+        for (;;) {
+            if (reserve(&buf, &cap, n, 4096) != 0) goto fail;
+            size_t got = fread(buf + n, 1, cap - n, in); n += got;
+            if (got == 0) { if (ferror(in)) goto fail; break; }
+        }
+        raw = n;
+    } else {
+        /* raw bytes pass through one chunk; what a chunk ends in the middle
+         * of (an odd byte, a surrogate pair) is carried to the next */
+        unsigned char *chunk = (unsigned char *)malloc(INPUT_CHUNK);
+        if (!chunk) goto fail;
+        size_t keep = nh - skip;
+        memcpy(chunk, head + skip, keep);
+        for (;;) {
+            size_t got = fread(chunk + keep, 1, INPUT_CHUNK - keep, in);
+            raw += got;
+            int last = got < INPUT_CHUNK - keep;
+            if (last && ferror(in)) { free(chunk); goto fail; }
+            size_t avail = keep + got, used;
+            if (reserve(&buf, &cap, n, MDVIC_TRANSCODE_BOUND(avail)) != 0) { free(chunk); goto fail; }
+            n += mdvic_transcode(enc, (const char *)chunk, avail, last, buf + n, &used);
+            keep = avail - used;
+            memmove(chunk, chunk + used, keep);
+            if (last) break;
+        }
+        free(chunk);
+    }
+    if (mdvic_utf8_normalize(&buf, &n, &cap) != 0) goto fail;
+    *data = buf; *len = n;
+    if (raw_len) *raw_len = raw;
+    return 0;
+fail:
+    free(buf);
+    return -1;
+}
@@ -9,7 +9,18 @@
 
 static int is_csi_final(unsigned char c) { return (c >= 0x40 && c <= 0x7E); }
 
-static size_t skip_ansi(const char *s, size_t i, size_t len, FILE *out) {
+/* Output goes through a sink; FILE streams use file_sink. */
+struct Sink { mdvic_wrap_sink_fn fn; void *ctx; };
+
+static int put(const struct Sink *out, const char *s, size_t n) {
+    return out->fn(out->ctx, s, n);
+}
+
+static int file_sink(void *ctx, const char *s, size_t n) {
+    return fwrite(s, 1, n, (FILE *)ctx) == n ? 0 : -1;
+}
+
+static size_t skip_ansi(const char *s, size_t i, size_t len, const struct Sink *out) {
     unsigned char esc = (unsigned char)s[i];
     if (esc != 0x1B) return i;
     if (i + 1 >= len) return i; /* not enough bytes */
@@ -21,7 +32,7 @@ static size_t skip_ansi(const char *s, size_t i, size_t len, FILE *out) {
             unsigned char c = (unsigned char)s[j++];
             if (is_csi_final(c)) break;
         }
-        fwrite(s + i, 1, j - i, out);
+        put(out, s + i, j - i);
         return j;
     } else if (next == ']') {
         /* OSC: ESC ] ... BEL or ST */
@@ -31,12 +42,12 @@ static size_t skip_ansi(const char *s, size_t i, size_t len, FILE *out) {
             if (c == 0x07) { j++; break; }
             if (c == 0x1B && j + 1 < len && (unsigned char)s[j+1] == '\\') { j += 2; break; }
         }
-        fwrite(s + i, 1, j - i, out);
+        put(out, s + i, j - i);
         return j;
     } else {
         /* Other escape: copy ESC and next byte if any */
         size_t j = i + ((i + 2 <= len) ? 2 : 1);
-        fwrite(s + i, 1, j - i, out);
+        put(out, s + i, j - i);
         return j;
     }
 }
@@ -66,33 +77,43 @@ static int utf8_decode(const char *s, size_t len, size_t *consumed, uint32_t *ou
     return -1;
 }
 
-static int write_prefix(FILE *out, const char *prefix, int prefix_len) {
+static int write_prefix(const struct Sink *out, const char *prefix, size_t prefix_len) {
     if (prefix && prefix_len > 0) {
-        if (fwrite(prefix, 1, (size_t)prefix_len, out) != (size_t)prefix_len) return -1;
+        if (put(out, prefix, prefix_len) != 0) return -1;
     }
     return 0;
 }
 
-int mdvic_wrap_write_pref2(FILE *out, const char *s, size_t len, int width, int *col,
-                           const char *prefix_first, int prefix_first_len,
-                           const char *prefix_next, int prefix_next_len) {
+/* Break the line and start the next one with the continuation prefix. */
+static int wrap_line(const struct Sink *out, int *ccol, const struct MdvicWrapPrefix *pfx) {
+    if (put(out, "\n", 1) != 0) return -1;
+    *ccol = 0;
+    if (pfx) {
+        if (write_prefix(out, pfx->next, pfx->next_len) != 0) return -1;
+        *ccol += pfx->next_width;
+    }
+    return 0;
+}
+
+int mdvic_wrap_emit(mdvic_wrap_sink_fn sink, void *ctx, const char *s, size_t len, int width, int *col,
+                    const struct MdvicWrapPrefix *pfx) {
+    struct Sink sk = { sink, ctx };
+    const struct Sink *out = &sk;
     int ccol = col ? *col : 0;
     size_t i = 0;
-    if (ccol == 0) { if (write_prefix(out, prefix_first, prefix_first_len) != 0) return -1; ccol += (prefix_first ? prefix_first_len : 0); }
+    if (ccol == 0 && pfx) { if (write_prefix(out, pfx->first, pfx->first_len) != 0) return -1; ccol += pfx->first_width; }
     while (i < len) {
         unsigned char ch = (unsigned char)s[i];
         if (ch == '\n') {
-            if (fputc('\n', out) == EOF) return -1;
-            ccol = 0; i++;
-            if (write_prefix(out, prefix_next, prefix_next_len) != 0) return -1;
-            ccol += (prefix_next ? prefix_next_len : 0);
+            if (wrap_line(out, &ccol, pfx) != 0) return -1;
+            i++;
             continue;
         }
         if (ch == 0x1B) {
             size_t j = skip_ansi(s, i, len, out);
             if (j == i) {
                 /* unknown escape, copy as-is */
-                if (fputc(ch, out) == EOF) return -1;
+                if (put(out, s + i, 1) != 0) return -1;
                 i++;
             } else {
                 i = j;
@@ -100,10 +121,25 @@ int mdvic_wrap_write_pref2(FILE *out, const char *s, size_t len, int width, int
             continue;
         }
         if (width > 0 && ccol >= width) {
-            if (fputc('\n', out) == EOF) return -1;
-            ccol = 0;
-            if (write_prefix(out, prefix_next, prefix_next_len) != 0) return -1;
-            ccol += (prefix_next ? prefix_next_len : 0);
+            if (wrap_line(out, &ccol, pfx) != 0) return -1;
+        }
+        if (ch >= 0x20 && ch < 0x7F) {
+            /* printable ASCII is one column a byte: copy what fits at once */
+            if (width > 0 && ccol + 1 > width) {
+                if (wrap_line(out, &ccol, pfx) != 0) return -1;
+            }
+            /* a prefix as wide as the line still gets one byte per line;
+             * the scan stops there too, so a long run is not rescanned
+             * for every line it wraps onto */
+            size_t end = len;
+            if (width > 0) { size_t room = ccol < width ? (size_t)(width - ccol) : 1; if (room < len - i) end = i + room; }
+            size_t j = i + 1;
+            while (j < end && (unsigned char)s[j] >= 0x20 && (unsigned char)s[j] < 0x7F) j++;
+            size_t n = j - i;
+            if (put(out, s + i, n) != 0) return -1;
+            ccol += (int)n;
+            i += n;
+            continue;
         }
         /* Decode utf-8 for width; if invalid, treat as single byte */
         size_t consumed = 1; uint32_t cp = 0; int w = 1;
@@ -111,11 +147,9 @@ int mdvic_wrap_write_pref2(FILE *out, const char *s, size_t len, int width, int
             w = mdvic_wcwidth(cp);
         }
         if (width > 0 && ccol + w > width && w <= width) {
-            if (fputc('\n', out) == EOF) return -1; ccol = 0;
-            if (write_prefix(out, prefix_next, prefix_next_len) != 0) return -1;
-            ccol += (prefix_next ? prefix_next_len : 0);
+            if (wrap_line(out, &ccol, pfx) != 0) return -1;
         }
-        if (fwrite(s + i, 1, consumed, out) != consumed) return -1;
+        if (put(out, s + i, consumed) != 0) return -1;
         ccol += w;
         i += consumed;
     }
@@ -123,6 +157,20 @@ int mdvic_wrap_write_pref2(FILE *out, const char *s, size_t len, int width, int
     return 0;
 }
 
+int mdvic_wrap_write_prefix(FILE *out, const char *s, size_t len, int width, int *col,
+                            const struct MdvicWrapPrefix *pfx) {
+    return mdvic_wrap_emit(file_sink, out, s, len, width, col, pfx);
+}
+
+int mdvic_wrap_write_pref2(FILE *out, const char *s, size_t len, int width, int *col,
+                           const char *prefix_first, int prefix_first_len,
+                           const char *prefix_next, int prefix_next_len) {
+    struct MdvicWrapPrefix pfx;
+    pfx.first = prefix_first; pfx.first_len = prefix_first ? (size_t)prefix_first_len : 0; pfx.first_width = (int)pfx.first_len;
+    pfx.next = prefix_next; pfx.next_len = prefix_next ? (size_t)prefix_next_len : 0; pfx.next_width = (int)pfx.next_len;
+    return mdvic_wrap_write_prefix(out, s, len, width, col, &pfx);
+}
+
 int mdvic_wrap_write_pref(FILE *out, const char *s, size_t len, int width, int *col,
                           const char *prefix, int prefix_len) {
     return mdvic_wrap_write_pref2(out, s, len, width, col, prefix, prefix_len, prefix, prefix_len);
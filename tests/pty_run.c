@@ -0,0 +1,133 @@
+/* Run a command on a pseudo-terminal, type keys into it, dump what it drew.
+ *
+ * Usage: pty_run ROWS COLS KEYSFILE CMD [ARG...]
+ *
+ * KEYSFILE holds one key per line; "#" starts a comment and \e \r \n \t \\
+ * and \xHH are understood. A line "!resize ROWS COLS" resizes the terminal
+ * instead (write a literal "!" as \x21). Each key is sent once the program
+ * has been quiet for a moment, so the output does not depend on timing.
+ */
+#define _XOPEN_SOURCE 600
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+
+#define QUIET_MS 100
+#define EXIT_TIMEOUT_MS 5000
+
+static int master = -1;
+
+/* Copy output to stdout until nothing arrives for quiet_ms; 0 on hangup. */
+static int drain(int quiet_ms) {
+    char buf[4096];
+    for (;;) {
+        struct pollfd pfd; pfd.fd = master; pfd.events = POLLIN; pfd.revents = 0;
+        int r = poll(&pfd, 1, quiet_ms);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return 1;
+        ssize_t n = read(master, buf, sizeof(buf));
+        if (n <= 0) return 0;
+        fwrite(buf, 1, (size_t)n, stdout);
+    }
+}
+
+static int hexval(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static size_t unescape(const char *s, char *out) {
+    size_t n = 0;
+    while (*s && *s != '\n') {
+        if (*s != '\\' || !s[1]) { out[n++] = *s++; continue; }
+        s++;
+        switch (*s) {
+        case 'e': out[n++] = 0x1b; s++; break;
+        case 'r': out[n++] = '\r'; s++; break;
+        case 'n': out[n++] = '\n'; s++; break;
+        case 't': out[n++] = '\t'; s++; break;
+        case 'x':
+            if (hexval(s[1]) >= 0 && hexval(s[2]) >= 0) { out[n++] = (char)(hexval(s[1]) * 16 + hexval(s[2])); s += 3; }
+            else out[n++] = *s++;
+            break;
+        default: out[n++] = *s++; break;
+        }
+    }
+    return n;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 5) {
+        fprintf(stderr, "usage: %s ROWS COLS KEYSFILE CMD [ARG...]\n", argv[0]);
+        return 2;
+    }
+    struct winsize ws;
+    memset(&ws, 0, sizeof(ws));
+    ws.ws_row = (unsigned short)atoi(argv[1]);
+    ws.ws_col = (unsigned short)atoi(argv[2]);
+    FILE *keys = fopen(argv[3], "r");
+    if (!keys) { fprintf(stderr, "pty_run: cannot open %s\n", argv[3]); return 2; }
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) { perror("pty_run: posix_openpt"); return 2; }
+    const char *name = ptsname(master);
+    if (!name) { perror("pty_run: ptsname"); return 2; }
+
+    pid_t pid = fork();
+    if (pid < 0) { perror("pty_run: fork"); return 2; }
+    if (pid == 0) {
+        setsid();
+        int slave = open(name, O_RDWR);
+        if (slave < 0) _exit(127);
+#ifdef TIOCSCTTY
+        ioctl(slave, TIOCSCTTY, 0);
+#endif
+        ioctl(slave, TIOCSWINSZ, &ws);
+        /* keep the output byte for byte as the program wrote it */
+        struct termios tio;
+        if (tcgetattr(slave, &tio) == 0) { tio.c_oflag &= (tcflag_t)~OPOST; tcsetattr(slave, TCSANOW, &tio); }
+        dup2(slave, STDIN_FILENO); dup2(slave, STDOUT_FILENO); dup2(slave, STDERR_FILENO);
+        if (slave > STDERR_FILENO) close(slave);
+        execvp(argv[4], argv + 4);
+        _exit(127);
+    }
+
+    int alive = drain(QUIET_MS);
+    char line[1024], key[1024];
+    while (alive && fgets(line, sizeof(line), keys)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        unsigned rows = 0, cols = 0;
+        if (sscanf(line, "!resize %u %u", &rows, &cols) == 2) {
+            ws.ws_row = (unsigned short)rows; ws.ws_col = (unsigned short)cols;
+            ioctl(master, TIOCSWINSZ, &ws); /* the kernel sends SIGWINCH */
+            alive = drain(QUIET_MS);
+            continue;
+        }
+        size_t n = unescape(line, key);
+        if (write(master, key, n) < 0) break;
+        alive = drain(QUIET_MS);
+    }
+    fclose(keys);
+
+    int status = 0;
+    for (int waited = 0; ; waited += QUIET_MS) {
+        pid_t r = waitpid(pid, &status, WNOHANG);
+        if (r == pid) break;
+        if (waited >= EXIT_TIMEOUT_MS) { kill(pid, SIGKILL); waitpid(pid, &status, 0); break; }
+        if (alive) alive = drain(QUIET_MS); else usleep(QUIET_MS * 1000);
+    }
+    if (alive) drain(0);
+    fflush(stdout);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
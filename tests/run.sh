@@ -19,6 +19,8 @@ run_case() {
   out_golden="golden/$base.out"
   err_golden="golden/$base.err"
   envfile="cases/$base.env"
+  argsfile="cases/$base.args"
+  keysfile="cases/$base.keys"
 
   printf "[TEST] %s... " "$base"
 
@@ -31,7 +33,22 @@ run_case() {
     EXTRA_ENV=""
   fi
 
-  if ! eval $EXTRA_ENV "$MDVIC" --no-color --wrap --width "$WIDTH" "$mdfile" >"$out_actual" 2>"$err_actual"; then
+  # Options replacing the default --no-color, e.g. for color output checks;
+  # they come after --wrap so a case can also select --no-wrap
+  if [ -f "$argsfile" ]; then
+    ARGS=$(sed -e 's/#.*$//' -e '/^$/d' "$argsfile" | tr '\n' ' ')
+  else
+    ARGS="--no-color"
+  fi
+
+  # Interactive cases type their keys into a 10x40 pseudo-terminal
+  if [ -f "$keysfile" ]; then
+    RUNNER="./pty_run 10 $WIDTH $keysfile"
+  else
+    RUNNER=""
+  fi
+
+  if ! eval $EXTRA_ENV $RUNNER "$MDVIC" --wrap --width "$WIDTH" $ARGS "$mdfile" >"$out_actual" 2>"$err_actual"; then
     echo "(mdvic exited non-zero)"
   fi
 
@@ -99,7 +116,32 @@ CASES="\
 27_accents_more \
 28_spacing \
 29_iff_display \
-30_showcase"
+30_showcase \
+31_math_prepass \
+32_matrix_envs \
+33_math_limits \
+34_math_alphabets \
+35_sgr_delta \
+36_theme \
+37_prefix_stack \
+38_highlight \
+39_code_tabs \
+40_nowrap \
+41_deep_nesting \
+42_pager \
+43_reflow \
+44_grid \
+45_lint_only \
+46_lint_math_links \
+47_input_normalize \
+48_input_utf16le \
+49_input_latin1 \
+50_input_utf8_default \
+51_math_literal_regions \
+52_lint_positions \
+53_math_large_matrix \
+54_lint_json_utf8 \
+55_math_limit_root"
 
 for b in $CASES; do
   run_case "$b"
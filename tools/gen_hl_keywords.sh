@@ -0,0 +1,83 @@
+#!/bin/sh
+# Generate include/mdvic/hl_keywords.h: perfect-hash keyword tables for the
+# code block highlighter. For each language the script searches for a
+# multiplier under which the hash below sends every word to its own slot.
+#
+#   h = len; for each byte c: h = (h * mul + c) % 65521; slot = h % size
+#
+# Usage: tools/gen_hl_keywords.sh
+
+set -eu
+
+OUT="include/mdvic/hl_keywords.h"
+mkdir -p "$(dirname "$OUT")"
+
+awk '
+function ord(ch) { return index(ASCII, ch) + 31 }
+function hash(w, mul,   h, i) {
+  h = length(w)
+  for (i = 1; i <= length(w); i++) h = (h * mul + ord(substr(w, i, 1))) % 65521
+  return h
+}
+# kind: K = keyword, T = type or builtin, L = literal
+function table(name, keywords, types, literals,   n, i, w, k, words, kinds, size, mul, ok, used, minl, maxl, parts, m) {
+  n = 0
+  m = split(keywords, parts, " "); for (i = 1; i <= m; i++) { words[++n] = parts[i]; kinds[n] = "MDVIC_HL_KEYWORD" }
+  m = split(types, parts, " ");    for (i = 1; i <= m; i++) { words[++n] = parts[i]; kinds[n] = "MDVIC_HL_TYPE" }
+  m = split(literals, parts, " "); for (i = 1; i <= m; i++) { words[++n] = parts[i]; kinds[n] = "MDVIC_HL_LITERAL" }
+  size = 64; while (size < 8 * n) size *= 2
+  for (mul = 31; mul < 32768; mul++) {
+    delete used; ok = 1
+    for (i = 1; i <= n && ok; i++) { k = hash(words[i], mul) % size; if (k in used) ok = 0; else used[k] = i }
+    if (ok) break
+  }
+  if (!ok) { print "no perfect hash for " name > "/dev/stderr"; exit 1 }
+  minl = 255; maxl = 0
+  for (i = 1; i <= n; i++) { if (length(words[i]) < minl) minl = length(words[i]); if (length(words[i]) > maxl) maxl = length(words[i]) }
+  printf("static const struct MdvicHlWord mdvic_hl_%s_words[%d] = {\n", name, n)
+  for (i = 1; i <= n; i++) printf("    {\"%s\", %d, %s},\n", words[i], length(words[i]), kinds[i])
+  printf("};\n\n")
+  printf("static const unsigned char mdvic_hl_%s_slots[%d] = {", name, size)
+  for (i = 0; i < size; i++) {
+    if (i % 16 == 0) printf("\n   ")
+    printf(" %d,", (i in used) ? used[i] : 0)
+  }
+  printf("\n};\n\n")
+  printf("static const struct MdvicHlKeywords mdvic_hl_%s_keywords = {\n", name)
+  printf("    mdvic_hl_%s_words, mdvic_hl_%s_slots, %d, %du, %d, %d\n};\n\n", name, name, size, mul, minl, maxl)
+}
+BEGIN {
+  for (i = 32; i < 127; i++) ASCII = ASCII sprintf("%c", i)
+  print "/* Auto-generated by tools/gen_hl_keywords.sh. Do not edit by hand. */"
+  print "#ifndef MDVIC_HL_KEYWORDS_H"
+  print "#define MDVIC_HL_KEYWORDS_H"
+  print ""
+  print "/* slots[hash % size] is 1 + the index of the only word that can match. */"
+  print ""
+  table("c",
+        "auto break case const continue default do else enum extern for goto if inline register restrict " \
+        "return sizeof static struct switch typedef union volatile while _Alignas _Alignof _Atomic " \
+        "_Generic _Noreturn _Static_assert _Thread_local alignas alignof class constexpr delete " \
+        "namespace new noexcept operator private protected public template this throw try catch " \
+        "typename using virtual",
+        "bool char double float int long short signed unsigned void _Bool size_t ssize_t ptrdiff_t " \
+        "intptr_t uintptr_t int8_t int16_t int32_t int64_t uint8_t uint16_t uint32_t uint64_t FILE",
+        "true false NULL nullptr")
+  table("sh",
+        "if then else elif fi for while until do done case esac in function select time return " \
+        "local export readonly declare break continue exit",
+        "echo printf cd pwd set unset shift source eval exec trap test read alias command type " \
+        "wait kill getopts ulimit umask",
+        "")
+  table("python",
+        "and as assert async await break class continue def del elif else except finally for from " \
+        "global if import in is lambda nonlocal not or pass raise return try while with yield match",
+        "bool bytes dict float int list object set str tuple type print len range super self cls " \
+        "isinstance enumerate zip open",
+        "True False None")
+  table("json", "", "", "true false null")
+  table("yaml", "", "", "true false null yes no on off True False Null Yes No On Off TRUE FALSE NULL YES NO ON OFF")
+  print "#endif /* MDVIC_HL_KEYWORDS_H */"
+}' > "$OUT"
+
+echo "Generated $OUT"
@@ -0,0 +1,77 @@
+#!/bin/sh
+# Generate include/mdvic/mathalpha_table.h: ASCII -> UTF-8 lookup arrays for
+# the Mathematical Alphanumeric Symbols block and Unicode super/subscripts.
+# Usage: tools/gen_mathalpha.sh
+
+set -eu
+
+OUT="include/mdvic/mathalpha_table.h"
+mkdir -p "$(dirname "$OUT")"
+
+awk '
+function utf8(cp,   b1, b2, b3, b4) {
+  if (cp < 128) return sprintf("\\x%02X", cp)
+  if (cp < 2048) return sprintf("\\x%02X\\x%02X", 192 + int(cp / 64), 128 + cp % 64)
+  if (cp < 65536) return sprintf("\\x%02X\\x%02X\\x%02X", 224 + int(cp / 4096), 128 + int(cp / 64) % 64, 128 + cp % 64)
+  return sprintf("\\x%02X\\x%02X\\x%02X\\x%02X", 240 + int(cp / 262144), 128 + int(cp / 4096) % 64, 128 + int(cp / 64) % 64, 128 + cp % 64)
+}
+function hex(h,   i, c, v) {
+  v = 0; h = toupper(h)
+  for (i = 1; i <= length(h); i++) { c = index("0123456789ABCDEF", substr(h, i, 1)) - 1; v = v * 16 + c }
+  return v
+}
+function entry(ch, cp) {
+  if (ch == "\\" || ch == "\x27") ch = "\\" ch
+  printf("    [\x27%s\x27] = \"%s\", /* U+%04X */\n", ch, utf8(cp), cp)
+}
+# Latin letters of one style: 52 code points from base, with holes filled by
+# the Letterlike Symbols listed in "holes" ("C=2102 H=210D ...").
+function alphabet(name, base, digits, holes,   n, i, parts, kv, fix, ch, cp) {
+  delete fix
+  n = split(holes, parts, " ")
+  for (i = 1; i <= n; i++) { split(parts[i], kv, "="); fix[kv[1]] = hex(kv[2]) }
+  printf("static const char *const mdvic_math_%s[128] = {\n", name)
+  if (digits) for (i = 0; i < 10; i++) entry(sprintf("%d", i), hex(digits) + i)
+  for (i = 0; i < 52; i++) {
+    ch = substr(LETTERS, i + 1, 1)
+    cp = (ch in fix) ? fix[ch] : hex(base) + i
+    entry(ch, cp)
+  }
+  printf("};\n\n")
+}
+# Scripts: "ch=hex" pairs for every ASCII character Unicode provides.
+function script(name, pairs,   n, i, parts) {
+  printf("static const char *const mdvic_math_%s[128] = {\n", name)
+  n = split(pairs, parts, " ")
+  for (i = 1; i <= n; i++) entry(substr(parts[i], 1, 1), hex(substr(parts[i], 3)))
+  printf("};\n\n")
+}
+BEGIN {
+  LETTERS = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+  print "/* Auto-generated by tools/gen_mathalpha.sh. Do not edit by hand. */"
+  print "#ifndef MDVIC_MATHALPHA_TABLE_H"
+  print "#define MDVIC_MATHALPHA_TABLE_H"
+  print ""
+  print "/* Indexed by ASCII code; NULL where Unicode has no counterpart. */"
+  print ""
+  alphabet("bf",   "1D400", "1D7CE", "")
+  alphabet("it",   "1D434", "",      "h=210E")
+  alphabet("cal",  "1D49C", "",      "B=212C E=2130 F=2131 H=210B I=2110 L=2112 M=2133 R=211B e=212F g=210A o=2134")
+  alphabet("frak", "1D504", "",      "C=212D H=210C I=2111 R=211C Z=2128")
+  alphabet("bb",   "1D538", "1D7D8", "C=2102 H=210D N=2115 P=2119 Q=211A R=211D Z=2124")
+  alphabet("sf",   "1D5A0", "1D7E2", "")
+  alphabet("tt",   "1D670", "1D7F6", "")
+  script("sup", "0=2070 1=00B9 2=00B2 3=00B3 4=2074 5=2075 6=2076 7=2077 8=2078 9=2079 " \
+                "+=207A -=207B ==207C (=207D )=207E " \
+                "A=1D2C B=1D2E D=1D30 E=1D31 G=1D33 H=1D34 I=1D35 J=1D36 K=1D37 L=1D38 M=1D39 N=1D3A " \
+                "O=1D3C P=1D3E R=1D3F T=1D40 U=1D41 V=2C7D W=1D42 " \
+                "a=1D43 b=1D47 c=1D9C d=1D48 e=1D49 f=1DA0 g=1D4D h=02B0 i=2071 j=02B2 k=1D4F l=02E1 m=1D50 " \
+                "n=207F o=1D52 p=1D56 r=02B3 s=02E2 t=1D57 u=1D58 v=1D5B w=02B7 x=02E3 y=02B8 z=1DBB")
+  script("sub", "0=2080 1=2081 2=2082 3=2083 4=2084 5=2085 6=2086 7=2087 8=2088 9=2089 " \
+                "+=208A -=208B ==208C (=208D )=208E " \
+                "a=2090 e=2091 h=2095 i=1D62 j=2C7C k=2096 l=2097 m=2098 n=2099 o=2092 p=209A " \
+                "r=1D63 s=209B t=209C u=1D64 v=1D65 x=2093")
+  print "#endif /* MDVIC_MATHALPHA_TABLE_H */"
+}' > "$OUT"
+
+echo "Generated $OUT"